@@ -7,6 +7,7 @@ type Config struct {
 	DBPath             string
 	GoogleClientID     string
 	GoogleClientSecret string
+	ServerSecret       string // shared with game servers; required on /server/* requests
 }
 
 func LoadConfig() Config {
@@ -28,5 +29,6 @@ func LoadConfig() Config {
 		DBPath:             dbPath,
 		GoogleClientID:     os.Getenv("GOOGLE_CLIENT_ID"),
 		GoogleClientSecret: os.Getenv("GOOGLE_CLIENT_SECRET"),
+		ServerSecret:       os.Getenv("SERVER_SECRET"),
 	}
 }
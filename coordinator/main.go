@@ -519,7 +519,8 @@ func main() {
 	lobbyService := NewLobbyService(db)
 	usernameService := NewUsernameService(db)
 	partyService := NewPartyService(db)
-	queueService := NewQueueService(db, lobbyService)
+	serverPool := NewServerPool(config.ServerSecret)
+	queueService := NewQueueService(db, lobbyService, serverPool)
 	defer queueService.Stop()
 
 	// Create coordinator instance (for legacy matchmaking endpoints)
@@ -565,6 +566,10 @@ func main() {
 	http.HandleFunc("/queue/accept-match", authService.authMiddleware(queueService.handleAcceptMatch))
 	http.HandleFunc("/queue/decline-match", authService.authMiddleware(queueService.handleDeclineMatch))
 
+	// Game server endpoints (called by sumo_balls_server, not by players; need SERVER_SECRET)
+	http.HandleFunc("/server/heartbeat", serverPool.handleHeartbeat)
+	http.HandleFunc("/server/list", serverPool.handleListServers)
+
 	// Lobby endpoints (require authentication)
 	http.HandleFunc("/lobby/create", authService.authMiddleware(lobbyService.handleCreateLobby))
 	http.HandleFunc("/lobby/join", authService.authMiddleware(lobbyService.handleJoinLobby))
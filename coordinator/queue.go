@@ -12,18 +12,29 @@ import (
 type QueueService struct {
 	db             *Database
 	lobbyService   *LobbyService
+	servers        *ServerPool
 	mu             sync.Mutex
 	activeQueues   map[string]*Queue // In-memory cache
 	queueCounter   int64
 	matchCounter   int64
-	matchingTicker *time.Ticker // Periodically run matchmaking
+	matchingTicker *time.Ticker           // Periodically run matchmaking
+	matchServers   map[string]matchServer // lobbyID -> game server hosting the match
 }
 
-func NewQueueService(db *Database, lobbyService *LobbyService) *QueueService {
+// Players learn their server when they accept, so an assignment is only kept
+// until the match's invitations expire
+type matchServer struct {
+	ServerAssignment
+	expiresAt time.Time
+}
+
+func NewQueueService(db *Database, lobbyService *LobbyService, servers *ServerPool) *QueueService {
 	qs := &QueueService{
 		db:           db,
 		lobbyService: lobbyService,
+		servers:      servers,
 		activeQueues: make(map[string]*Queue),
+		matchServers: make(map[string]matchServer),
 	}
 
 	// Start background matchmaking ticker (every 2 seconds)
@@ -228,8 +239,17 @@ func (q *QueueService) handleAcceptMatch(w http.ResponseWriter, r *http.Request)
 	// Check if all players in match have accepted
 	q.checkMatchReady(invitation.QueueID, invitation.LobbyID)
 
+	q.mu.Lock()
+	match, hasServer := q.matchServers[invitation.LobbyID]
+	q.mu.Unlock()
+
+	resp := MatchInvitationResponse{Success: true, Message: "Match accepted"}
+	if hasServer {
+		resp.Server = &match.ServerAssignment
+	}
+
 	log.Printf("[Queue] User %s accepted match invitation %s", user.Username, req.InvitationID)
-	respondJSON(w, MatchInvitationResponse{Success: true, Message: "Match accepted"}, http.StatusOK)
+	respondJSON(w, resp, http.StatusOK)
 }
 
 // Decline match invitation
@@ -290,6 +310,8 @@ func (q *QueueService) backgroundMatchmaking() {
 
 // Run matchmaking algorithm
 func (q *QueueService) runMatchmaking() {
+	q.pruneMatchServers(time.Now())
+
 	// Get all queued players/parties
 	queues, err := q.db.GetQueuesByState("queued")
 	if err != nil || len(queues) == 0 {
@@ -354,8 +376,15 @@ func (q *QueueService) runMatchmaking() {
 	}
 }
 
-// Create match and lobby
+// Create match and lobby on the least-loaded game server
 func (q *QueueService) createMatch(group []Queue) {
+	server := q.servers.PickLeastLoaded(len(group))
+	if server == nil {
+		// Leave everyone queued; the next matchmaking pass tries again
+		log.Printf("[Queue] No game server with %d free slots, match deferred", len(group))
+		return
+	}
+
 	q.mu.Lock()
 	q.matchCounter++
 	lobbyID := fmt.Sprintf("lobby_match_%d_%d", time.Now().Unix(), q.matchCounter)
@@ -364,13 +393,20 @@ func (q *QueueService) createMatch(group []Queue) {
 	// Create lobby in game server
 	if err := q.db.CreateLobby(lobbyID, group[0].UserID); err != nil {
 		log.Printf("[Queue] Create lobby error: %v", err)
+		// Nobody is coming: free the slots for the next pass instead of holding them until they expire
+		q.servers.Release(server.ServerID, len(group))
 		return
 	}
 
-	log.Printf("[Queue] Match created: %s with %d players", lobbyID, len(group))
-
 	// Send match invitations to all players
 	expiresAt := time.Now().Add(30 * time.Second)
+
+	q.mu.Lock()
+	q.matchServers[lobbyID] = matchServer{ServerAssignment: *server, expiresAt: expiresAt}
+	q.mu.Unlock()
+
+	log.Printf("[Queue] Match created: %s with %d players on %s", lobbyID, len(group), server.ServerID)
+
 	for _, queue := range group {
 		inviteID := fmt.Sprintf("invite_%d_%d_%d", time.Now().Unix(), queue.UserID, q.matchCounter)
 
@@ -412,6 +448,18 @@ func (q *QueueService) checkMatchReady(queueID, lobbyID string) {
 	}
 }
 
+// pruneMatchServers forgets assignments nobody can accept anymore
+func (q *QueueService) pruneMatchServers(now time.Time) {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	for lobbyID, match := range q.matchServers {
+		if now.After(match.expiresAt) {
+			delete(q.matchServers, lobbyID)
+		}
+	}
+}
+
 // Stop the matchmaking service
 func (q *QueueService) Stop() {
 	if q.matchingTicker != nil {
@@ -0,0 +1,284 @@
+package main
+
+import (
+	"crypto/subtle"
+	"encoding/json"
+	"log"
+	"net/http"
+	"sort"
+	"sync"
+	"time"
+)
+
+// Game servers report their capacity every few seconds; a server that has not
+// been heard from within serverTimeout is no longer offered for new matches.
+const (
+	serverTimeout      = 30 * time.Second
+	serverForgetAfter  = 5 * time.Minute
+	reservationTTL     = 30 * time.Second // same as a match invitation
+	overloadedTickLoad = 0.9
+)
+
+// ServerHeartbeatRequest is POSTed by sumo_balls_server to /server/heartbeat
+type ServerHeartbeatRequest struct {
+	ServerID   string  `json:"server_id"`
+	Host       string  `json:"host"`
+	Port       int     `json:"port"`
+	MaxPlayers int     `json:"max_players"`
+	FreeSlots  int     `json:"free_slots"`
+	Humans     int     `json:"humans"`
+	Bots       int     `json:"bots"`
+	Peers      int     `json:"peers"`
+	TickLoad   float64 `json:"tick_load"`
+}
+
+// ServerAssignment tells matched players where to connect
+type ServerAssignment struct {
+	ServerID string `json:"server_id"`
+	Host     string `json:"host"`
+	Port     int    `json:"port"`
+}
+
+// ServerStatus is the coordinator's view of one game server
+type ServerStatus struct {
+	ServerHeartbeatRequest
+	LastHeartbeat time.Time `json:"last_heartbeat"`
+	IdleSince     time.Time `json:"idle_since,omitempty"` // zero while anyone is connected
+	Reserved      int       `json:"reserved"`             // players sent here but not yet connected
+
+	reservations []reservation
+}
+
+type reservation struct {
+	players   int
+	expiresAt time.Time
+}
+
+// ServerPool tracks live game servers from their heartbeats. Servers prove
+// they are ours with the shared secret (sumo_balls_server --coordinator-secret)
+// as a bearer token; with no secret configured every server request is refused.
+type ServerPool struct {
+	mu      sync.Mutex
+	servers map[string]*ServerStatus
+	secret  string
+	now     func() time.Time // overridable in tests
+}
+
+func NewServerPool(secret string) *ServerPool {
+	if secret == "" {
+		log.Printf("[Servers] SERVER_SECRET not set: game server heartbeats will be rejected")
+	}
+	return &ServerPool{
+		servers: make(map[string]*ServerStatus),
+		secret:  secret,
+		now:     time.Now,
+	}
+}
+
+// Heartbeat records a capacity report, registering the server on first contact
+func (p *ServerPool) Heartbeat(req ServerHeartbeatRequest) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	now := p.now()
+	server, exists := p.servers[req.ServerID]
+	if !exists {
+		server = &ServerStatus{}
+		p.servers[req.ServerID] = server
+		log.Printf("[Servers] %s registered (%s:%d, max %d players)", req.ServerID, req.Host, req.Port, req.MaxPlayers)
+	}
+	// Slots taken since the last report are the reserved players arriving: the
+	// heartbeat counts them now, so their reservations stop counting them again
+	if arrived := (req.MaxPlayers - req.FreeSlots) - (server.MaxPlayers - server.FreeSlots); exists && arrived > 0 {
+		p.settleReservations(server, arrived)
+	}
+	server.ServerHeartbeatRequest = req
+	server.LastHeartbeat = now
+	if req.Peers > 0 {
+		server.IdleSince = time.Time{}
+	} else if server.IdleSince.IsZero() {
+		server.IdleSince = now
+	}
+	p.expireReservations(server, now)
+}
+
+// PickLeastLoaded chooses the live server with room for the given number of
+// players and the lowest load, and reserves the slots until the players
+// connect (or reservationTTL passes). Returns nil if no server can take them.
+func (p *ServerPool) PickLeastLoaded(players int) *ServerAssignment {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	now := p.now()
+	var best *ServerStatus
+	bestLoad := 0.0
+	for id, server := range p.servers {
+		age := now.Sub(server.LastHeartbeat)
+		if age > serverForgetAfter {
+			delete(p.servers, id)
+			continue
+		}
+		if age > serverTimeout || server.TickLoad >= overloadedTickLoad {
+			continue
+		}
+		p.expireReservations(server, now)
+		if server.FreeSlots-server.Reserved < players {
+			continue
+		}
+		load := serverLoad(server)
+		if best == nil || load < bestLoad || (load == bestLoad && server.ServerID < best.ServerID) {
+			best = server
+			bestLoad = load
+		}
+	}
+	if best == nil {
+		return nil
+	}
+
+	best.reservations = append(best.reservations, reservation{players: players, expiresAt: now.Add(reservationTTL)})
+	best.Reserved += players
+	return &ServerAssignment{ServerID: best.ServerID, Host: best.Host, Port: best.Port}
+}
+
+// Release gives back a reservation made by PickLeastLoaded whose match never
+// got created, so the slots are not held until reservationTTL
+func (p *ServerPool) Release(serverID string, players int) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	server, exists := p.servers[serverID]
+	if !exists {
+		return
+	}
+	for i := len(server.reservations) - 1; i >= 0; i-- {
+		if server.reservations[i].players == players {
+			server.reservations = append(server.reservations[:i], server.reservations[i+1:]...)
+			server.Reserved -= players
+			return
+		}
+	}
+}
+
+// IdleServers lists live servers nobody has been connected to for at least d,
+// candidates for scaling down
+func (p *ServerPool) IdleServers(d time.Duration) []string {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	now := p.now()
+	idle := make([]string, 0)
+	for id, server := range p.servers {
+		if now.Sub(server.LastHeartbeat) > serverTimeout || server.Reserved > 0 {
+			continue
+		}
+		if !server.IdleSince.IsZero() && now.Sub(server.IdleSince) >= d {
+			idle = append(idle, id)
+		}
+	}
+	sort.Strings(idle)
+	return idle
+}
+
+// serverLoad is the busier of slot usage and CPU (tick budget) usage, 0..1
+func serverLoad(server *ServerStatus) float64 {
+	slots := 1.0
+	if server.MaxPlayers > 0 {
+		used := server.MaxPlayers - server.FreeSlots + server.Reserved
+		slots = float64(used) / float64(server.MaxPlayers)
+	}
+	if server.TickLoad > slots {
+		return server.TickLoad
+	}
+	return slots
+}
+
+// settleReservations takes players that showed up in a heartbeat off the
+// oldest reservations first, dropping the ones that have fully arrived
+func (p *ServerPool) settleReservations(server *ServerStatus, arrived int) {
+	kept := server.reservations[:0]
+	for _, r := range server.reservations {
+		taken := min(arrived, r.players)
+		arrived -= taken
+		server.Reserved -= taken
+		if r.players -= taken; r.players > 0 {
+			kept = append(kept, r)
+		}
+	}
+	server.reservations = kept
+}
+
+// Reservations are dropped once they expire or their players show up in a
+// heartbeat; until then invited players may not have connected yet
+func (p *ServerPool) expireReservations(server *ServerStatus, now time.Time) {
+	kept := server.reservations[:0]
+	reserved := 0
+	for _, r := range server.reservations {
+		if now.Before(r.expiresAt) {
+			kept = append(kept, r)
+			reserved += r.players
+		}
+	}
+	server.reservations = kept
+	server.Reserved = reserved
+}
+
+// authorized checks for "Authorization: Bearer <secret>"
+func (p *ServerPool) authorized(r *http.Request) bool {
+	if p.secret == "" {
+		return false
+	}
+	token := extractToken(r)
+	return subtle.ConstantTimeCompare([]byte(token), []byte(p.secret)) == 1
+}
+
+// handleHeartbeat handles POST /server/heartbeat
+func (p *ServerPool) handleHeartbeat(w http.ResponseWriter, r *http.Request) {
+	if r.Method != http.MethodPost {
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+	if !p.authorized(r) {
+		http.Error(w, "Unauthorized", http.StatusUnauthorized)
+		return
+	}
+
+	var req ServerHeartbeatRequest
+	if err := json.NewDecoder(r.Body).Decode(&req); err != nil || req.ServerID == "" || req.Port <= 0 {
+		http.Error(w, "Invalid request", http.StatusBadRequest)
+		return
+	}
+
+	p.Heartbeat(req)
+	respondJSON(w, map[string]string{"status": "heartbeat_received"}, http.StatusOK)
+}
+
+// handleListServers handles GET /server/list (for debugging and autoscaling)
+func (p *ServerPool) handleListServers(w http.ResponseWriter, r *http.Request) {
+	if !p.authorized(r) {
+		http.Error(w, "Unauthorized", http.StatusUnauthorized)
+		return
+	}
+
+	p.mu.Lock()
+	now := p.now()
+	servers := make([]map[string]interface{}, 0, len(p.servers))
+	for _, server := range p.servers {
+		p.expireReservations(server, now)
+		servers = append(servers, map[string]interface{}{
+			"server_id":   server.ServerID,
+			"host":        server.Host,
+			"port":        server.Port,
+			"max_players": server.MaxPlayers,
+			"free_slots":  server.FreeSlots,
+			"reserved":    server.Reserved,
+			"peers":       server.Peers,
+			"tick_load":   server.TickLoad,
+			"load":        serverLoad(server),
+			"alive":       now.Sub(server.LastHeartbeat) <= serverTimeout,
+			"idle":        !server.IdleSince.IsZero() && server.Reserved == 0,
+		})
+	}
+	p.mu.Unlock()
+
+	respondJSON(w, servers, http.StatusOK)
+}
@@ -0,0 +1,170 @@
+package main
+
+import (
+	"bytes"
+	"encoding/json"
+	"net/http"
+	"net/http/httptest"
+	"testing"
+	"time"
+)
+
+func heartbeat(id string, maxPlayers, freeSlots, peers int, tickLoad float64) ServerHeartbeatRequest {
+	return ServerHeartbeatRequest{
+		ServerID:   id,
+		Host:       "127.0.0.1",
+		Port:       7777,
+		MaxPlayers: maxPlayers,
+		FreeSlots:  freeSlots,
+		Peers:      peers,
+		TickLoad:   tickLoad,
+	}
+}
+
+// TestServerPoolPicksLeastLoaded checks placement by slots, CPU load and reservations
+func TestServerPoolPicksLeastLoaded(t *testing.T) {
+	pool := NewServerPool("s3cret")
+	pool.Heartbeat(heartbeat("busy", 8, 2, 6, 0.2))
+	pool.Heartbeat(heartbeat("hot", 8, 8, 0, 0.95)) // tick budget exhausted
+	pool.Heartbeat(heartbeat("quiet", 8, 7, 1, 0.1))
+
+	server := pool.PickLeastLoaded(4)
+	if server == nil || server.ServerID != "quiet" {
+		t.Fatalf("expected quiet server, got %+v", server)
+	}
+
+	// quiet now has 3 unreserved slots, busy has 2: nobody fits another 4
+	if server := pool.PickLeastLoaded(4); server != nil {
+		t.Fatalf("expected no server with room, got %s", server.ServerID)
+	}
+	if server := pool.PickLeastLoaded(3); server == nil || server.ServerID != "quiet" {
+		t.Fatalf("expected quiet server for 3 players, got %+v", server)
+	}
+	if server := pool.PickLeastLoaded(2); server == nil || server.ServerID != "busy" {
+		t.Fatalf("expected busy server once quiet is full, got %+v", server)
+	}
+}
+
+// TestServerPoolExpiresSilentServers checks stale heartbeats, reservations and idle detection
+func TestServerPoolExpiresSilentServers(t *testing.T) {
+	now := time.Unix(1000, 0)
+	pool := NewServerPool("s3cret")
+	pool.now = func() time.Time { return now }
+
+	pool.Heartbeat(heartbeat("a", 6, 6, 0, 0))
+	if server := pool.PickLeastLoaded(6); server == nil {
+		t.Fatal("expected fresh server to be picked")
+	}
+
+	now = now.Add(reservationTTL + time.Second)
+	if idle := pool.IdleServers(time.Minute); len(idle) != 0 {
+		t.Fatalf("silent server should not be reported idle: %v", idle)
+	}
+	if server := pool.PickLeastLoaded(1); server != nil {
+		t.Fatal("server without a recent heartbeat must not be picked")
+	}
+
+	pool.Heartbeat(heartbeat("a", 6, 6, 0, 0))
+	if server := pool.PickLeastLoaded(6); server == nil {
+		t.Fatal("expired reservation should free the slots again")
+	}
+
+	now = now.Add(reservationTTL + time.Second)
+	pool.Heartbeat(heartbeat("a", 6, 6, 0, 0))
+	if idle := pool.IdleServers(time.Minute); len(idle) != 1 || idle[0] != "a" {
+		t.Fatalf("expected a to be idle, got %v", idle)
+	}
+}
+
+// TestServerPoolReleasesReservations checks that an unused reservation frees its slots at once
+func TestServerPoolReleasesReservations(t *testing.T) {
+	pool := NewServerPool("s3cret")
+	pool.Heartbeat(heartbeat("a", 6, 6, 0, 0))
+	if server := pool.PickLeastLoaded(4); server == nil {
+		t.Fatal("expected a to be picked")
+	}
+	if server := pool.PickLeastLoaded(4); server != nil {
+		t.Fatal("reserved slots must not be handed out twice")
+	}
+	pool.Release("a", 4)
+	pool.Release("unknown", 4)
+	if server := pool.PickLeastLoaded(4); server == nil {
+		t.Fatal("released slots should be available again")
+	}
+}
+
+// TestServerPoolSettlesArrivedReservations checks that players a heartbeat already counts stop holding slots
+func TestServerPoolSettlesArrivedReservations(t *testing.T) {
+	pool := NewServerPool("s3cret")
+	pool.Heartbeat(heartbeat("a", 8, 8, 0, 0))
+	if server := pool.PickLeastLoaded(4); server == nil {
+		t.Fatal("expected a to be picked")
+	}
+	if server := pool.PickLeastLoaded(4); server == nil {
+		t.Fatal("expected a to take a second match")
+	}
+
+	// The first match connects: 4 slots taken, 4 still reserved for the second
+	pool.Heartbeat(heartbeat("a", 8, 4, 4, 0))
+	if server := pool.PickLeastLoaded(1); server != nil {
+		t.Fatal("arrived players must not be counted twice, but the second reservation still holds")
+	}
+
+	// Half of the second match connects, then the rest
+	pool.Heartbeat(heartbeat("a", 8, 2, 6, 0))
+	pool.Heartbeat(heartbeat("a", 8, 0, 8, 0))
+	pool.Heartbeat(heartbeat("a", 8, 8, 0, 0)) // everyone left again
+	if server := pool.PickLeastLoaded(8); server == nil {
+		t.Fatal("fully arrived reservations should no longer hold slots")
+	}
+}
+
+func heartbeatRequest(t *testing.T, body []byte, secret string) *http.Request {
+	t.Helper()
+	req := httptest.NewRequest(http.MethodPost, "/server/heartbeat", bytes.NewReader(body))
+	if secret != "" {
+		req.Header.Set("Authorization", "Bearer "+secret)
+	}
+	return req
+}
+
+// TestServerHeartbeatEndpoint checks the HTTP handler used by sumo_balls_server
+func TestServerHeartbeatEndpoint(t *testing.T) {
+	pool := NewServerPool("s3cret")
+	body, _ := json.Marshal(heartbeat("server_7777", 8, 8, 0, 0.05))
+	for _, secret := range []string{"", "wrong"} {
+		rec := httptest.NewRecorder()
+		pool.handleHeartbeat(rec, heartbeatRequest(t, body, secret))
+		if rec.Code != http.StatusUnauthorized {
+			t.Fatalf("expected 401 with secret %q, got %d", secret, rec.Code)
+		}
+	}
+	if server := pool.PickLeastLoaded(1); server != nil {
+		t.Fatal("unauthenticated heartbeats must not register servers")
+	}
+
+	rec := httptest.NewRecorder()
+	pool.handleHeartbeat(rec, heartbeatRequest(t, body, "s3cret"))
+	if rec.Code != http.StatusOK {
+		t.Fatalf("expected 200, got %d", rec.Code)
+	}
+
+	bad := heartbeatRequest(t, []byte(`{"port":1}`), "s3cret")
+	rec = httptest.NewRecorder()
+	pool.handleHeartbeat(rec, bad)
+	if rec.Code != http.StatusBadRequest {
+		t.Fatalf("expected 400 without server_id, got %d", rec.Code)
+	}
+
+	if server := pool.PickLeastLoaded(2); server == nil || server.Port != 7777 {
+		t.Fatalf("expected heartbeat to register the server, got %+v", server)
+	}
+
+	// Without a configured secret nothing can authenticate
+	closed := NewServerPool("")
+	rec = httptest.NewRecorder()
+	closed.handleHeartbeat(rec, heartbeatRequest(t, body, ""))
+	if rec.Code != http.StatusUnauthorized {
+		t.Fatalf("expected 401 when no secret is configured, got %d", rec.Code)
+	}
+}
@@ -232,10 +232,11 @@ type QueueStatusResponse struct {
 }
 
 type MatchInvitationResponse struct {
-	Success     bool             `json:"success"`
-	Message     string           `json:"message,omitempty"`
-	Invitation  *MatchInvitation `json:"invitation,omitempty"`
-	SecondsLeft int              `json:"seconds_left,omitempty"`
+	Success     bool              `json:"success"`
+	Message     string            `json:"message,omitempty"`
+	Invitation  *MatchInvitation  `json:"invitation,omitempty"`
+	SecondsLeft int               `json:"seconds_left,omitempty"`
+	Server      *ServerAssignment `json:"server,omitempty"` // where to connect once accepted
 }
 
 type AcceptMatchRequest struct {
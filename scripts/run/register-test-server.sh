@@ -1,6 +1,9 @@
 #!/bin/bash
 
-# Register a mock game server with the coordinator
+# Register a mock game server with the coordinator by sending one capacity
+# heartbeat. Real servers do this themselves: sumo_balls_server --coordinator URL
+# Without further heartbeats the coordinator stops placing matches here after 30s.
+# Needs the coordinator's SERVER_SECRET in the environment.
 
 SERVER_ID="server_test_1"
 HOST="127.0.0.1"
@@ -8,9 +11,16 @@ PORT=9999
 
 echo "Registering server $SERVER_ID at $HOST:$PORT..."
 
-curl -X POST http://localhost:8888/server/register \
+if [ -z "$SERVER_SECRET" ]; then
+  echo "Set SERVER_SECRET to the coordinator's secret first"
+  exit 1
+fi
+
+curl -X POST http://localhost:8888/server/heartbeat \
   -H "Content-Type: application/json" \
-  -d "{\"server_id\":\"$SERVER_ID\",\"host\":\"$HOST\",\"port\":$PORT,\"max_players\":4}"
+  -H "Authorization: Bearer $SERVER_SECRET" \
+  -d "{\"server_id\":\"$SERVER_ID\",\"host\":\"$HOST\",\"port\":$PORT,\"max_players\":6,\"free_slots\":6,\"peers\":0,\"tick_load\":0}"
 
 echo ""
-echo "Server registered! Check status at: http://localhost:8888/matches"
+echo "Server registered! Check status with:"
+echo "  curl -H \"Authorization: Bearer \$SERVER_SECRET\" http://localhost:8888/server/list"
@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "Settings.h"
+#include "Profiler.h"
 #include "../game/controllers/HumanController.h"
 #include "../game/controllers/AIController.h"
 #include "ui/views/LoginView.h"
@@ -38,9 +39,11 @@ Game::Game() : screens(nullptr, nullptr) {
 
 void Game::run() {
     std::cout << "[Game] Starting main loop" << std::endl;
+    PROFILE_THREAD_NAME("main");
 
     int frameCount = 0;
     while(gfx->isRunning()) {
+        PROFILE_SCOPE("Game::frame");
         frameCount++;
         
         // Handle window events and pass to ImGui and screens
@@ -49,6 +52,11 @@ void Game::run() {
         while (SDL_PollEvent(&event)) {
             // Let ImGui handle first
             imgui->processEvent(&event);
+
+            // F9 dumps the profiler ring buffers to a Chrome trace
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F9) {
+                PROFILE_REQUEST_DUMP();
+            }
             
             // Let screens handle input
             bool handled = screens.handleInput(event);
@@ -83,6 +91,7 @@ void Game::run() {
         
         try {
             // Render frame
+            PROFILE_SCOPE("Game::render");
             gfx->beginFrame();
             
             imgui->beginFrame();
@@ -98,6 +107,8 @@ void Game::run() {
             std::cerr << "Unknown game render error occurred" << std::endl;
             break;
         }
+
+        PROFILE_POLL_DUMP();
     }
     
     std::cout << "[Game] Main loop ended" << std::endl;
@@ -0,0 +1,176 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+
+namespace profiling {
+
+namespace {
+// Hands the buffer back to the profiler when the owning thread exits
+struct BufferOwner {
+    ThreadBuffer* buffer{nullptr};
+    ~BufferOwner() {
+        if (buffer) Profiler::instance().releaseBuffer(buffer);
+    }
+};
+thread_local BufferOwner tlsOwner;
+
+// Set from the signal handler; std::atomic<bool> is lock-free and signal safe
+std::atomic<bool> signalDumpRequested{false};
+
+void onDumpSignal(int) {
+    signalDumpRequested.store(true, std::memory_order_relaxed);
+}
+
+void writeEscaped(std::ostream& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+}
+}
+
+void ThreadBuffer::collect(std::vector<ZoneEvent>& out) const {
+    const std::uint64_t end = written.load(std::memory_order_acquire);
+    const std::uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    out.reserve(out.size() + static_cast<std::size_t>(end - begin));
+    for (std::uint64_t i = begin; i < end; ++i) {
+        const Slot& slot = events[i & (CAPACITY - 1)];
+        const std::uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+        ZoneEvent e{slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                    slot.durationNs.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The owner lapped this slot while we were copying: the event is gone or torn
+        if (stamp != 2 * i + 2 || slot.stamp.load(std::memory_order_relaxed) != stamp) continue;
+        out.push_back(e);
+    }
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::~Profiler() {
+    if (dumpWriter.joinable()) dumpWriter.join();
+}
+
+ThreadBuffer& Profiler::threadBuffer() {
+    if (!tlsOwner.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        ThreadBuffer* buffer;
+        if (!freeBuffers.empty()) {
+            buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            buffer->reset();
+            buffer->setThreadName("thread " + std::to_string(buffer->threadId()));
+        } else {
+            const auto tid = static_cast<std::uint32_t>(buffers.size() + 1);
+            buffers.push_back(std::make_unique<ThreadBuffer>(tid, "thread " + std::to_string(tid)));
+            buffer = buffers.back().get();
+        }
+        liveBuffers.push_back(buffer);
+        tlsOwner.buffer = buffer;
+    }
+    return *tlsOwner.buffer;
+}
+
+void Profiler::releaseBuffer(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    liveBuffers.erase(std::remove(liveBuffers.begin(), liveBuffers.end(), buffer), liveBuffers.end());
+    freeBuffers.push_back(buffer);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.setThreadName(name);
+}
+
+std::vector<ThreadTrace> Profiler::snapshot() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<ThreadTrace> threads(liveBuffers.size());
+    for (std::size_t i = 0; i < liveBuffers.size(); ++i) {
+        threads[i].threadId = liveBuffers[i]->threadId();
+        threads[i].threadName = liveBuffers[i]->threadName();
+        liveBuffers[i]->collect(threads[i].events);
+    }
+    return threads;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    return writeChromeTrace(path, snapshot());
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, const std::vector<ThreadTrace>& threads) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Profiler Error] Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const auto& thread : threads) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << thread.threadId << ",\"args\":{\"name\":\"";
+        writeEscaped(out, thread.threadName);
+        out << "\"}}";
+        first = false;
+
+        for (const auto& e : thread.events) {
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, e.name ? e.name : "?");
+            out << "\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+                << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+                << ",\"dur\":" << static_cast<double>(e.durationNs) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::setAutoDumpInterval(float seconds) {
+    autoDumpIntervalNs = seconds > 0.f ? static_cast<std::uint64_t>(seconds * 1e9f) : 0;
+    lastAutoDumpNs = nowNs();
+}
+
+void Profiler::installSignalHandler() {
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, onDumpSignal);
+#endif
+}
+
+void Profiler::pollDump() {
+    bool dump = dumpRequested.exchange(false, std::memory_order_relaxed);
+    dump = signalDumpRequested.exchange(false, std::memory_order_relaxed) || dump;
+
+    const std::uint64_t now = nowNs();
+    if (autoDumpIntervalNs > 0 && now - lastAutoDumpNs >= autoDumpIntervalNs) {
+        lastAutoDumpNs = now;
+        dump = true;
+    }
+    if (!dump) return;
+
+    // One file at a time; a request arriving mid-write waits for the next poll
+    if (dumpWriting.load(std::memory_order_acquire)) {
+        dumpRequested.store(true, std::memory_order_relaxed);
+        return;
+    }
+    if (dumpWriter.joinable()) dumpWriter.join();
+
+    const auto unixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    const std::string path = outputPrefix + "_" + std::to_string(unixMs) + ".json";
+    dumpWriting.store(true, std::memory_order_release);
+    dumpWriter = std::thread([this, path, threads = snapshot()] {
+        if (writeChromeTrace(path, threads)) {
+            std::cout << "[Profiler] Wrote trace " << path << std::endl;
+        }
+        dumpWriting.store(false, std::memory_order_release);
+    });
+}
+
+} // namespace profiling
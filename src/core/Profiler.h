@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Scoped-zone profiler with Chrome trace / Perfetto JSON export.
+///
+/// Every thread records into its own fixed ring buffer, so PROFILE_SCOPE costs
+/// two steady_clock reads and one store, with no locks or allocation. A buffer
+/// goes back to a free list when its thread exits and is handed to the next new
+/// thread, so short-lived threads don't leak one each. Dumps are requested via
+/// PROFILE_REQUEST_DUMP() (key press), SIGUSR1, or a periodic interval; the loop
+/// calling PROFILE_POLL_DUMP() copies the events and a background thread writes
+/// the file.
+///
+/// Define SUMO_PROFILING (CMake option SUMO_ENABLE_PROFILER) to compile zones
+/// in; without it every macro expands to nothing.
+namespace profiling {
+
+struct ZoneEvent {
+    const char* name{nullptr};  // must be a string literal / static storage
+    std::uint64_t startNs{0};
+    std::uint64_t durationNs{0};
+};
+
+inline std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Single-writer ring of zone events owned by one thread. Each slot carries a
+/// seqlock stamp (odd while being written, 2 * index + 2 once done), so a reader
+/// can tell a complete event from one the owner is overwriting.
+class ThreadBuffer {
+public:
+    static constexpr std::size_t CAPACITY = 1 << 15;
+
+    ThreadBuffer(std::uint32_t threadId, std::string threadName)
+        : tid(threadId), name(std::move(threadName)) {}
+
+    void push(const ZoneEvent& e) {
+        const std::uint64_t w = written.load(std::memory_order_relaxed);
+        Slot& slot = events[w & (CAPACITY - 1)];
+        slot.stamp.store(2 * w + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(e.name, std::memory_order_relaxed);
+        slot.startNs.store(e.startNs, std::memory_order_relaxed);
+        slot.durationNs.store(e.durationNs, std::memory_order_relaxed);
+        slot.stamp.store(2 * w + 2, std::memory_order_release);
+        written.store(w + 1, std::memory_order_release);
+    }
+
+    /// Copy out the retained events (safe to call from another thread)
+    void collect(std::vector<ZoneEvent>& out) const;
+
+    /// Forget all events; only while no thread owns the buffer
+    void reset() { written.store(0, std::memory_order_relaxed); }
+
+    std::uint32_t threadId() const { return tid; }
+    const std::string& threadName() const { return name; }
+    void setThreadName(std::string n) { name = std::move(n); }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> stamp{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> startNs{0};
+        std::atomic<std::uint64_t> durationNs{0};
+    };
+
+    Slot events[CAPACITY];
+    std::atomic<std::uint64_t> written{0};
+    std::uint32_t tid;
+    std::string name;
+};
+
+/// Events of one thread, copied out for export
+struct ThreadTrace {
+    std::uint32_t threadId{0};
+    std::string threadName;
+    std::vector<ZoneEvent> events;
+};
+
+class Profiler {
+public:
+    static Profiler& instance();
+    ~Profiler();
+
+    /// Buffer of the calling thread (taken from the free list or created on
+    /// first use, returned to the free list when the thread exits)
+    ThreadBuffer& threadBuffer();
+    void releaseBuffer(ThreadBuffer* buffer);
+    void setThreadName(const std::string& name);
+
+    void record(const char* name, std::uint64_t startNs, std::uint64_t endNs) {
+        threadBuffer().push(ZoneEvent{name, startNs, endNs - startNs});
+    }
+
+    /// Copy the events of every live thread
+    std::vector<ThreadTrace> snapshot();
+
+    /// Export everything currently buffered as Chrome trace JSON
+    bool writeChromeTrace(const std::string& path);
+    static bool writeChromeTrace(const std::string& path, const std::vector<ThreadTrace>& threads);
+
+    /// Dump triggers
+    void requestDump() { dumpRequested.store(true, std::memory_order_relaxed); }
+    void setAutoDumpInterval(float seconds);
+    void setOutputPrefix(const std::string& prefix) { outputPrefix = prefix; }
+    void installSignalHandler();
+
+    /// Start writing a trace if a dump is pending; call once per frame/loop
+    /// iteration. Only the copy happens on the caller's thread.
+    void pollDump();
+
+private:
+    Profiler() = default;
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;  // every buffer ever created
+    std::vector<ThreadBuffer*> liveBuffers;              // owned by a running thread
+    std::vector<ThreadBuffer*> freeBuffers;              // owner exited, ready for reuse
+    std::thread dumpWriter;
+    std::atomic<bool> dumpWriting{false};
+    std::atomic<bool> dumpRequested{false};
+    std::string outputPrefix{"profile"};
+    std::uint64_t autoDumpIntervalNs{0};
+    std::uint64_t lastAutoDumpNs{0};
+};
+
+/// RAII zone marker
+class ScopedZone {
+public:
+    explicit ScopedZone(const char* zoneName) : name(zoneName), start(nowNs()) {}
+    ~ScopedZone() { Profiler::instance().record(name, start, nowNs()); }
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    const char* name;
+    std::uint64_t start;
+};
+
+} // namespace profiling
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(SUMO_PROFILING)
+#define PROFILE_SCOPE(name) ::profiling::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD_NAME(name) ::profiling::Profiler::instance().setThreadName(name)
+#define PROFILE_REQUEST_DUMP() ::profiling::Profiler::instance().requestDump()
+#define PROFILE_POLL_DUMP() ::profiling::Profiler::instance().pollDump()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#define PROFILE_REQUEST_DUMP() ((void)0)
+#define PROFILE_POLL_DUMP() ((void)0)
+#endif
@@ -1,5 +1,6 @@
 #include "ScreenStack.h"
 #include "Settings.h"
+#include "Profiler.h"
 #include "GraphicsContext.h"
 #include "ScreenTransition.h"
 #include "ui/views/MainMenuView.h"
@@ -63,6 +64,7 @@ bool ScreenStack::handleInput(const SDL_Event& event) {
 }
 
 void ScreenStack::update() {
+    PROFILE_SCOPE("ScreenStack::update");
     if (screens.empty()) return;
 
     for (int i = static_cast<int>(screens.size()) - 1; i >= 0; --i) {
@@ -153,6 +155,7 @@ void ScreenStack::update() {
 }
 
 void ScreenStack::render() {
+    PROFILE_SCOPE("ScreenStack::render");
     for (int i = 0; i < static_cast<int>(screens.size()); ++i) {
         bool hasNonOverlayAbove = false;
         for (int j = i + 1; j < static_cast<int>(screens.size()); ++j) {
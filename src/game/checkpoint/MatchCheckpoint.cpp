@@ -0,0 +1,163 @@
+#include "MatchCheckpoint.h"
+#include "game/simulation/Simulation.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace checkpoint {
+
+namespace {
+constexpr std::size_t kSlotOffset = 64;
+constexpr std::size_t kSlotStride = (sizeof(MatchState) + 63) / 64 * 64;
+constexpr std::size_t kFileSize = kSlotOffset + 2 * kSlotStride;
+}
+
+std::uint32_t computeChecksum(const MatchState& state) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&state);
+    const std::size_t len = offsetof(MatchState, checksum);
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::uint32_t captureSimulation(const Simulation& sim, MatchState& out) {
+    out.arenaRadius = sim.getArenaRadius();
+    out.currentArenaRadius = sim.getCurrentArenaRadius();
+    out.arenaAge = sim.getArenaAge();
+    out.playerCount = 0;
+    std::uint32_t left = 0;
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        if (out.playerCount >= MAX_PLAYERS) {
+            ++left;
+            return;
+        }
+        CheckpointPlayer& cp = out.players[out.playerCount++];
+        cp = CheckpointPlayer{};
+        cp.id = p.id;
+        cp.x = p.position.x;
+        cp.y = p.position.y;
+        cp.vx = p.velocity.x;
+        cp.vy = p.velocity.y;
+        cp.inputX = p.inputDir.x;
+        cp.inputY = p.inputDir.y;
+        cp.flags = p.alive ? PLAYER_ALIVE : 0;
+    });
+    return left;
+}
+
+void restoreSimulation(const MatchState& state, Simulation& sim) {
+    sim.setArenaRadius(state.arenaRadius);
+    sim.restoreArena(state.arenaAge, state.currentArenaRadius);
+    for (std::uint32_t i = 0; i < state.playerCount && i < MAX_PLAYERS; ++i) {
+        const CheckpointPlayer& cp = state.players[i];
+        SimPlayer p;
+        p.id = cp.id;
+        p.position = {cp.x, cp.y};
+        p.velocity = {cp.vx, cp.vy};
+        p.inputDir = {cp.inputX, cp.inputY};
+        p.alive = (cp.flags & PLAYER_ALIVE) != 0;
+        sim.restorePlayer(p);
+    }
+}
+
+CheckpointFile::~CheckpointFile() { close(); }
+
+bool CheckpointFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "[Checkpoint Error] Failed to open checkpoint file: " << path << std::endl;
+        return false;
+    }
+    struct stat st{};
+    const bool fresh = fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != kFileSize;
+    if (fresh && ftruncate(fd, static_cast<off_t>(kFileSize)) != 0) {
+        std::cerr << "[Checkpoint Error] Failed to size checkpoint file: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, kFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "[Checkpoint Error] mmap failed for checkpoint: " << path << std::endl;
+        return false;
+    }
+    base = static_cast<std::uint8_t*>(mapped);
+    size = kFileSize;
+
+    FileHeader* h = header();
+    if (fresh || h->magic != FILE_MAGIC || h->version != FORMAT_VERSION) {
+        std::memset(base, 0, size);
+        h->magic = FILE_MAGIC;
+        h->version = FORMAT_VERSION;
+        h->activeSlot = NO_ACTIVE_SLOT;
+    }
+
+    // Continue numbering after whatever is on disk
+    for (std::uint32_t i = 0; i < 2; ++i) {
+        if (slot(i)->sequence >= nextSequence) nextSequence = slot(i)->sequence + 1;
+    }
+    return true;
+}
+
+void CheckpointFile::close() {
+    if (base) {
+        msync(base, size, MS_ASYNC);
+        munmap(base, size);
+        base = nullptr;
+    }
+    size = 0;
+}
+
+CheckpointFile::FileHeader* CheckpointFile::header() const {
+    return reinterpret_cast<FileHeader*>(base);
+}
+
+MatchState* CheckpointFile::slot(std::uint32_t index) const {
+    return reinterpret_cast<MatchState*>(base + kSlotOffset + index * kSlotStride);
+}
+
+bool CheckpointFile::load(MatchState& out) const {
+    if (!base) return false;
+    const std::uint32_t active = std::atomic_ref<std::uint32_t>(header()->activeSlot).load(std::memory_order_acquire);
+    if (active > 1) return false;
+
+    // Prefer the published slot; if it was torn (power loss mid write-back) use the older one
+    for (std::uint32_t candidate : {active, active ^ 1u}) {
+        const MatchState* s = slot(candidate);
+        if (s->sequence != 0 && s->checksum == computeChecksum(*s) && s->playerCount <= MAX_PLAYERS) {
+            std::memcpy(&out, s, sizeof(MatchState));
+            return true;
+        }
+    }
+    return false;
+}
+
+void CheckpointFile::write(MatchState& state) {
+    if (!base) return;
+    std::atomic_ref<std::uint32_t> active(header()->activeSlot);
+    const std::uint32_t current = active.load(std::memory_order_relaxed);
+    const std::uint32_t target = current == 0 ? 1 : 0;
+
+    state.sequence = nextSequence++;
+    state.checksum = computeChecksum(state);
+    std::memcpy(slot(target), &state, sizeof(MatchState));
+    active.store(target, std::memory_order_release);
+}
+
+void CheckpointFile::clear() {
+    if (!base) return;
+    std::atomic_ref<std::uint32_t>(header()->activeSlot).store(NO_ACTIVE_SLOT, std::memory_order_release);
+}
+
+} // namespace checkpoint
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Simulation;
+
+namespace checkpoint {
+
+constexpr std::uint32_t FILE_MAGIC = 0x4B434253;  // "SBCK" little-endian
+constexpr std::uint32_t FORMAT_VERSION = 1;
+constexpr std::uint32_t MAX_PLAYERS = 64;
+constexpr std::uint32_t NO_ACTIVE_SLOT = 0xFFFFFFFFu;
+
+enum PlayerFlags : std::uint8_t {
+    PLAYER_ALIVE = 1 << 0,
+    PLAYER_BOT   = 1 << 1
+};
+
+struct CheckpointPlayer {
+    std::uint32_t id{0};
+    std::uint32_t resumeToken{0};  // what the owning client reconnects with (0 for bots)
+    float x{0.f}, y{0.f};
+    float vx{0.f}, vy{0.f};
+    float inputX{0.f}, inputY{0.f};
+    std::uint8_t flags{0};
+    std::uint8_t pad[3]{};
+};
+static_assert(sizeof(CheckpointPlayer) == 36, "CheckpointPlayer layout is part of the file format");
+
+// Everything needed to continue a match after a restart
+struct MatchState {
+    std::uint64_t sequence{0};      // assigned by CheckpointFile::write
+    std::uint64_t savedUnixMs{0};
+    std::uint32_t tick{0};
+    std::uint32_t nextPlayerId{1};
+    float arenaRadius{0.f};
+    float currentArenaRadius{0.f};
+    float arenaAge{0.f};
+    std::uint32_t playerCount{0};
+    CheckpointPlayer players[MAX_PLAYERS];
+    std::uint32_t checksum{0};      // FNV-1a of everything above
+};
+
+/// Fill tick-independent simulation fields and players (flags, tokens and the
+/// counters are left to the caller); returns how many players past
+/// MAX_PLAYERS did not fit
+std::uint32_t captureSimulation(const Simulation& sim, MatchState& out);
+/// Re-create the arena and every player of a loaded state
+void restoreSimulation(const MatchState& state, Simulation& sim);
+
+/// Memory-mapped double buffer of MatchState.
+///
+/// write() copies into the slot the header does not point at, then publishes
+/// it with a single atomic store of the header's active index. A crash at any
+/// point leaves either the old or the new state readable, and the tick thread
+/// only ever does a memcpy into mapped pages (the kernel writes them back).
+class CheckpointFile {
+public:
+    CheckpointFile() = default;
+    ~CheckpointFile();
+
+    CheckpointFile(const CheckpointFile&) = delete;
+    CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    /// Newest intact state; falls back to the other slot if the active one is torn
+    bool load(MatchState& out) const;
+    void write(MatchState& state);
+    /// Forget the match (nothing left to resume)
+    void clear();
+
+private:
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t activeSlot;  // 0/1, or NO_ACTIVE_SLOT; flipped atomically
+        std::uint32_t reserved;
+    };
+
+    FileHeader* header() const;
+    MatchState* slot(std::uint32_t index) const;
+
+    std::uint8_t* base{nullptr};
+    std::size_t size{0};
+    std::uint64_t nextSequence{1};
+};
+
+std::uint32_t computeChecksum(const MatchState& state);
+
+} // namespace checkpoint
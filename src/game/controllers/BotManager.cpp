@@ -0,0 +1,129 @@
+#include "BotManager.h"
+#include "game/simulation/Simulation.h"
+#include "core/Profiler.h"
+
+#include <chrono>
+
+BotManager::BotManager(Simulation& simulation, BotConfig config)
+    : sim(simulation), cfg(config) {}
+
+bool BotManager::isBot(std::uint32_t id) const {
+    for (const Bot& bot : bots) {
+        if (bot.id == id) return true;
+    }
+    return false;
+}
+
+void BotManager::addBot(std::uint32_t id, Vec2 spawn) {
+    Bot bot{id, sim.addPlayer(id, spawn), AIController(cfg.difficulty)};
+    bots.push_back(std::move(bot));
+}
+
+bool BotManager::adoptBot(std::uint32_t id) {
+    const std::size_t slot = sim.slotOf(id);
+    if (slot == Simulation::INVALID_SLOT || isBot(id)) return false;
+    bots.push_back(Bot{id, slot, AIController(cfg.difficulty)});
+    return true;
+}
+
+bool BotManager::removeBot(std::uint32_t id) {
+    for (std::size_t i = 0; i < bots.size(); ++i) {
+        if (bots[i].id == id) {
+            sim.removePlayer(id);
+            eraseAt(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t BotManager::removeAny() {
+    if (bots.empty()) return 0;
+    std::size_t victim = bots.size() - 1;
+    for (std::size_t i = 0; i < bots.size(); ++i) {
+        const SimPlayer* p = sim.playerAt(bots[i].slot);
+        if (!p || !p->alive) {
+            victim = i;
+            break;
+        }
+    }
+    const std::uint32_t id = bots[victim].id;
+    sim.removePlayer(id);
+    eraseAt(victim);
+    return id;
+}
+
+void BotManager::clear() {
+    for (const Bot& bot : bots) sim.removePlayer(bot.id);
+    bots.clear();
+    cursor = 0;
+}
+
+std::uint32_t BotManager::releaseForHuman() {
+    for (std::size_t i = 0; i < bots.size(); ++i) {
+        const SimPlayer* p = sim.playerAt(bots[i].slot);
+        if (p && p->alive) {
+            const std::uint32_t id = bots[i].id;
+            eraseAt(i);
+            return id;
+        }
+    }
+    return 0;
+}
+
+void BotManager::update(float dt) {
+    if (bots.empty()) return;
+    PROFILE_SCOPE("BotManager::update");
+
+    for (Bot& bot : bots) bot.pendingDt += dt;
+
+    everyone.clear();
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        if (p.alive) everyone.push_back({p.id, {p.position, p.velocity}});
+    });
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const auto budget = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(cfg.budgetMs));
+
+    const std::size_t n = bots.size();
+    std::size_t visited = 0;
+    bool updatedAny = false;
+    for (; visited < n; ++visited) {
+        if (updatedAny && Clock::now() - start >= budget) break;
+
+        Bot& bot = bots[(cursor + visited) % n];
+        const SimPlayer* self = sim.playerAt(bot.slot);
+        if (!self || !self->alive) {
+            bot.pendingDt = 0.f;
+            continue;
+        }
+
+        others.clear();
+        for (const auto& entry : everyone) {
+            if (entry.first != bot.id) others.push_back(entry.second);
+        }
+        bot.direction = bot.ai.getMovementDirection(
+            bot.pendingDt, self->position, self->velocity, others,
+            sim.arenaCenter, sim.getCurrentArenaRadius(), sim.getArenaAge());
+        bot.pendingDt = 0.f;
+        updatedAny = true;
+        ++counters.updates;
+    }
+
+    if (visited < n) {
+        counters.deferred += n - visited;
+        ++counters.overBudgetTicks;
+    }
+    cursor = (cursor + visited) % n;
+
+    // Everyone keeps steering, fresh decision or not
+    for (const Bot& bot : bots) sim.applyInputAt(bot.slot, bot.direction);
+}
+
+void BotManager::eraseAt(std::size_t index) {
+    bots.erase(bots.begin() + static_cast<std::ptrdiff_t>(index));
+    if (cursor > index) --cursor;
+    if (cursor >= bots.size()) cursor = 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "AIController.h"
+#include "utils/VectorMath.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Simulation;
+
+struct BotConfig {
+    std::size_t targetPlayers{0};        // fill the match up to this many balls (0 = no bots)
+    DifficultyLevel difficulty{DifficultyLevel::Medium};
+    float budgetMs{0.5f};                // CPU time per tick shared by all bots
+};
+
+struct BotStats {
+    std::uint64_t updates{0};            // AI decisions made
+    std::uint64_t deferred{0};           // bot updates pushed to a later tick by the budget
+    std::uint64_t overBudgetTicks{0};    // ticks that ran out of budget
+};
+
+/// Server-owned bots driven by AIController against the authoritative Simulation.
+///
+/// Bots are updated round-robin under a per-tick time budget: a bot that does
+/// not get a turn keeps steering with its previous direction, and its skipped
+/// time is handed to the controller on its next turn. At least one bot is
+/// updated every tick so the rotation always makes progress.
+class BotManager {
+public:
+    BotManager(Simulation& simulation, BotConfig config);
+
+    const BotConfig& config() const { return cfg; }
+    std::size_t count() const { return bots.size(); }
+    bool isBot(std::uint32_t id) const;
+
+    void addBot(std::uint32_t id, Vec2 spawn);
+    // Take over a ball that is already in the simulation (e.g. restored from a checkpoint)
+    bool adoptBot(std::uint32_t id);
+    bool removeBot(std::uint32_t id);
+    // Remove one bot (eliminated ones first); returns its id, or 0 if there are none
+    std::uint32_t removeAny();
+    void clear();
+
+    // Detach a living bot so a joining human can take over its ball in place.
+    // The ball stays in the simulation under the returned id (0 if no bot is alive).
+    std::uint32_t releaseForHuman();
+
+    // Steer bots for one fixed tick; call before Simulation::tick
+    void update(float dt);
+
+    const BotStats& stats() const { return counters; }
+
+private:
+    struct Bot {
+        std::uint32_t id{0};
+        std::size_t slot{0};
+        AIController ai;
+        float pendingDt{0.f};
+        Vec2 direction{0.f, 0.f};
+    };
+
+    Simulation& sim;
+    BotConfig cfg;
+    std::vector<Bot> bots;
+    std::size_t cursor{0};
+    BotStats counters;
+
+    // Reused every tick so steering does not allocate
+    std::vector<std::pair<std::uint32_t, std::pair<Vec2, Vec2>>> everyone;
+    std::vector<std::pair<Vec2, Vec2>> others;
+
+    void eraseAt(std::size_t index);
+};
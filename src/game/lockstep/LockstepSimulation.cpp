@@ -0,0 +1,54 @@
+#include "LockstepSimulation.h"
+#include "core/Profiler.h"
+
+namespace lockstep {
+
+LockstepSimulation::LockstepSimulation(const net::LockstepStartHeader& start,
+                                       const std::vector<net::LockstepPlayer>& roster)
+    : sim(start.arenaRadius, {start.arenaCenterX, start.arenaCenterY}),
+      dt(1.f / static_cast<float>(start.tickRateHz == 0 ? 60 : start.tickRateHz)),
+      startTick(start.startTick),
+      hashInterval(start.hashInterval),
+      tick(start.startTick) {
+    for (const net::LockstepPlayer& p : roster) sim.addPlayer(p.playerId, {p.x, p.y});
+}
+
+bool LockstepSimulation::pushFrame(const net::LockstepFrameHeader& header,
+                                   const std::vector<net::LockstepInput>& inputs) {
+    const std::uint32_t expected = frames.empty() ? tick : frames.back().tick + 1;
+    if (header.tick != expected) return false;
+    frames.push_back(Frame{header.tick, inputs});
+    return true;
+}
+
+std::size_t LockstepSimulation::advance(std::size_t maxTicks) {
+    PROFILE_SCOPE("LockstepSimulation::advance");
+    std::size_t ran = 0;
+    while (ran < maxTicks && !frames.empty()) {
+        const Frame& frame = frames.front();
+        for (const net::LockstepInput& input : frame.inputs) {
+            sim.applyInput(input.playerId, {input.dirX, input.dirY});
+        }
+        sim.tick(dt);
+        frames.pop_front();
+        ++tick;
+        ++ran;
+
+        if (hashInterval > 0 && (tick - startTick) % hashInterval == 0) {
+            net::StateHash report;
+            report.tick = tick - 1;
+            report.hash = sim.stateHash();
+            hashes.push_back(report);
+        }
+    }
+    return ran;
+}
+
+bool LockstepSimulation::takeHash(net::StateHash& out) {
+    if (hashes.empty()) return false;
+    out = hashes.front();
+    hashes.pop_front();
+    return true;
+}
+
+} // namespace lockstep
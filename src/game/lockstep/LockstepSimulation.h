@@ -0,0 +1,54 @@
+#pragma once
+
+#include "game/simulation/Simulation.h"
+#include "network/NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace lockstep {
+
+/// Client side of a lockstep match: a local Simulation stepped only by the
+/// input frames the server relays.
+///
+/// Every peer builds the same start state from LockstepStart (players added in
+/// roster order, so slots match) and applies identical inputs each tick, so the
+/// simulations stay bit-identical. After every hashInterval ticks a state hash
+/// is queued for the caller to send back; the server compares them across peers.
+class LockstepSimulation {
+public:
+    LockstepSimulation(const net::LockstepStartHeader& start, const std::vector<net::LockstepPlayer>& roster);
+
+    // Buffer the inputs for one tick. Frames must arrive in tick order (they do
+    // on the reliable channel); returns false for a gap or duplicate.
+    bool pushFrame(const net::LockstepFrameHeader& header, const std::vector<net::LockstepInput>& inputs);
+
+    // Simulate buffered frames, at most maxTicks of them; returns ticks run
+    std::size_t advance(std::size_t maxTicks = std::numeric_limits<std::size_t>::max());
+
+    // Pop the next state hash due for reporting, if any
+    bool takeHash(net::StateHash& out);
+
+    std::uint32_t nextTick() const { return tick; }
+    std::size_t bufferedFrames() const { return frames.size(); }
+    float tickDt() const { return dt; }
+    const Simulation& simulation() const { return sim; }
+
+private:
+    struct Frame {
+        std::uint32_t tick{0};
+        std::vector<net::LockstepInput> inputs;
+    };
+
+    Simulation sim;
+    float dt;
+    std::uint32_t startTick;
+    std::uint32_t hashInterval;
+    std::uint32_t tick;
+    std::deque<Frame> frames;
+    std::deque<net::StateHash> hashes;
+};
+
+} // namespace lockstep
@@ -0,0 +1,122 @@
+#include "MatchFlow.h"
+#include "game/simulation/Simulation.h"
+
+#include <cmath>
+
+namespace match {
+
+namespace {
+std::uint32_t wholeSeconds(float sec) {
+    return sec > 0.f ? static_cast<std::uint32_t>(std::ceil(sec)) : 0u;
+}
+}
+
+MatchFlow::MatchFlow(const MatchFlowConfig& config) : cfg(config) {}
+
+bool MatchFlow::update(const Simulation& sim, float dt, std::vector<net::MatchEvent>& out) {
+    const bool enoughPlayers = sim.playerCount() >= cfg.minPlayers;
+    switch (current) {
+        case Phase::Waiting:
+            trackAlive(sim, nullptr);
+            if (!enoughPlayers) return false;
+            enter(Phase::Countdown, out);
+            return true;
+
+        case Phase::Countdown: {
+            if (!enoughPlayers) {
+                enter(Phase::Waiting, out);
+                return false;
+            }
+            phaseTime -= dt;
+            if (phaseTime <= 0.f) {
+                trackAlive(sim, nullptr);
+                enter(Phase::Playing, out);
+                return false;
+            }
+            const std::uint32_t left = wholeSeconds(phaseTime);
+            if (left < announced) {
+                announced = left;
+                out.push_back({net::MatchEventType::Countdown, 0, left});
+            }
+            return false;
+        }
+
+        case Phase::Playing: {
+            trackAlive(sim, &out);
+            std::size_t alive = 0;
+            std::uint32_t survivor = 0;
+            sim.forEachPlayer([&](const SimPlayer& p) {
+                if (!p.alive) return;
+                ++alive;
+                survivor = p.id;
+            });
+            if (alive <= 1) {
+                winner = alive == 1 ? survivor : 0;
+                enter(Phase::Ended, out);
+            }
+            return false;
+        }
+
+        case Phase::Ended:
+            trackAlive(sim, nullptr);
+            phaseTime -= dt;
+            if (phaseTime > 0.f) return false;
+            enter(enoughPlayers ? Phase::Countdown : Phase::Waiting, out);
+            return current == Phase::Countdown;
+    }
+    return false;
+}
+
+void MatchFlow::resumePlaying(const Simulation& sim) {
+    current = Phase::Playing;
+    phaseTime = 0.f;
+    if (roundNumber == 0) roundNumber = 1;
+    trackAlive(sim, nullptr);
+}
+
+net::MatchEvent MatchFlow::currentPhase() const {
+    switch (current) {
+        case Phase::Countdown: return {net::MatchEventType::Countdown, 0, wholeSeconds(phaseTime)};
+        case Phase::Playing:   return {net::MatchEventType::RoundStarted, 0, roundNumber};
+        case Phase::Ended:     return {net::MatchEventType::RoundEnded, winner, roundNumber};
+        case Phase::Waiting:   break;
+    }
+    return {net::MatchEventType::Waiting, 0, 0};
+}
+
+void MatchFlow::enter(Phase phase, std::vector<net::MatchEvent>& out) {
+    current = phase;
+    phaseTime = 0.f;
+    switch (phase) {
+        case Phase::Waiting:
+            out.push_back({net::MatchEventType::Waiting, 0, 0});
+            break;
+        case Phase::Countdown:
+            phaseTime = cfg.countdownSec;
+            announced = wholeSeconds(cfg.countdownSec);
+            out.push_back({net::MatchEventType::Countdown, 0, announced});
+            break;
+        case Phase::Playing:
+            ++roundNumber;
+            out.push_back({net::MatchEventType::RoundStarted, 0, roundNumber});
+            break;
+        case Phase::Ended:
+            phaseTime = cfg.resultsSec;
+            out.push_back({net::MatchEventType::RoundEnded, winner, roundNumber});
+            break;
+    }
+}
+
+void MatchFlow::trackAlive(const Simulation& sim, std::vector<net::MatchEvent>* out) {
+    sim.forEachSlot([&](std::size_t slot, const SimPlayer& p) {
+        if (slot >= aliveBySlot.size()) aliveBySlot.resize(slot + 1, 0);
+        // Only a player seen alive in this slot last tick can be eliminated;
+        // players who leave or take over a slot are not
+        if (out && !p.alive && aliveBySlot[slot] == p.id) {
+            out->push_back({net::MatchEventType::Eliminated, p.id, 0});
+        }
+        aliveBySlot[slot] = p.alive ? p.id : 0;
+    });
+}
+
+} // namespace match
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "network/NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulation;
+
+namespace match {
+
+enum class Phase : std::uint8_t {
+    Waiting,    // fewer than minPlayers; the arena runs freely
+    Countdown,  // players are back at their spawns and frozen
+    Playing,
+    Ended       // results shown until the next round
+};
+
+struct MatchFlowConfig {
+    std::size_t minPlayers{2};
+    float countdownSec{3.f};
+    float resultsSec{5.f};
+};
+
+/// Server-side round state machine: Waiting -> Countdown -> Playing -> Ended
+/// -> Countdown ... It watches the simulation once per tick and turns phase
+/// changes and eliminations into MatchEvents for that tick; the server sends
+/// them to every peer on the reliable channel.
+///
+/// The flow never moves players itself. When update() reports a new round the
+/// caller puts every player back at its spawn; while countdown() holds the
+/// caller does not step the simulation.
+class MatchFlow {
+public:
+    explicit MatchFlow(const MatchFlowConfig& config = {});
+
+    // Advance one tick of dt seconds after the simulation stepped (or would
+    // have). Events are appended to out. Returns true when a round is starting
+    // and the caller must respawn the players.
+    bool update(const Simulation& sim, float dt, std::vector<net::MatchEvent>& out);
+
+    // A match restored from a checkpoint carries on as it was
+    void resumePlaying(const Simulation& sim);
+
+    // The event describing the current phase, for peers that join mid-match
+    net::MatchEvent currentPhase() const;
+
+    Phase phase() const { return current; }
+    bool countdown() const { return current == Phase::Countdown; }
+    std::uint32_t round() const { return roundNumber; }
+
+private:
+    MatchFlowConfig cfg;
+    Phase current{Phase::Waiting};
+    float phaseTime{0.f};  // seconds left in Countdown/Ended
+    std::uint32_t announced{0};  // last whole countdown second sent
+    std::uint32_t roundNumber{0};
+    std::uint32_t winner{0};
+    std::vector<std::uint32_t> aliveBySlot;  // player id if alive last tick, else 0
+
+    void enter(Phase phase, std::vector<net::MatchEvent>& out);
+    void trackAlive(const Simulation& sim, std::vector<net::MatchEvent>* out);
+};
+
+} // namespace match
@@ -0,0 +1,147 @@
+#include "ClientPrediction.h"
+#include "core/Profiler.h"
+#include "utils/VectorMath.h"
+
+#include <cmath>
+
+namespace prediction {
+
+namespace {
+// Sequences wrap; a is at or before b
+bool notAfter(std::uint32_t a, std::uint32_t b) {
+    return static_cast<std::int32_t>(a - b) <= 0;
+}
+}
+
+ClientPrediction::ClientPrediction(const PredictionConfig& config) : cfg(config) {}
+
+void ClientPrediction::reset(std::uint32_t localPlayerId) {
+    localId = localPlayerId;
+    head = 0;
+    count = 0;
+    stale.clear();
+    sim.forEachPlayer([&](const SimPlayer& p) { stale.push_back(p.id); });
+    for (std::uint32_t id : stale) sim.removePlayer(id);
+    stale.clear();
+    lastSeenTick.clear();
+    statePlayers.clear();
+    stateTick = 0;
+    haveState = false;
+    stateApplied = true;
+    haveAck = false;
+    displayError = {0.f, 0.f};
+    lastError = 0.f;
+    correctionCount = 0;
+}
+
+const SimPlayer* ClientPrediction::localPlayer() const {
+    return sim.playerAt(sim.slotOf(localId));
+}
+
+void ClientPrediction::step(const net::InputCommand& cmd, bool frozen) {
+    if (count == MAX_PENDING) {
+        // No ack for ~2 s: forget the oldest rather than stop predicting
+        head = (head + 1) % MAX_PENDING;
+        --count;
+    }
+    const Vec2 dir{cmd.dirX, cmd.dirY};
+    pending[(head + count) % MAX_PENDING] = Pending{cmd.sequence, dir, !frozen};
+    ++count;
+
+    sim.applyInput(localId, dir);
+    if (!frozen) sim.tick(cfg.tickDt);
+}
+
+void ClientPrediction::onState(const net::StateView& state) {
+    // Unreliable snapshots arrive in order, but never step back to an older one
+    if (haveState && static_cast<std::int32_t>(state.tick - stateTick) < 0) return;
+    state.players.copyTo(statePlayers);
+    stateTick = state.tick;
+    // The arena is not predicted: take it as soon as it arrives, ack or not
+    sim.setArenaRadius(state.arenaRadius);
+    sim.restoreArena(sim.getArenaAge(), state.arenaRadius);
+    haveState = true;
+    stateApplied = false;
+    // The ack normally follows its snapshot; this one came first
+    if (haveAck && latestAck.tick == stateTick) {
+        reconcile(latestAck.sequence);
+        stateApplied = true;
+    }
+}
+
+void ClientPrediction::onInputAck(const net::InputAck& ack) {
+    if (!haveAck || static_cast<std::int32_t>(ack.tick - latestAck.tick) > 0) {
+        latestAck = ack;
+        haveAck = true;
+    }
+    // The snapshot pairs with the newest ack at or before its tick. An ack for a later
+    // tick waits for its own snapshot (this one's ack was lost or is behind it).
+    if (!haveState || stateApplied || static_cast<std::int32_t>(ack.tick - stateTick) > 0) return;
+    reconcile(ack.sequence);
+    stateApplied = true;
+}
+
+void ClientPrediction::reconcile(std::uint32_t ackedSequence) {
+    PROFILE_SCOPE("ClientPrediction::reconcile");
+    while (count > 0 && notAfter(pending[head].sequence, ackedSequence)) {
+        head = (head + 1) % MAX_PENDING;
+        --count;
+    }
+
+    const SimPlayer* me = localPlayer();
+    const bool hadLocal = me && me->alive;
+    const Vec2 predicted = hadLocal ? me->position : Vec2{0.f, 0.f};
+
+    // Rewind: the world as the server had it at the snapshot tick
+    for (const net::PlayerState& ps : statePlayers) {
+        SimPlayer p;
+        p.id = ps.playerId;
+        p.position = {ps.x, ps.y};
+        p.velocity = {ps.vx, ps.vy};
+        p.alive = ps.alive != 0;
+        if (const SimPlayer* existing = sim.playerAt(sim.slotOf(ps.playerId))) {
+            p.inputDir = existing->inputDir;
+            p.collisions = existing->collisions;
+        }
+        sim.restorePlayer(p);
+        lastSeenTick[ps.playerId] = stateTick;
+    }
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        auto seen = lastSeenTick.find(p.id);
+        if (seen == lastSeenTick.end() || stateTick - seen->second > cfg.staleTicks) stale.push_back(p.id);
+    });
+    for (std::uint32_t id : stale) {
+        sim.removePlayer(id);
+        lastSeenTick.erase(id);
+    }
+    stale.clear();
+
+    // Replay: inputs the server has not applied yet, one tick each
+    for (std::size_t i = 0; i < count; ++i) {
+        const Pending& input = pending[(head + i) % MAX_PENDING];
+        sim.applyInput(localId, input.dir);
+        if (input.ticked) sim.tick(cfg.tickDt);
+    }
+
+    me = localPlayer();
+    if (!hadLocal || !me || !me->alive) {
+        displayError = {0.f, 0.f};
+        return;
+    }
+    const Vec2 error = predicted - me->position;
+    lastError = VectorMath::magnitude(error);
+    if (lastError > 0.5f) ++correctionCount;
+    // Keep drawing the ball where it was and blend toward the corrected path
+    displayError += error;
+    if (VectorMath::magnitude(displayError) > cfg.snapDistance) displayError = {0.f, 0.f};
+}
+
+void ClientPrediction::decayCorrection(float dt) {
+    displayError *= std::exp(-cfg.smoothingRate * dt);
+}
+
+Vec2 ClientPrediction::displayPosition(std::uint32_t playerId, Vec2 position) const {
+    return playerId == localId ? position + displayError : position;
+}
+
+} // namespace prediction
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "game/simulation/Simulation.h"
+#include "network/NetProtocol.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace prediction {
+
+struct PredictionConfig {
+    float tickDt{1.f / 60.f};     // must match the server's fixed step
+    float smoothingRate{12.f};    // 1/s: how fast a correction is blended out of the display
+    float snapDistance{120.f};    // corrections larger than this (respawns) are not smoothed
+    std::uint32_t staleTicks{120};  // players missing from snapshots this long are dropped
+};
+
+/// Client side of an authoritative match: the local player is simulated ahead
+/// of the server with its own inputs, so input shows on screen immediately.
+///
+/// Every step applies one sequenced input and ticks a local Simulation. The
+/// server sends each snapshot and its InputAck separately; once a snapshot and
+/// the newest ack at or before its tick are both in, the world is reset to the
+/// snapshot, inputs the server already applied are dropped, and the rest are
+/// replayed on top. The jump between the old and new prediction is kept as a
+/// display offset that decays over a few frames instead of teleporting the ball.
+class ClientPrediction {
+public:
+    static constexpr std::size_t MAX_PENDING = 128;  // ~2 s of unacknowledged inputs at 60 Hz
+
+    explicit ClientPrediction(const PredictionConfig& config = {});
+
+    void reset(std::uint32_t localPlayerId);
+
+    // One fixed step with the local input; cmd.sequence comes from InputHistory.
+    // While frozen (match countdown) the server holds every ball still, so the
+    // input is applied but the world does not move.
+    void step(const net::InputCommand& cmd, bool frozen = false);
+
+    // Snapshots may carry only some players; entries merge by id. The arena applies immediately.
+    void onState(const net::StateView& state);
+    void onInputAck(const net::InputAck& ack);
+
+    // Blend pending corrections out of the display; call once per rendered frame
+    void decayCorrection(float dt);
+
+    const Simulation& world() const { return sim; }
+    bool hasState() const { return haveState; }
+    std::uint32_t localPlayerId() const { return localId; }
+    // Where to draw a player: the prediction, plus the not yet blended correction for the local ball
+    Vec2 displayPosition(std::uint32_t playerId, Vec2 position) const;
+
+    std::size_t pendingInputs() const { return count; }
+    std::uint32_t serverTick() const { return stateTick; }
+    std::uint64_t corrections() const { return correctionCount; }
+    float lastCorrection() const { return lastError; }
+
+private:
+    struct Pending {
+        std::uint32_t sequence{0};
+        Vec2 dir{0.f, 0.f};
+        bool ticked{true};
+    };
+
+    PredictionConfig cfg;
+    Simulation sim;
+    std::uint32_t localId{0};
+
+    std::array<Pending, MAX_PENDING> pending{};
+    std::size_t head{0};  // oldest
+    std::size_t count{0};
+
+    // Latest snapshot, held until its ack arrives
+    std::vector<net::PlayerState> statePlayers;
+    std::uint32_t stateTick{0};
+    bool haveState{false};
+    bool stateApplied{true};
+    net::InputAck latestAck;
+    bool haveAck{false};
+    std::unordered_map<std::uint32_t, std::uint32_t> lastSeenTick;
+    std::vector<std::uint32_t> stale;
+
+    Vec2 displayError{0.f, 0.f};
+    float lastError{0.f};
+    std::uint64_t correctionCount{0};
+
+    void reconcile(std::uint32_t ackedSequence);
+    const SimPlayer* localPlayer() const;
+};
+
+} // namespace prediction
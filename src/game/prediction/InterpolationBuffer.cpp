@@ -0,0 +1,179 @@
+#include "InterpolationBuffer.h"
+#include "core/Profiler.h"
+#include "utils/VectorMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace prediction {
+
+namespace {
+constexpr double kJitterGain = 1.0 / 16.0;    // RFC 3550 interarrival jitter
+constexpr double kIntervalGain = 1.0 / 8.0;
+
+// Cubic Hermite segment from (p0, v0) to (p1, v1) over h seconds, at u in [0, 1]
+void hermite(Vec2 p0, Vec2 v0, Vec2 p1, Vec2 v1, float h, float u, Vec2& position, Vec2& velocity) {
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+    position = p0 * (2.f * u3 - 3.f * u2 + 1.f) + v0 * (h * (u3 - 2.f * u2 + u)) +
+               p1 * (3.f * u2 - 2.f * u3) + v1 * (h * (u3 - u2));
+    velocity = (p0 - p1) * ((6.f * u2 - 6.f * u) / h) + v0 * (3.f * u2 - 4.f * u + 1.f) + v1 * (3.f * u2 - 2.f * u);
+}
+}
+
+InterpolationBuffer::InterpolationBuffer(const InterpolationConfig& config) : cfg(config) {
+    clear();
+}
+
+void InterpolationBuffer::clear() {
+    tracks.clear();
+    trackById.clear();
+    output.clear();
+    started = false;
+    lastServerRaw = 0;
+    newestServer = 0.0;
+    interval = 0.0;
+    transitNext = 0;
+    transitCount = 0;
+    lastTransit = 0.0;
+    fastestTransit = 0.0;
+    jitter = 0.0;
+    delay = cfg.initialDelayMs;
+    renderTime = 0.0;
+    extrapolations = 0;
+}
+
+float InterpolationBuffer::targetDelayMs() const {
+    const double target = interval + cfg.jitterScale * jitter;
+    return static_cast<float>(std::clamp(target, static_cast<double>(cfg.minDelayMs),
+                                         static_cast<double>(cfg.maxDelayMs)));
+}
+
+void InterpolationBuffer::addTransit(double transit) {
+    if (transitCount > 0) {
+        jitter += (std::abs(transit - lastTransit) - jitter) * kJitterGain;
+    }
+    lastTransit = transit;
+    transits[transitNext] = transit;
+    transitNext = (transitNext + 1) % TRANSIT_WINDOW;
+    transitCount = std::min(transitCount + 1, TRANSIT_WINDOW);
+    // The fastest recent path: every later arrival is that plus queueing
+    fastestTransit = *std::min_element(transits.begin(), transits.begin() + transitCount);
+}
+
+void InterpolationBuffer::push(const net::StateView& state, std::uint32_t arrivalMs) {
+    double serverMs = state.serverTimeMs;
+    if (started) {
+        const std::int32_t step = static_cast<std::int32_t>(state.serverTimeMs - lastServerRaw);
+        // Snapshots are unsequenced on the wire; a late or duplicate one adds nothing
+        if (step <= 0) return;
+        serverMs = newestServer + step;
+        interval = interval > 0.0 ? interval + (step - interval) * kIntervalGain : step;
+    }
+    lastServerRaw = state.serverTimeMs;
+    newestServer = serverMs;
+    addTransit(static_cast<double>(static_cast<std::int32_t>(arrivalMs - state.serverTimeMs)));
+    if (!started) {
+        renderTime = serverMs - delay;
+        started = true;
+    }
+
+    for (std::size_t i = 0; i < state.players.size(); ++i) {
+        const net::PlayerState ps = state.players[i];
+        auto [it, added] = trackById.try_emplace(ps.playerId, tracks.size());
+        if (added) {
+            tracks.emplace_back();
+            tracks.back().id = ps.playerId;
+        }
+        Track& track = tracks[it->second];
+        track.newest = track.count == 0 ? 0 : (track.newest + 1) % TRACK_SAMPLES;
+        track.count = std::min(track.count + 1, TRACK_SAMPLES);
+        track.samples[track.newest] = Sample{serverMs, {ps.x, ps.y}, {ps.vx, ps.vy}, ps.alive != 0};
+    }
+    dropStale();
+}
+
+void InterpolationBuffer::dropStale() {
+    for (std::size_t i = 0; i < tracks.size();) {
+        if (newestServer - tracks[i].back(0).timeMs <= cfg.staleMs) {
+            ++i;
+            continue;
+        }
+        trackById.erase(tracks[i].id);
+        if (i + 1 != tracks.size()) {
+            tracks[i] = tracks.back();
+            trackById[tracks[i].id] = i;
+        }
+        tracks.pop_back();
+    }
+}
+
+void InterpolationBuffer::update(std::uint32_t localNowMs, float dt) {
+    PROFILE_SCOPE("InterpolationBuffer::update");
+    output.clear();
+    if (!started) return;
+
+    // Ease toward the delay the measured jitter calls for: up fast, down slowly
+    const double target = targetDelayMs();
+    const double rate = target > delay ? cfg.growRate : cfg.shrinkRate;
+    delay += (target - delay) * std::min(1.0, rate * dt);
+
+    // Server time that reached us fastest-path at localNow, minus the delay.
+    // Never runs backwards: a growing delay slows playback down instead of rewinding it.
+    const double wanted = static_cast<double>(static_cast<std::int32_t>(localNowMs - lastServerRaw)) -
+                          fastestTransit + newestServer - delay;
+    renderTime = std::max(renderTime, wanted);
+
+    bool anyExtrapolated = false;
+    output.reserve(tracks.size());
+    for (const Track& track : tracks) {
+        InterpolatedPlayer& out = output.emplace_back();
+        sample(track, out);
+        anyExtrapolated |= out.extrapolated;
+    }
+    if (anyExtrapolated) ++extrapolations;
+}
+
+void InterpolationBuffer::sample(const Track& track, InterpolatedPlayer& out) const {
+    out.id = track.id;
+
+    // Newest sample at or before the render time
+    std::size_t age = 0;
+    while (age < track.count && track.back(age).timeMs > renderTime) ++age;
+    if (age == track.count) {
+        // Render time is before anything we hold for this player (just joined)
+        const Sample& oldest = track.back(track.count - 1);
+        out.position = oldest.position;
+        out.velocity = oldest.velocity;
+        out.alive = oldest.alive;
+        return;
+    }
+
+    const Sample& a = track.back(age);
+    if (age == 0) {
+        // Ran past the newest data: coast along the last velocity for a bounded time, then hold
+        const double overshoot = renderTime - a.timeMs;
+        const float ahead = static_cast<float>(std::min<double>(overshoot, cfg.maxExtrapolationMs)) * 0.001f;
+        out.position = a.alive ? a.position + a.velocity * ahead : a.position;
+        out.velocity = a.velocity;
+        out.alive = a.alive;
+        out.extrapolated = a.alive && overshoot > 0.0;
+        return;
+    }
+
+    const Sample& b = track.back(age - 1);
+    const float h = static_cast<float>(b.timeMs - a.timeMs) * 0.001f;
+    const float u = static_cast<float>((renderTime - a.timeMs) / (b.timeMs - a.timeMs));
+    const bool jumped = VectorMath::magnitude(b.position - a.position) > cfg.teleportSpeed * h;
+    if (!a.alive || !b.alive || jumped) {
+        // Eliminations and respawns are discrete: show one side, never a blend
+        out.position = a.position;
+        out.velocity = a.velocity;
+        out.alive = a.alive;
+        return;
+    }
+    hermite(a.position, a.velocity, b.position, b.velocity, h, u, out.position, out.velocity);
+    out.alive = true;
+}
+
+} // namespace prediction
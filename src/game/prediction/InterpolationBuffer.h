@@ -0,0 +1,113 @@
+#pragma once
+
+#include "network/NetProtocol.h"
+#include "utils/GameConstants.h"
+#include "utils/VectorMath.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace prediction {
+
+struct InterpolationConfig {
+    float initialDelayMs{GameConstants::SNAPSHOT_INTERP_DELAY};
+    float minDelayMs{20.f};
+    float maxDelayMs{400.f};
+    float jitterScale{3.f};         // target delay = snapshot interval + jitterScale * jitter
+    float shrinkRate{GameConstants::INTERP_DELAY_SHRINK_PER_SEC};  // 1/s: delay eases down toward its target...
+    float growRate{4.f};            // ...and grows quickly after late packets
+    float maxExtrapolationMs{150.f};
+    float teleportSpeed{1200.f};    // units/s between samples beyond which a ball jumped (respawn)
+    float staleMs{2000.f};          // players missing from snapshots this long are dropped
+};
+
+struct InterpolatedPlayer {
+    std::uint32_t id{0};
+    Vec2 position{0.f, 0.f};
+    Vec2 velocity{0.f, 0.f};
+    bool alive{true};
+    bool extrapolated{false};
+};
+
+/// Smooth playback of remote players from unreliable snapshots.
+///
+/// Samples are kept per player (snapshots may carry only some of them) and
+/// rendered at a point in server time a little behind the newest data, so
+/// there is almost always a sample on either side to interpolate between.
+/// Positions follow a cubic Hermite curve through both samples' positions and
+/// velocities, which keeps curved paths curved at low snapshot rates.
+///
+/// The delay is measured, not fixed: each arrival's transit (local arrival
+/// minus server send time) gives the fastest path seen recently and the jitter
+/// around it, and the delay covers one snapshot interval plus a multiple of
+/// that jitter. Clocks never need to agree, and a relay's broadcast delay is
+/// absorbed the same way. When data runs out anyway, players are extrapolated
+/// along their velocity for a bounded time and then held.
+class InterpolationBuffer {
+public:
+    static constexpr std::size_t TRACK_SAMPLES = 16;
+    static constexpr std::size_t TRANSIT_WINDOW = 64;
+
+    explicit InterpolationBuffer(const InterpolationConfig& config = {});
+
+    void clear();
+
+    // A State that arrived at arrivalMs on the local clock (NetArrival::arrivalMs)
+    void push(const net::StateView& state, std::uint32_t arrivalMs);
+
+    // Advance playback to localNowMs (same clock as arrivals) and sample every player
+    void update(std::uint32_t localNowMs, float dt);
+
+    const std::vector<InterpolatedPlayer>& players() const { return output; }
+    bool empty() const { return tracks.empty(); }
+
+    double renderTimeMs() const { return renderTime; }  // server clock
+    float delayMs() const { return static_cast<float>(delay); }
+    float targetDelayMs() const;
+    float jitterMs() const { return static_cast<float>(jitter); }
+    float intervalMs() const { return static_cast<float>(interval); }
+    std::uint64_t extrapolatedFrames() const { return extrapolations; }
+
+private:
+    struct Sample {
+        double timeMs{0.0};
+        Vec2 position{0.f, 0.f};
+        Vec2 velocity{0.f, 0.f};
+        bool alive{true};
+    };
+    struct Track {
+        std::uint32_t id{0};
+        std::array<Sample, TRACK_SAMPLES> samples{};
+        std::size_t newest{0};
+        std::size_t count{0};
+
+        const Sample& back(std::size_t age) const { return samples[(newest + TRACK_SAMPLES - age) % TRACK_SAMPLES]; }
+    };
+
+    InterpolationConfig cfg;
+    std::vector<Track> tracks;
+    std::unordered_map<std::uint32_t, std::size_t> trackById;
+    std::vector<InterpolatedPlayer> output;
+
+    bool started{false};
+    std::uint32_t lastServerRaw{0};
+    double newestServer{0.0};  // unwrapped server clock of the newest snapshot
+    double interval{0.0};
+    std::array<double, TRANSIT_WINDOW> transits{};
+    std::size_t transitNext{0};
+    std::size_t transitCount{0};
+    double lastTransit{0.0};
+    double fastestTransit{0.0};
+    double jitter{0.0};
+    double delay{0.0};
+    double renderTime{0.0};
+    std::uint64_t extrapolations{0};
+
+    void addTransit(double transit);
+    void sample(const Track& track, InterpolatedPlayer& out) const;
+    void dropStale();
+};
+
+} // namespace prediction
@@ -0,0 +1,139 @@
+#include "FrameCoder.h"
+#include "game/simulation/Simulation.h"
+
+namespace replay {
+
+namespace {
+enum Field : std::size_t { VelX = 0, VelY, PosX, PosY };
+
+// Residual magnitude class used as context for the next player's same field
+std::size_t residualClass(std::int32_t r) {
+    if (r == 0) return 0;
+    return (r >= -3 && r <= 3) ? 1 : 2;
+}
+
+// Wrapping add: corrupt input must not overflow into undefined behaviour
+std::int32_t addResidual(std::int32_t base, std::int32_t r) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(r));
+}
+}
+
+std::uint32_t captureFrame(const Simulation& sim, std::uint32_t tick, ReplayFrame& out) {
+    out.tick = tick;
+    std::uint32_t n = 0;
+    std::uint32_t left = 0;
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        if (n >= MAX_PLAYERS) {
+            ++left;
+            return;
+        }
+        ReplayPlayer& rp = out.players[n++];
+        rp.id = p.id;
+        rp.x = quantize(p.position.x, POSITION_SCALE);
+        rp.y = quantize(p.position.y, POSITION_SCALE);
+        rp.vx = quantize(p.velocity.x, VELOCITY_SCALE);
+        rp.vy = quantize(p.velocity.y, VELOCITY_SCALE);
+        rp.alive = p.alive ? 1 : 0;
+    });
+    out.count = n;
+    return left;
+}
+
+FrameCoder::FrameCoder(std::uint32_t tickRate) : tickRate(tickRate == 0 ? 60 : tickRate) {}
+
+void FrameCoder::reset() {
+    residuals.reset();
+    sameId = rc::BitModel{};
+    alive[0] = rc::BitModel{};
+    alive[1] = rc::BitModel{};
+}
+
+std::int32_t FrameCoder::predictPosition(std::int32_t pos, std::int32_t vel, std::uint32_t ticks) const {
+    // Semi-implicit Euler: positions move by the new velocity over the elapsed ticks
+    const std::int64_t num = static_cast<std::int64_t>(vel) * ticks * static_cast<std::int64_t>(POSITION_SCALE);
+    const std::int64_t den = static_cast<std::int64_t>(tickRate) * static_cast<std::int64_t>(VELOCITY_SCALE);
+    const std::int64_t step = num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+    return static_cast<std::int32_t>(pos + step);
+}
+
+bool FrameCoder::encode(const ReplayFrame& ref, const ReplayFrame& cur, std::uint8_t* out, std::size_t capacity,
+                        std::size_t& size) {
+    size = 0;
+    const std::uint32_t ticks = cur.tick - ref.tick;
+    if (ticks == 0 || ticks > MAX_TICK_GAP) return false;
+    rc::RangeEncoder enc(out, capacity);
+    residuals.encode(enc, static_cast<std::int32_t>(ticks) - 1, TickContext);
+    residuals.encode(enc, static_cast<std::int32_t>(cur.count) - static_cast<std::int32_t>(ref.count), CountContext);
+
+    std::size_t classes[FIELDS] = {};
+    for (std::uint32_t i = 0; i < cur.count; ++i) {
+        const ReplayPlayer& p = cur.players[i];
+        const bool known = i < ref.count && ref.players[i].id == p.id;
+        if (i < ref.count) enc.encodeBit(sameId, known);
+        if (!known) {
+            enc.encodeDirect(p.id, 32);
+            enc.encodeBit(alive[0], p.alive);
+            residuals.encode(enc, p.vx, FreshContext);
+            residuals.encode(enc, p.vy, FreshContext);
+            residuals.encode(enc, p.x, FreshContext);
+            residuals.encode(enc, p.y, FreshContext);
+            continue;
+        }
+
+        const ReplayPlayer& base = ref.players[i];
+        enc.encodeBit(alive[base.alive ? 1 : 0], p.alive);
+        const std::int32_t r[FIELDS] = {
+            p.vx - base.vx,
+            p.vy - base.vy,
+            p.x - predictPosition(base.x, p.vx, ticks),
+            p.y - predictPosition(base.y, p.vy, ticks),
+        };
+        for (std::size_t f = 0; f < FIELDS; ++f) {
+            residuals.encode(enc, r[f], FieldContexts + f * 3 + classes[f]);
+            classes[f] = residualClass(r[f]);
+        }
+    }
+
+    size = enc.finish();
+    return !enc.overflow();
+}
+
+bool FrameCoder::decode(const ReplayFrame& ref, const std::uint8_t* data, std::size_t size, ReplayFrame& out) {
+    rc::RangeDecoder dec(data, size);
+    const std::int64_t ticks = static_cast<std::int64_t>(residuals.decode(dec, TickContext)) + 1;
+    const std::int64_t count = static_cast<std::int64_t>(ref.count) + residuals.decode(dec, CountContext);
+    if (ticks <= 0 || ticks > MAX_TICK_GAP || count < 0 || count > static_cast<std::int64_t>(MAX_PLAYERS)) return false;
+    out.tick = ref.tick + static_cast<std::uint32_t>(ticks);
+    out.count = static_cast<std::uint32_t>(count);
+
+    std::size_t classes[FIELDS] = {};
+    for (std::uint32_t i = 0; i < out.count; ++i) {
+        ReplayPlayer& p = out.players[i];
+        const bool known = i < ref.count && dec.decodeBit(sameId) != 0;
+        if (!known) {
+            p.id = dec.decodeDirect(32);
+            p.alive = static_cast<std::uint8_t>(dec.decodeBit(alive[0]));
+            p.vx = residuals.decode(dec, FreshContext);
+            p.vy = residuals.decode(dec, FreshContext);
+            p.x = residuals.decode(dec, FreshContext);
+            p.y = residuals.decode(dec, FreshContext);
+            continue;
+        }
+
+        const ReplayPlayer& base = ref.players[i];
+        p.id = base.id;
+        p.alive = static_cast<std::uint8_t>(dec.decodeBit(alive[base.alive ? 1 : 0]));
+        std::int32_t r[FIELDS];
+        for (std::size_t f = 0; f < FIELDS; ++f) {
+            r[f] = residuals.decode(dec, FieldContexts + f * 3 + classes[f]);
+            classes[f] = residualClass(r[f]);
+        }
+        p.vx = addResidual(base.vx, r[VelX]);
+        p.vy = addResidual(base.vy, r[VelY]);
+        p.x = addResidual(predictPosition(base.x, p.vx, static_cast<std::uint32_t>(ticks)), r[PosX]);
+        p.y = addResidual(predictPosition(base.y, p.vy, static_cast<std::uint32_t>(ticks)), r[PosY]);
+    }
+    return true;
+}
+
+} // namespace replay
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ReplayFormat.h"
+#include "utils/RangeCoder.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class Simulation;
+
+namespace replay {
+
+/// Quantize the simulation's players (slot order, at most MAX_PLAYERS) into out;
+/// returns how many players did not fit
+std::uint32_t captureFrame(const Simulation& sim, std::uint32_t tick, ReplayFrame& out);
+
+/// Entropy-coded frame deltas for replays.
+///
+/// A frame is coded against the previous replay frame. Velocities are predicted
+/// unchanged, positions are predicted to follow the new velocity over the elapsed
+/// ticks, and only the residuals go through the range coder. Each residual is coded
+/// with a context picked by its field and by how far off the same field was
+/// for the previous player, so a frame of coasting players costs a few bits each.
+///
+/// Models keep adapting across frames until reset(). Replays reset at every
+/// keyframe, since readers always decode forward from one.
+class FrameCoder {
+public:
+    // Generous bound for MAX_PLAYERS; an encode that does not fit reports failure
+    static constexpr std::size_t MAX_ENCODED_SIZE = 4096;
+    // Frames further apart than this cannot be coded against each other
+    static constexpr std::uint32_t MAX_TICK_GAP = 0xFFFF;
+
+    FrameCoder() : FrameCoder(60) {}
+    explicit FrameCoder(std::uint32_t tickRate);
+
+    void reset();
+
+    // Encode cur against ref into out. Returns false if out was too small or
+    // the tick gap is out of range; the models may then be out of step with a
+    // decoder, so the caller must reset() (replays start a keyframe).
+    bool encode(const ReplayFrame& ref, const ReplayFrame& cur, std::uint8_t* out, std::size_t capacity,
+                std::size_t& size);
+
+    // Rebuild a frame from ref and an encoded delta; out must not alias ref
+    bool decode(const ReplayFrame& ref, const std::uint8_t* data, std::size_t size, ReplayFrame& out);
+
+private:
+    enum Context : std::size_t {
+        TickContext = 0,
+        CountContext,
+        FreshContext,     // players without a reference: raw values
+        FieldContexts     // 4 fields x 3 classes of the previous player's residual
+    };
+    static constexpr std::size_t FIELDS = 4;  // vx, vy, x, y
+    static constexpr std::size_t CONTEXTS = FieldContexts + FIELDS * 3;
+
+    std::uint32_t tickRate;
+    rc::ResidualModel<CONTEXTS> residuals;
+    rc::BitModel sameId;
+    rc::BitModel alive[2];  // by the reference alive flag
+
+    std::int32_t predictPosition(std::int32_t pos, std::int32_t vel, std::uint32_t ticks) const;
+};
+
+} // namespace replay
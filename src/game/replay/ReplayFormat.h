@@ -0,0 +1,201 @@
+#pragma once
+
+#include "network/WireFormat.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// Sumo Balls replay file format (.sbr)
+///
+///   [ReplayHeader]                       fixed 32 bytes
+///   [record]*                            type u8, payload length varint, payload
+///   [index entry]*                       tick u32, file offset u64 (one per keyframe)
+///   [ReplayTrailer]                      fixed 16 bytes at end of file
+///
+/// Keyframes hold the full quantized state, coded deltas hold the range-coded
+/// residuals of every player against the previous frame (see FrameCoder; its
+/// models reset at each keyframe), and events mark joins/leaves/eliminations.
+/// The trailing keyframe index is sorted by tick so readers can binary search it.
+/// All multi-byte values are little-endian: the fixed parts are written through
+/// net::wire layouts (declared at the end of this file), never as host structs.
+namespace replay {
+
+constexpr std::uint32_t FILE_MAGIC = 0x50524253;    // "SBRP"
+constexpr std::uint32_t INDEX_MAGIC = 0x49524253;   // "SBRI"
+constexpr std::uint16_t FORMAT_VERSION = 2;
+
+constexpr std::size_t MAX_PLAYERS = 32;
+constexpr float POSITION_SCALE = 16.f;  // 1/16 px precision
+constexpr float VELOCITY_SCALE = 16.f;  // 1/16 px/s precision
+
+enum class RecordType : std::uint8_t {
+    Keyframe = 1,
+    // 2 is reserved (plain varint deltas, never shipped)
+    Event = 3,
+    CodedDelta = 4   // FrameCoder residuals against the previous frame
+};
+
+enum class EventType : std::uint8_t {
+    PlayerJoined = 1,
+    PlayerLeft = 2,
+    PlayerEliminated = 3
+};
+
+struct ReplayHeader {
+    std::uint32_t magic{FILE_MAGIC};
+    std::uint16_t version{FORMAT_VERSION};
+    std::uint16_t flags{0};
+    std::uint16_t tickRate{60};
+    std::uint16_t keyframeInterval{120};
+    float arenaRadius{0.f};
+    float arenaCenterX{0.f};
+    float arenaCenterY{0.f};
+    std::uint64_t startUnixMs{0};
+};
+
+struct ReplayTrailer {
+    std::uint64_t indexOffset{0};
+    std::uint32_t keyframeCount{0};
+    std::uint32_t magic{INDEX_MAGIC};
+};
+
+struct IndexEntry {
+    std::uint32_t tick{0};
+    std::uint64_t offset{0};
+};
+
+/// One player in quantized replay space
+struct ReplayPlayer {
+    std::uint32_t id{0};
+    std::int32_t x{0};
+    std::int32_t y{0};
+    std::int32_t vx{0};
+    std::int32_t vy{0};
+    std::uint8_t alive{1};
+
+    float posX() const { return static_cast<float>(x) / POSITION_SCALE; }
+    float posY() const { return static_cast<float>(y) / POSITION_SCALE; }
+    float velX() const { return static_cast<float>(vx) / VELOCITY_SCALE; }
+    float velY() const { return static_cast<float>(vy) / VELOCITY_SCALE; }
+};
+
+/// Full state of every recorded player at one tick
+struct ReplayFrame {
+    std::uint32_t tick{0};
+    std::uint32_t count{0};
+    std::array<ReplayPlayer, MAX_PLAYERS> players{};
+
+    const ReplayPlayer* find(std::uint32_t id) const {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            if (players[i].id == id) return &players[i];
+        }
+        return nullptr;
+    }
+};
+
+struct ReplayEvent {
+    std::uint32_t tick{0};
+    EventType type{EventType::PlayerJoined};
+    std::uint32_t playerId{0};
+};
+
+inline std::int32_t quantize(float v, float scale) {
+    return static_cast<std::int32_t>(std::lround(v * scale));
+}
+
+// === Byte encoding helpers ===
+
+inline void putU32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    const std::size_t at = out.size();
+    out.resize(at + sizeof(v));
+    net::wire::store(out.data() + at, v);
+}
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+inline void putSigned(std::vector<std::uint8_t>& out, std::int64_t v) {
+    // Zigzag so small negative deltas stay one byte
+    putVarint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+/// Bounds-checked cursor over a read-only byte range
+struct ByteReader {
+    const std::uint8_t* data{nullptr};
+    std::size_t size{0};
+    std::size_t pos{0};
+    bool ok{true};
+
+    bool readBytes(void* out, std::size_t len) {
+        if (!ok || size - pos < len) { ok = false; return false; }
+        std::memcpy(out, data + pos, len);
+        pos += len;
+        return true;
+    }
+
+    std::uint8_t readU8() {
+        std::uint8_t v = 0;
+        readBytes(&v, 1);
+        return v;
+    }
+
+    std::uint32_t readU32() {
+        std::uint8_t bytes[sizeof(std::uint32_t)] = {};
+        std::uint32_t v = 0;
+        if (readBytes(bytes, sizeof(bytes))) net::wire::load(bytes, v);
+        return v;
+    }
+
+    std::uint64_t readVarint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!ok || pos >= size) { ok = false; return 0; }
+            std::uint8_t b = data[pos++];
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t readSigned() {
+        std::uint64_t z = readVarint();
+        return static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+    }
+};
+
+} // namespace replay
+
+// On-disk layouts, in file order. Changing one is a format change: bump FORMAT_VERSION.
+namespace net::wire {
+template <> struct Wire<replay::ReplayHeader> {
+    using Layout = Fields<&replay::ReplayHeader::magic, &replay::ReplayHeader::version, &replay::ReplayHeader::flags,
+                          &replay::ReplayHeader::tickRate, &replay::ReplayHeader::keyframeInterval,
+                          &replay::ReplayHeader::arenaRadius, &replay::ReplayHeader::arenaCenterX,
+                          &replay::ReplayHeader::arenaCenterY, &replay::ReplayHeader::startUnixMs>;
+};
+template <> struct Wire<replay::ReplayTrailer> {
+    using Layout = Fields<&replay::ReplayTrailer::indexOffset, &replay::ReplayTrailer::keyframeCount,
+                          &replay::ReplayTrailer::magic>;
+};
+template <> struct Wire<replay::IndexEntry> {
+    using Layout = Fields<&replay::IndexEntry::tick, &replay::IndexEntry::offset>;
+};
+} // namespace net::wire
+
+namespace replay {
+constexpr std::size_t HEADER_SIZE = net::wire::size<ReplayHeader>;
+constexpr std::size_t TRAILER_SIZE = net::wire::size<ReplayTrailer>;
+constexpr std::size_t INDEX_ENTRY_SIZE = net::wire::size<IndexEntry>;
+static_assert(HEADER_SIZE == 32, "ReplayHeader must stay 32 bytes on disk");
+static_assert(TRAILER_SIZE == 16, "ReplayTrailer must stay 16 bytes on disk");
+static_assert(INDEX_ENTRY_SIZE == 12, "Index entries are a u32 tick and a u64 offset");
+} // namespace replay
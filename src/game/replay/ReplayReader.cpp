@@ -0,0 +1,152 @@
+#include "ReplayReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iostream>
+
+namespace replay {
+
+ReplayReader::~ReplayReader() { close(); }
+
+bool ReplayReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[Replay Error] Failed to open replay: " << path << std::endl;
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < HEADER_SIZE + TRAILER_SIZE) {
+        std::cerr << "[Replay Error] Replay too small or unreadable: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<std::size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "[Replay Error] mmap failed for replay: " << path << std::endl;
+        size = 0;
+        return false;
+    }
+    base = static_cast<const std::uint8_t*>(mapped);
+
+    net::wire::decode(base, fileHeader);
+    net::wire::decode(base + size - TRAILER_SIZE, trailer);
+    // Each bound is checked on its own: summing offsets from the file could wrap
+    const std::uint64_t indexBytes = static_cast<std::uint64_t>(trailer.keyframeCount) * INDEX_ENTRY_SIZE;
+    if (fileHeader.magic != FILE_MAGIC || fileHeader.version != FORMAT_VERSION ||
+        trailer.magic != INDEX_MAGIC || trailer.indexOffset < HEADER_SIZE ||
+        trailer.indexOffset > size - TRAILER_SIZE || indexBytes != size - TRAILER_SIZE - trailer.indexOffset) {
+        std::cerr << "[Replay Error] Invalid or truncated replay: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ReplayReader::close() {
+    if (base) {
+        munmap(const_cast<std::uint8_t*>(base), size);
+        base = nullptr;
+    }
+    size = 0;
+    fileHeader = ReplayHeader{};
+    trailer = ReplayTrailer{};
+}
+
+IndexEntry ReplayReader::keyframe(std::size_t i) const {
+    IndexEntry entry;
+    net::wire::decode(base + trailer.indexOffset + i * INDEX_ENTRY_SIZE, entry);
+    return entry;
+}
+
+bool ReplayReader::seek(std::uint32_t tick, Cursor& cursor) const {
+    cursor = Cursor{};
+    if (!base || trailer.keyframeCount == 0) return false;
+
+    // Last keyframe with keyframe.tick <= tick
+    std::size_t lo = 0;
+    std::size_t hi = trailer.keyframeCount;
+    while (lo < hi) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (keyframe(mid).tick <= tick) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return false;
+
+    cursor.offset = keyframe(lo - 1).offset;
+    if (!next(cursor)) return false;
+
+    Cursor probe;
+    while (true) {
+        probe = cursor;
+        if (!next(probe) || probe.frame.tick > tick) break;
+        cursor = std::move(probe);
+    }
+    return true;
+}
+
+bool ReplayReader::next(Cursor& cursor) const {
+    cursor.events.clear();
+    if (!base) return false;
+
+    while (cursor.offset < trailer.indexOffset) {
+        ByteReader in{base, static_cast<std::size_t>(trailer.indexOffset), cursor.offset};
+        auto type = static_cast<RecordType>(in.readU8());
+        std::uint64_t len = in.readVarint();
+        if (!in.ok || len > trailer.indexOffset - in.pos) return false;
+
+        ByteReader body{base + in.pos, static_cast<std::size_t>(len)};
+        cursor.offset = in.pos + len;
+        if (!applyRecord(type, body, cursor)) return false;
+        if (type == RecordType::Keyframe || type == RecordType::CodedDelta) {
+            cursor.valid = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReplayReader::applyRecord(RecordType type, ByteReader& in, Cursor& cursor) const {
+    ReplayFrame& frame = cursor.frame;
+    switch (type) {
+        case RecordType::Keyframe: {
+            frame.tick = in.readU32();
+            std::uint64_t count = in.readVarint();
+            if (count > MAX_PLAYERS) return false;
+            frame.count = static_cast<std::uint32_t>(count);
+            for (std::uint32_t i = 0; i < frame.count; ++i) {
+                ReplayPlayer& p = frame.players[i];
+                p.id = static_cast<std::uint32_t>(in.readVarint());
+                p.x = static_cast<std::int32_t>(in.readSigned());
+                p.y = static_cast<std::int32_t>(in.readSigned());
+                p.vx = static_cast<std::int32_t>(in.readSigned());
+                p.vy = static_cast<std::int32_t>(in.readSigned());
+                p.alive = in.readU8();
+            }
+            cursor.coder = FrameCoder(fileHeader.tickRate);
+            return in.ok;
+        }
+        case RecordType::CodedDelta: {
+            if (!cursor.valid) return false;
+            const ReplayFrame ref = frame;
+            return cursor.coder.decode(ref, in.data, in.size, frame);
+        }
+        case RecordType::Event: {
+            ReplayEvent event;
+            event.tick = in.readU32();
+            event.type = static_cast<EventType>(in.readU8());
+            event.playerId = static_cast<std::uint32_t>(in.readVarint());
+            if (in.ok) cursor.events.push_back(event);
+            return in.ok;
+        }
+        default:
+            return true;  // unknown record types are skipped for forward compatibility
+    }
+}
+
+} // namespace replay
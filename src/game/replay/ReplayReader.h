@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ReplayFormat.h"
+#include "FrameCoder.h"
+
+#include <string>
+#include <vector>
+
+namespace replay {
+
+/// Read-only view of a .sbr file mapped into memory.
+/// seek() binary searches the trailing keyframe index and decodes forward from
+/// the nearest keyframe, so random access costs O(log n) plus one keyframe interval.
+class ReplayReader {
+public:
+    /// Playback position: the reconstructed frame plus events seen on the way to it
+    struct Cursor {
+        std::size_t offset{0};
+        ReplayFrame frame;
+        std::vector<ReplayEvent> events;
+        FrameCoder coder;  // models for coded deltas since the last keyframe
+        bool valid{false};
+    };
+
+    ReplayReader() = default;
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    const ReplayHeader& header() const { return fileHeader; }
+    std::size_t keyframeCount() const { return trailer.keyframeCount; }
+    IndexEntry keyframe(std::size_t i) const;
+
+    /// Position the cursor on the last recorded frame with tick <= target
+    bool seek(std::uint32_t tick, Cursor& cursor) const;
+
+    /// Decode the frame following the cursor; events in between land in cursor.events
+    bool next(Cursor& cursor) const;
+
+private:
+    const std::uint8_t* base{nullptr};
+    std::size_t size{0};
+    ReplayHeader fileHeader;
+    ReplayTrailer trailer;
+
+    bool applyRecord(RecordType type, ByteReader& in, Cursor& cursor) const;
+};
+
+} // namespace replay
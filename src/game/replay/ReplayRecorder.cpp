@@ -0,0 +1,219 @@
+#include "ReplayRecorder.h"
+#include "game/simulation/Simulation.h"
+#include "core/Profiler.h"
+
+#include <iostream>
+
+namespace replay {
+
+namespace {
+constexpr std::size_t kFileBufferSize = 64 * 1024;
+
+void encodePlayerFull(std::vector<std::uint8_t>& out, const ReplayPlayer& p) {
+    putVarint(out, p.id);
+    putSigned(out, p.x);
+    putSigned(out, p.y);
+    putSigned(out, p.vx);
+    putSigned(out, p.vy);
+    out.push_back(p.alive);
+}
+}
+
+ReplayRecorder::ReplayRecorder(std::size_t queueCapacity) : queueCapacity(queueCapacity) {}
+
+ReplayRecorder::~ReplayRecorder() {
+    finish();
+    waitFinished();
+}
+
+bool ReplayRecorder::begin(const std::string& filePath, const ReplayHeader& fileHeader) {
+    finish();
+    reapFinished();
+
+    auto writer = std::make_unique<Writer>(queueCapacity);
+    writer->file = std::fopen(filePath.c_str(), "wb");
+    if (!writer->file) {
+        std::cerr << "[Replay Error] Failed to open replay file: " << filePath << std::endl;
+        return false;
+    }
+    std::setvbuf(writer->file, nullptr, _IOFBF, kFileBufferSize);
+
+    ReplayHeader& header = writer->header;
+    header = fileHeader;
+    header.magic = FILE_MAGIC;
+    header.version = FORMAT_VERSION;
+    if (header.keyframeInterval == 0) header.keyframeInterval = 1;
+    std::uint8_t headerBytes[HEADER_SIZE];
+    net::wire::encode(headerBytes, header);
+    std::fwrite(headerBytes, sizeof(headerBytes), 1, writer->file);
+    writer->offset = HEADER_SIZE;
+    writer->coder = FrameCoder(header.tickRate);
+
+    counters = RecorderStats{};
+    path = filePath;
+    writer->thread = std::thread(&Writer::run, writer.get());
+    active = std::move(writer);
+    return true;
+}
+
+void ReplayRecorder::finish() {
+    if (!active) return;
+    // The stop goes behind everything queued; the writer drains it and exits
+    active->stopping.store(true, std::memory_order_release);
+    active->ready.release();
+    retired.push_back(std::move(active));
+    reapFinished();
+}
+
+void ReplayRecorder::waitFinished() {
+    for (auto& writer : retired) {
+        if (writer->thread.joinable()) writer->thread.join();
+    }
+    retired.clear();
+}
+
+void ReplayRecorder::reapFinished() {
+    // A done writer has returned from run(), so joining it does not wait
+    for (auto it = retired.begin(); it != retired.end();) {
+        if ((*it)->done.load(std::memory_order_acquire)) {
+            (*it)->thread.join();
+            it = retired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ReplayRecorder::recordFrame(std::uint32_t tick, const Simulation& sim) {
+    if (!active) return false;
+    std::uint32_t left = 0;
+    const bool queued = active->queue.tryPushWith([&](QueueItem& item) {
+        item.isEvent = false;
+        left = captureFrame(sim, tick, item.frame);
+    });
+    if (left > 0 && counters.framesTruncated++ == 0) {
+        std::cerr << "[Replay Warning] " << left << " players past the format's limit of " << MAX_PLAYERS
+                  << " are left out of " << path << std::endl;
+    }
+    if (queued) {
+        active->ready.release();
+        ++counters.framesQueued;
+    } else {
+        ++counters.framesDropped;
+    }
+    return queued;
+}
+
+bool ReplayRecorder::recordEvent(std::uint32_t tick, EventType type, std::uint32_t playerId) {
+    if (!active) return false;
+    const bool queued = active->queue.tryPushWith([&](QueueItem& item) {
+        item.isEvent = true;
+        item.event = ReplayEvent{tick, type, playerId};
+    });
+    if (queued) {
+        active->ready.release();
+    } else {
+        ++counters.eventsDropped;
+    }
+    return queued;
+}
+
+void ReplayRecorder::Writer::run() {
+    PROFILE_THREAD_NAME("replay-writer");
+    while (true) {
+        ready.acquire();
+        QueueItem* item = queue.front();
+        if (!item) {
+            // Only the stop is released without an entry, and it comes last
+            if (stopping.load(std::memory_order_acquire)) break;
+            continue;
+        }
+        PROFILE_SCOPE("ReplayRecorder::write");
+        if (item->isEvent) {
+            writeEvent(item->event);
+        } else {
+            writeFrame(item->frame);
+        }
+        queue.popFront();
+    }
+
+    writeIndex();
+    std::fclose(file);
+    file = nullptr;
+    done.store(true, std::memory_order_release);
+}
+
+void ReplayRecorder::Writer::writeFrame(const ReplayFrame& frame) {
+    // Eliminations are derived here, off the tick thread
+    if (havePrev) {
+        for (std::uint32_t i = 0; i < frame.count; ++i) {
+            const ReplayPlayer& cur = frame.players[i];
+            const ReplayPlayer* old = prev.find(cur.id);
+            if (old && old->alive && !cur.alive) {
+                writeEvent(ReplayEvent{frame.tick, EventType::PlayerEliminated, cur.id});
+            }
+        }
+    }
+
+    bool keyframe = !havePrev || frame.tick - lastKeyframeTick >= header.keyframeInterval;
+    if (!keyframe) {
+        payload.resize(FrameCoder::MAX_ENCODED_SIZE);
+        std::size_t size = 0;
+        if (coder.encode(prev, frame, payload.data(), payload.size(), size)) {
+            payload.resize(size);
+            writeRecord(RecordType::CodedDelta);
+        } else {
+            keyframe = true;  // restarts the models on both ends
+        }
+    }
+
+    if (keyframe) {
+        payload.clear();
+        putU32(payload, frame.tick);
+        putVarint(payload, frame.count);
+        for (std::uint32_t i = 0; i < frame.count; ++i) {
+            encodePlayerFull(payload, frame.players[i]);
+        }
+        index.push_back(IndexEntry{frame.tick, offset});
+        lastKeyframeTick = frame.tick;
+        coder.reset();
+        writeRecord(RecordType::Keyframe);
+    }
+
+    prev = frame;
+    havePrev = true;
+}
+
+void ReplayRecorder::Writer::writeEvent(const ReplayEvent& event) {
+    payload.clear();
+    putU32(payload, event.tick);
+    payload.push_back(static_cast<std::uint8_t>(event.type));
+    putVarint(payload, event.playerId);
+    writeRecord(RecordType::Event);
+}
+
+void ReplayRecorder::Writer::writeRecord(RecordType type) {
+    record.clear();
+    record.push_back(static_cast<std::uint8_t>(type));
+    putVarint(record, payload.size());
+    record.insert(record.end(), payload.begin(), payload.end());
+    std::fwrite(record.data(), 1, record.size(), file);
+    offset += record.size();
+}
+
+void ReplayRecorder::Writer::writeIndex() {
+    ReplayTrailer trailer;
+    trailer.indexOffset = offset;
+    trailer.keyframeCount = static_cast<std::uint32_t>(index.size());
+    std::uint8_t entryBytes[INDEX_ENTRY_SIZE];
+    for (const auto& entry : index) {
+        net::wire::encode(entryBytes, entry);
+        std::fwrite(entryBytes, sizeof(entryBytes), 1, file);
+    }
+    std::uint8_t trailerBytes[TRAILER_SIZE];
+    net::wire::encode(trailerBytes, trailer);
+    std::fwrite(trailerBytes, sizeof(trailerBytes), 1, file);
+    std::fflush(file);
+}
+
+} // namespace replay
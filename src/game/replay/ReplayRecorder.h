@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ReplayFormat.h"
+#include "FrameCoder.h"
+#include "utils/SpscQueue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Simulation;
+
+namespace replay {
+
+struct RecorderStats {
+    std::uint64_t framesQueued{0};
+    std::uint64_t framesDropped{0};
+    std::uint64_t eventsDropped{0};
+    std::uint64_t framesTruncated{0};  // frames missing players past MAX_PLAYERS
+};
+
+/// Streams a match to a .sbr file.
+/// The tick thread only copies state into a bounded lock-free queue; delta
+/// encoding (range-coded residuals between keyframes) and file I/O happen on a
+/// dedicated writer thread, woken by a semaphore per queued entry. When the
+/// queue is full the frame is dropped and counted instead of stalling the tick.
+///
+/// finish() does not wait either: it posts a stop behind the queued entries,
+/// and the writer flushes the rest, writes the index and exits on its own.
+/// Finished writers are joined once done (by later begin()/finish() calls), or
+/// waited for by waitFinished() and the destructor.
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(std::size_t queueCapacity = 256);
+    ~ReplayRecorder();
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    bool begin(const std::string& path, const ReplayHeader& header);
+    void finish();
+    // Block until every finished recording is complete on disk
+    void waitFinished();
+    bool isRecording() const { return active != nullptr; }
+    const std::string& currentPath() const { return path; }
+
+    // Tick thread API: never blocks, returns false when the entry was dropped
+    bool recordFrame(std::uint32_t tick, const Simulation& sim);
+    bool recordEvent(std::uint32_t tick, EventType type, std::uint32_t playerId);
+
+    RecorderStats stats() const { return counters; }
+
+private:
+    struct QueueItem {
+        bool isEvent{false};
+        ReplayEvent event;
+        ReplayFrame frame;
+    };
+
+    // One recording: its queue, thread and file state, owned by the writer thread
+    // from begin() until it exits
+    struct Writer {
+        explicit Writer(std::size_t queueCapacity) : queue(queueCapacity) {}
+
+        SpscQueue<QueueItem> queue;
+        std::counting_semaphore<> ready{0};  // one release per queued entry, plus the stop
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> done{false};
+        std::thread thread;
+
+        std::FILE* file{nullptr};
+        ReplayHeader header;
+        std::uint64_t offset{0};
+        bool havePrev{false};
+        std::uint32_t lastKeyframeTick{0};
+        ReplayFrame prev;
+        FrameCoder coder;
+        std::vector<IndexEntry> index;
+        std::vector<std::uint8_t> payload;
+        std::vector<std::uint8_t> record;
+
+        void run();
+        void writeFrame(const ReplayFrame& frame);
+        void writeEvent(const ReplayEvent& event);
+        void writeRecord(RecordType type);
+        void writeIndex();
+    };
+
+    std::size_t queueCapacity;
+    std::unique_ptr<Writer> active;
+    std::vector<std::unique_ptr<Writer>> retired;  // stopped, possibly still writing
+    std::string path;
+    RecorderStats counters;
+
+    void reapFinished();
+};
+
+} // namespace replay
@@ -1,6 +1,7 @@
 #include "Simulation.h"
 #include "PhysicsValidator.h"
 #include "utils/VectorMath.h"
+#include "core/Profiler.h"
 
 #include <cmath>
 #include <iostream>
@@ -23,24 +24,73 @@ Simulation::Simulation(float arenaRadius, Vec2 arenaCenter)
 void Simulation::setArenaRadius(float r) { arenaRadius = r; }
 float Simulation::getArenaRadius() const { return arenaRadius; }
 
-void Simulation::addPlayer(std::uint32_t id, Vec2 spawnPos){
+std::size_t Simulation::addPlayer(std::uint32_t id, Vec2 spawnPos){
     SimPlayer p;
     p.id = id;
     p.position = spawnPos;
     p.velocity = {0.f, 0.f};
     p.inputDir = {0.f, 0.f};
     p.alive = true;
-    players[id] = p;
+
+    std::size_t slot = slotOf(id);
+    if (slot == INVALID_SLOT) {
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = players.size();
+            players.emplace_back();
+            slotUsed.push_back(false);
+        }
+        slotUsed[slot] = true;
+        slotById[id] = slot;
+    }
+    players[slot] = p;
+    return slot;
 }
 
 void Simulation::removePlayer(std::uint32_t id) {
-    players.erase(id);
+    auto it = slotById.find(id);
+    if (it == slotById.end()) return;
+    slotUsed[it->second] = false;
+    freeSlots.push_back(it->second);
+    slotById.erase(it);
+}
+
+std::size_t Simulation::restorePlayer(const SimPlayer& saved) {
+    const std::size_t slot = addPlayer(saved.id, saved.position);
+    players[slot] = saved;
+    return slot;
+}
+
+bool Simulation::reassignPlayer(std::uint32_t oldId, std::uint32_t newId) {
+    auto it = slotById.find(oldId);
+    if (it == slotById.end() || slotById.count(newId) > 0) return false;
+    const std::size_t slot = it->second;
+    slotById.erase(it);
+    slotById[newId] = slot;
+    players[slot].id = newId;
+    players[slot].inputDir = {0.f, 0.f};
+    return true;
 }
 
 void Simulation::applyInput(std::uint32_t id, Vec2 dir) {
-    auto it = players.find(id);
-    if (it == players.end()) return;
-    it->second.inputDir = normalize(dir);
+    applyInputAt(slotOf(id), dir);
+}
+
+void Simulation::applyInputAt(std::size_t slot, Vec2 dir) {
+    if (slot >= players.size() || !slotUsed[slot]) return;
+    players[slot].inputDir = normalize(dir);
+}
+
+std::size_t Simulation::slotOf(std::uint32_t id) const {
+    auto it = slotById.find(id);
+    return it == slotById.end() ? INVALID_SLOT : it->second;
+}
+
+const SimPlayer* Simulation::playerAt(std::size_t slot) const {
+    if (slot >= players.size() || !slotUsed[slot]) return nullptr;
+    return &players[slot];
 }
 
 void Simulation::updateArenaShrink(float dt) {
@@ -62,14 +112,16 @@ void Simulation::updateArenaShrink(float dt) {
 }
 
 void Simulation::tick(float dt) {
+    PROFILE_SCOPE("Simulation::tick");
     // Basic movement params (mirrors Player.cpp roughly)
     constexpr float speed = 180.f;          // higher base thrust
     constexpr float acceleration = 36.f;    // quicker acceleration
     constexpr float friction = 0.0015f;     // less damping for sustained motion
     constexpr float maxSpeed = 620.f;       // allow faster top speed
 
-    for (auto& kv : players) {
-        auto& p = kv.second;
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        if (!slotUsed[i]) continue;
+        auto& p = players[i];
         if (!p.alive) continue;
 
         p.velocity += p.inputDir * speed * acceleration * dt;
@@ -100,16 +152,15 @@ void Simulation::tick(float dt) {
 }
 
 void Simulation::resolveCollisions() {
+    PROFILE_SCOPE("Simulation::resolveCollisions");
     const float restitution = 2.15f;    // snappier bounce
 
-    std::vector<std::uint32_t> ids;
-    ids.reserve(players.size());
-    for (const auto& kv : players) ids.push_back(kv.first);
-
-    for (size_t a = 0; a < ids.size(); ++a) {
-        for (size_t b = a + 1; b < ids.size(); ++b) {
-            auto* pa = &players[ids[a]];
-            auto* pb = &players[ids[b]];
+    for (size_t a = 0; a < players.size(); ++a) {
+        if (!slotUsed[a]) continue;
+        for (size_t b = a + 1; b < players.size(); ++b) {
+            if (!slotUsed[b]) continue;
+            auto* pa = &players[a];
+            auto* pb = &players[b];
             if (!pa->alive || !pb->alive) continue;
 
             float dx = pb->position.x - pa->position.x;
@@ -155,15 +206,42 @@ void Simulation::resolveCollisions() {
             
             pa->velocity += impulseA;
             pb->velocity += impulseB;
+            ++pa->collisions;
+            ++pb->collisions;
+        }
+    }
+}
+
+std::uint64_t Simulation::stateHash() const {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, std::size_t len) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < len; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
         }
+    };
+    mix(&arenaAge, sizeof(arenaAge));
+    mix(&currentArenaRadius, sizeof(currentArenaRadius));
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        if (!slotUsed[i]) continue;
+        const SimPlayer& p = players[i];
+        const unsigned char alive = p.alive ? 1 : 0;
+        mix(&p.id, sizeof(p.id));
+        mix(&p.position, sizeof(p.position));
+        mix(&p.velocity, sizeof(p.velocity));
+        mix(&p.inputDir, sizeof(p.inputDir));
+        mix(&alive, sizeof(alive));
     }
+    return hash;
 }
 
 std::vector<SimSnapshotPlayer> Simulation::snapshotPlayers() const {
     std::vector<SimSnapshotPlayer> out;
-    out.reserve(players.size());
-    for (const auto& kv : players) {
-        const auto& p = kv.second;
+    out.reserve(slotById.size());
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        if (!slotUsed[i]) continue;
+        const auto& p = players[i];
         SimSnapshotPlayer s;
         s.id = p.id;
         s.position = p.position;
@@ -3,6 +3,7 @@
 #include "utils/VectorMath.h"
 #include <unordered_map>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 struct SimPlayer {
@@ -11,6 +12,7 @@ struct SimPlayer {
     Vec2 velocity{0.f, 0.f};
     Vec2 inputDir{0.f, 0.f};
     bool alive{true};
+    std::uint32_t collisions{0};  // running count of resolved contacts (wraps)
 };
 
 struct SimSnapshotPlayer {
@@ -22,31 +24,66 @@ struct SimSnapshotPlayer {
 
 class Simulation {
 public:
+    static constexpr std::size_t INVALID_SLOT = static_cast<std::size_t>(-1);
+
     explicit Simulation(float arenaRadius = 650.f, Vec2 arenaCenter = {600.f, 450.f});
 
     void setArenaRadius(float r);
     float getArenaRadius() const;
     float getPlayerRadius() const { return playerRadius; }
 
-    void addPlayer(std::uint32_t id, Vec2 spawnPos);
+    // Players live in stable slots; a slot index stays valid until the player is removed
+    std::size_t addPlayer(std::uint32_t id, Vec2 spawnPos);
     void removePlayer(std::uint32_t id);
+    // Hand an existing ball (slot, position, velocity) over to a new id
+    bool reassignPlayer(std::uint32_t oldId, std::uint32_t newId);
+    // Put a checkpointed player back exactly as saved (crash resume)
+    std::size_t restorePlayer(const SimPlayer& saved);
     void applyInput(std::uint32_t id, Vec2 dir);
+    void applyInputAt(std::size_t slot, Vec2 dir);
+    std::size_t slotOf(std::uint32_t id) const;
+    const SimPlayer* playerAt(std::size_t slot) const;
+    std::size_t playerCount() const { return slotById.size(); }
 
     void tick(float dt);
 
     std::vector<SimSnapshotPlayer> snapshotPlayers() const;
+
+    // FNV-1a over the exact bit patterns of all player and arena state, in slot
+    // order. Lockstep peers compare it to detect divergence.
+    std::uint64_t stateHash() const;
+
+    // Visit every player without copying; fn receives const SimPlayer&
+    template <typename Fn>
+    void forEachPlayer(Fn&& fn) const {
+        for (std::size_t i = 0; i < players.size(); ++i) {
+            if (slotUsed[i]) fn(players[i]);
+        }
+    }
+
+    // Same, but fn also receives the player's slot: fn(std::size_t slot, const SimPlayer&)
+    template <typename Fn>
+    void forEachSlot(Fn&& fn) const {
+        for (std::size_t i = 0; i < players.size(); ++i) {
+            if (slotUsed[i]) fn(i, players[i]);
+        }
+    }
     
     // Arena shrinking
     void updateArenaShrink(float dt);
     float getCurrentArenaRadius() const { return currentArenaRadius; }
     float getArenaAge() const { return arenaAge; }
+    void restoreArena(float age, float currentRadius) { arenaAge = age; currentArenaRadius = currentRadius; }
     
     // Public access to arena parameters
     Vec2 arenaCenter;
     float arenaRadius;  // Initial/maximum radius
 
 private:
-    std::unordered_map<std::uint32_t, SimPlayer> players;
+    std::vector<SimPlayer> players;      // slot storage, reused via freeSlots
+    std::vector<bool> slotUsed;
+    std::vector<std::size_t> freeSlots;
+    std::unordered_map<std::uint32_t, std::size_t> slotById;
     
     // Arena shrinking state
     float arenaAge = 0.0f;           // Time elapsed since arena creation
@@ -0,0 +1,259 @@
+#include "network/NetCommon.h"
+#include "network/NetworkConditioner.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Network-condition simulator: a UDP proxy on loopback that forwards every
+// client's datagrams to a server and back through a NetworkConditioner, so
+// latency, jitter, loss, duplication, reordering and bandwidth caps can be
+// reproduced locally. It only sees datagrams, so it sits in front of either
+// transport (ENet or BatchedUdp) and in front of relays as well as servers.
+namespace {
+
+struct Session {
+    ENetAddress client{};
+    ENetSocket upstream{ENET_SOCKET_NULL};  // one per client, so the server sees distinct peers
+    net::NetworkConditioner path;
+    double lastActiveMs{0.0};
+
+    Session(const net::ConditionProfile& profile, std::uint32_t seed, double nowMs)
+        : path(profile, seed, nowMs), lastActiveMs(nowMs) {}
+    ~Session() {
+        if (upstream != ENET_SOCKET_NULL) enet_socket_destroy(upstream);
+    }
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+};
+
+void printUsage() {
+    std::cout << "Usage: sumo_balls_netsim <server-host> <server-port> [options]\n"
+              << "  --port PORT            loopback port clients connect to (default 7790)\n"
+              << "  --profile NAME         scripted conditions (default broadband; see --list-profiles)\n"
+              << "  --list-profiles        print the built-in profiles and exit\n"
+              << "  --latency MS           one-way latency, both directions, every phase\n"
+              << "  --jitter MS            mean extra delay\n"
+              << "  --loss PCT             datagram loss\n"
+              << "  --loss-burst N         mean losses in a row (default: profile's)\n"
+              << "  --duplicate PCT        duplicated datagrams\n"
+              << "  --reorder PCT          datagrams held back so later ones overtake them\n"
+              << "  --bandwidth KBPS       link capacity per direction (0 = unlimited)\n"
+              << "  --seed N               random seed; same seed and traffic, same conditions (default 1)\n"
+              << "  --stats-sec S          print per-client statistics every S seconds (default 5, 0 = off)\n";
+}
+
+void listProfiles() {
+    for (const net::ConditionProfile& profile : net::conditionProfiles()) {
+        std::cout << profile.name << ": " << profile.description << "\n";
+        for (const net::ConditionPhase& phase : profile.phases) {
+            std::printf("  %-11s %6.0f ms  latency %.0f ms, jitter %.0f ms, loss %.1f%%, down %.0f kbps\n",
+                        phase.label.c_str(), phase.durationMs, phase.down.latencyMs, phase.down.jitterMs,
+                        phase.down.lossPercent, phase.down.bandwidthKbps);
+        }
+    }
+}
+
+// ENetBuffer's field order differs between platforms
+ENetBuffer bufferOf(const std::uint8_t* data, std::size_t len) {
+    ENetBuffer buffer;
+    buffer.data = const_cast<std::uint8_t*>(data);
+    buffer.dataLength = len;
+    return buffer;
+}
+
+bool sameAddress(const ENetAddress& a, const ENetAddress& b) {
+    return a.host == b.host && a.port == b.port;
+}
+
+std::string addressString(const ENetAddress& address) {
+    char host[64] = {};
+    enet_address_get_host_ip(&address, host, sizeof(host));
+    return std::string(host) + ":" + std::to_string(address.port);
+}
+
+void printStats(const Session& session) {
+    const net::ConditionerStats& up = session.path.upstream().stats();
+    const net::ConditionerStats& down = session.path.downstream().stats();
+    std::printf("%s [%s] up %llu/%llu (lost %llu, queue %llu)  down %llu/%llu (lost %llu, queue %llu, dup %llu, reorder %llu)\n",
+                addressString(session.client).c_str(), session.path.phase().label.c_str(),
+                static_cast<unsigned long long>(up.delivered), static_cast<unsigned long long>(up.submitted),
+                static_cast<unsigned long long>(up.lost), static_cast<unsigned long long>(up.queueDrops),
+                static_cast<unsigned long long>(down.delivered), static_cast<unsigned long long>(down.submitted),
+                static_cast<unsigned long long>(down.lost), static_cast<unsigned long long>(down.queueDrops),
+                static_cast<unsigned long long>(down.duplicated), static_cast<unsigned long long>(down.reordered));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::string(argv[1]) == "--list-profiles") {
+        listProfiles();
+        return 0;
+    }
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    const std::string serverHost = argv[1];
+    const auto serverPort = static_cast<std::uint16_t>(std::stoi(argv[2]));
+    std::uint16_t port = 7790;
+    std::string profileName = "broadband";
+    std::uint32_t seed = 1;
+    int statsSec = 5;
+    // Overrides apply to both directions of every phase
+    std::vector<std::pair<std::string, float>> overrides;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--list-profiles") {
+            listProfiles();
+            return 0;
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = static_cast<std::uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profileName = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--stats-sec" && i + 1 < argc) {
+            statsSec = std::stoi(argv[++i]);
+        } else if ((arg == "--latency" || arg == "--jitter" || arg == "--loss" || arg == "--loss-burst" ||
+                    arg == "--duplicate" || arg == "--reorder" || arg == "--bandwidth") && i + 1 < argc) {
+            overrides.emplace_back(arg, std::stof(argv[++i]));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const net::ConditionProfile* preset = net::findConditionProfile(profileName);
+    if (!preset) {
+        std::cerr << "Unknown profile '" << profileName << "'; try --list-profiles\n";
+        return 1;
+    }
+    net::ConditionProfile profile = *preset;
+    for (net::ConditionPhase& phase : profile.phases) {
+        for (net::LinkConditions* link : {&phase.up, &phase.down}) {
+            for (const auto& [name, value] : overrides) {
+                if (name == "--latency") link->latencyMs = value;
+                else if (name == "--jitter") link->jitterMs = value;
+                else if (name == "--loss") link->lossPercent = value;
+                else if (name == "--loss-burst") link->lossBurst = value;
+                else if (name == "--duplicate") link->duplicatePercent = value;
+                else if (name == "--reorder") link->reorderPercent = value;
+                else if (name == "--bandwidth") link->bandwidthKbps = value;
+            }
+        }
+    }
+
+    net::ENetContext enet;
+    ENetAddress server{};
+    if (enet_address_set_host(&server, serverHost.c_str()) != 0) {
+        std::cerr << "Cannot resolve " << serverHost << "\n";
+        return 1;
+    }
+    server.port = serverPort;
+
+    // Loopback only: this is a test tool, not something to expose
+    ENetAddress listenAddress{};
+    enet_address_set_host(&listenAddress, "127.0.0.1");
+    listenAddress.port = port;
+    ENetSocket listener = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    if (listener == ENET_SOCKET_NULL || enet_socket_bind(listener, &listenAddress) != 0) {
+        std::cerr << "Failed to bind 127.0.0.1:" << port << "\n";
+        return 1;
+    }
+    enet_socket_set_option(listener, ENET_SOCKOPT_NONBLOCK, 1);
+    std::cout << "Simulating '" << profile.name << "' on 127.0.0.1:" << port << " -> " << serverHost << ":"
+              << serverPort << " (seed " << seed << ")\n";
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto nowMs = [&]() { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+    constexpr double idleTimeoutMs = 30000.0;
+
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::array<std::uint8_t, net::LinkConditioner::MAX_DATAGRAM> buffer{};
+    double nextStatsMs = statsSec * 1000.0;
+
+    auto receive = [&](ENetSocket socket, ENetAddress& from) {
+        ENetBuffer view = bufferOf(buffer.data(), buffer.size());
+        return enet_socket_receive(socket, &from, &view, 1);
+    };
+
+    while (true) {
+        double now = nowMs();
+
+        // Client -> proxy: new source addresses become sessions
+        ENetAddress from{};
+        for (int len; (len = receive(listener, from)) > 0;) {
+            Session* session = nullptr;
+            for (auto& s : sessions) {
+                if (sameAddress(s->client, from)) session = s.get();
+            }
+            if (!session) {
+                auto created = std::make_unique<Session>(profile, seed + static_cast<std::uint32_t>(sessions.size()), now);
+                created->client = from;
+                created->upstream = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+                if (created->upstream == ENET_SOCKET_NULL) continue;
+                enet_socket_set_option(created->upstream, ENET_SOCKOPT_NONBLOCK, 1);
+                std::cout << "Client " << addressString(from) << " joined\n";
+                session = created.get();
+                sessions.push_back(std::move(created));
+            }
+            session->lastActiveMs = now;
+            session->path.update(now);
+            session->path.upstream().submit(now, buffer.data(), static_cast<std::size_t>(len));
+        }
+
+        // Server -> proxy, per client socket
+        for (auto& session : sessions) {
+            for (int len; (len = receive(session->upstream, from)) > 0;) {
+                if (!sameAddress(from, server)) continue;
+                session->lastActiveMs = now;
+                session->path.update(now);
+                session->path.downstream().submit(now, buffer.data(), static_cast<std::size_t>(len));
+            }
+        }
+
+        // Whatever has finished crossing the simulated network goes out for real
+        now = nowMs();
+        for (auto& session : sessions) {
+            session->path.upstream().release(now, [&](const std::uint8_t* data, std::size_t len) {
+                const ENetBuffer out = bufferOf(data, len);
+                enet_socket_send(session->upstream, &server, &out, 1);
+            });
+            session->path.downstream().release(now, [&](const std::uint8_t* data, std::size_t len) {
+                const ENetBuffer out = bufferOf(data, len);
+                enet_socket_send(listener, &session->client, &out, 1);
+            });
+        }
+
+        for (std::size_t i = 0; i < sessions.size();) {
+            Session& s = *sessions[i];
+            if (now - s.lastActiveMs > idleTimeoutMs && s.path.upstream().inFlight() == 0 &&
+                s.path.downstream().inFlight() == 0) {
+                std::cout << "Client " << addressString(s.client) << " idle, dropped\n";
+                printStats(s);
+                sessions[i] = std::move(sessions.back());
+                sessions.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        if (statsSec > 0 && now >= nextStatsMs) {
+            nextStatsMs = now + statsSec * 1000.0;
+            for (const auto& session : sessions) printStats(*session);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    enet_socket_destroy(listener);
+    return 0;
+}
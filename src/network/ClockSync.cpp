@@ -0,0 +1,109 @@
+#include "ClockSync.h"
+#include <algorithm>
+#include <cmath>
+
+namespace net {
+
+namespace {
+// Pongs older than this belong to a previous connection or a wrapped clock
+constexpr std::uint32_t MAX_RTT_MS = 10000;
+
+// Signed distance between two wrapping millisecond clocks
+double since(std::uint32_t later, std::uint32_t earlier) {
+    return static_cast<double>(static_cast<std::int32_t>(later - earlier));
+}
+}
+
+ClockSync::ClockSync(const ClockSyncConfig& config) : cfg(config) {}
+
+void ClockSync::reset() {
+    *this = ClockSync(cfg);
+}
+
+bool ClockSync::pingDue(std::uint32_t localMs) {
+    const std::uint32_t interval = count < cfg.fastSamples ? cfg.fastIntervalMs : cfg.intervalMs;
+    if (pinged && localMs - lastPing < interval) return false;
+    pinged = true;
+    lastPing = localMs;
+    return true;
+}
+
+void ClockSync::addSample(std::uint32_t sentLocalMs, std::uint32_t serverTimeMs, std::uint32_t receivedLocalMs) {
+    const std::uint32_t rtt = receivedLocalMs - sentLocalMs;
+    if (rtt > MAX_RTT_MS) return;
+    if (count == 0) base = sentLocalMs;
+
+    Sample& s = window[next];
+    s.rttMs = static_cast<double>(rtt);
+    s.localMs = since(sentLocalMs, base) + s.rttMs / 2.0;
+    s.offsetMs = since(serverTimeMs, sentLocalMs) - s.rttMs / 2.0;
+    next = (next + 1) % WINDOW;
+    count = std::min(count + 1, WINDOW);
+    newestLocal = count == 1 ? s.localMs : std::max(newestLocal, s.localMs);
+    fit();
+}
+
+void ClockSync::fit() {
+    minRtt = window[0].rttMs;
+    for (std::size_t i = 1; i < count; ++i) minRtt = std::min(minRtt, window[i].rttMs);
+    const double trusted = minRtt * (1.0 + cfg.rttSlack) + 1.0;
+    // Extra delay on a sample is queueing, which skews its offset by up to half
+    // of it; weigh samples down accordingly
+    auto weight = [&](const Sample& s) {
+        if (s.rttMs > trusted) return 0.0;
+        const double excess = 1.0 + (s.rttMs - minRtt) / 2.0;
+        return 1.0 / (excess * excess);
+    };
+
+    double sw = 0.0, meanX = 0.0, meanY = 0.0, minX = 0.0, maxX = 0.0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Sample& s = window[i];
+        const double w = weight(s);
+        if (w == 0.0) continue;
+        minX = n == 0 ? s.localMs : std::min(minX, s.localMs);
+        maxX = n == 0 ? s.localMs : std::max(maxX, s.localMs);
+        sw += w;
+        meanX += w * s.localMs;
+        meanY += w * s.offsetMs;
+        ++n;
+    }
+    meanX /= sw;
+    meanY /= sw;
+
+    double sxx = 0.0, sxy = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Sample& s = window[i];
+        const double w = weight(s);
+        sxx += w * (s.localMs - meanX) * (s.localMs - meanX);
+        sxy += w * (s.localMs - meanX) * (s.offsetMs - meanY);
+    }
+    // Drift needs a few samples spread over time; until then the offset is their mean
+    driftFitted = n >= 3 && maxX - minX >= cfg.minDriftSpanMs && sxx > 0.0;
+    const double maxDrift = cfg.maxDriftPpm * 1e-6;
+    drift = driftFitted ? std::clamp(sxy / sxx, -maxDrift, maxDrift) : 0.0;
+
+    double sq = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Sample& s = window[i];
+        const double r = s.offsetMs - (meanY + drift * (s.localMs - meanX));
+        sq += weight(s) * r * r;
+    }
+    residualMs = std::sqrt(sq / sw);
+    driftErrorPerMs = driftFitted ? residualMs / std::sqrt(sxx / sw * static_cast<double>(n)) : maxDrift;
+    offset = meanY + drift * (newestLocal - meanX);
+}
+
+ClockEstimate ClockSync::serverNow(std::uint32_t localMs) const {
+    ClockEstimate est;
+    if (count == 0) return est;
+    const double age = since(localMs, base) - newestLocal;
+    est.serverMs = static_cast<double>(localMs) + offset + drift * age;
+    // Any sample is only exact to half its round trip; the fit adds its scatter,
+    // and the drift uncertainty grows with time since the newest sample
+    est.errorMs = minRtt / 2.0 + residualMs + driftErrorPerMs * std::abs(age);
+    est.valid = true;
+    return est;
+}
+
+} // namespace net
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace net {
+
+// Tuning for the client's estimate of the server clock
+struct ClockSyncConfig {
+    std::uint32_t fastIntervalMs{300};  // ping spacing until the first fastSamples arrive
+    std::uint32_t intervalMs{1000};     // ping spacing after that (stays under the server's ping budget)
+    std::size_t fastSamples{8};
+    float rttSlack{0.5f};               // samples within minRtt * (1 + slack) + 1 ms are trusted
+    float minDriftSpanMs{5000.f};       // trusted samples must span this long before drift is fitted
+    float maxDriftPpm{500.f};           // fits beyond this are noise, not crystal drift
+};
+
+// Server time at some local instant: the true value lies within serverMs ± errorMs
+struct ClockEstimate {
+    double serverMs{0.0};
+    double errorMs{0.0};
+    bool valid{false};
+};
+
+// NTP-style server clock estimation from Ping/Pong exchanges.
+//
+// Each pong gives one sample: the server's clock at some point during the
+// round trip, so offset = serverTime - (sent + rtt/2), exact to within rtt/2.
+// Queueing only ever adds delay, so samples close to the minimum RTT in the
+// window are the trustworthy ones; the rest are dropped from the fit. A least
+// squares line through the trusted samples gives the offset and how fast it
+// moves (clock drift). All times are milliseconds; local times come from the
+// caller's steady clock.
+class ClockSync {
+public:
+    static constexpr std::size_t WINDOW = 64;
+
+    explicit ClockSync(const ClockSyncConfig& config = {});
+
+    void reset();
+
+    // True when a ping should go out now; the caller sends Ping{localMs}
+    bool pingDue(std::uint32_t localMs);
+
+    // A pong for the ping sent at sentLocalMs arrived at receivedLocalMs
+    void addSample(std::uint32_t sentLocalMs, std::uint32_t serverTimeMs, std::uint32_t receivedLocalMs);
+
+    ClockEstimate serverNow(std::uint32_t localMs) const;
+
+    std::size_t samples() const { return count; }
+    double offsetMs() const { return offset; }  // at the newest sample
+    double driftPpm() const { return drift * 1e6; }
+    bool hasDrift() const { return driftFitted; }
+    double minRttMs() const { return minRtt; }
+
+private:
+    struct Sample {
+        double localMs{0.0};  // midpoint of the round trip, relative to base
+        double offsetMs{0.0};
+        double rttMs{0.0};
+    };
+
+    ClockSyncConfig cfg;
+    std::array<Sample, WINDOW> window{};
+    std::size_t next{0};
+    std::size_t count{0};
+    std::uint32_t base{0};  // local time of the first sample; keeps the fit well conditioned
+    std::uint32_t lastPing{0};
+    bool pinged{false};
+
+    double newestLocal{0.0};
+    double offset{0.0};
+    double drift{0.0};  // offset change per local millisecond
+    double minRtt{0.0};
+    double residualMs{0.0};
+    double driftErrorPerMs{0.0};
+    bool driftFitted{false};
+
+    void fit();
+};
+
+} // namespace net
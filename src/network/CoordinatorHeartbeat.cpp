@@ -0,0 +1,94 @@
+#include "CoordinatorHeartbeat.h"
+#include "HttpClient.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace net {
+
+namespace {
+std::string quoted(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out.push_back('\\');
+        if (static_cast<unsigned char>(c) >= 0x20) out.push_back(c);
+    }
+    out.push_back('"');
+    return out;
+}
+}
+
+CoordinatorHeartbeat::CoordinatorHeartbeat(HeartbeatIdentity identity, float intervalSec)
+    : id(std::move(identity)), interval(intervalSec > 0.f ? intervalSec : 5.f) {}
+
+CoordinatorHeartbeat::~CoordinatorHeartbeat() {
+    stop();
+}
+
+void CoordinatorHeartbeat::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread([this] { run(); });
+}
+
+void CoordinatorHeartbeat::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void CoordinatorHeartbeat::publish(const ServerCapacity& capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latest = capacity;
+}
+
+std::string CoordinatorHeartbeat::toJson(const HeartbeatIdentity& identity, const ServerCapacity& capacity) {
+    const std::uint32_t taken = capacity.humans < capacity.maxPlayers ? capacity.humans : capacity.maxPlayers;
+    std::ostringstream json;
+    json << "{\"server_id\":" << quoted(identity.serverId)
+         << ",\"host\":" << quoted(identity.host)
+         << ",\"port\":" << identity.port
+         << ",\"max_players\":" << capacity.maxPlayers
+         << ",\"free_slots\":" << capacity.maxPlayers - taken
+         << ",\"humans\":" << capacity.humans
+         << ",\"bots\":" << capacity.bots
+         << ",\"peers\":" << capacity.peers
+         << ",\"tick_load\":" << capacity.tickLoad << "}";
+    return json.str();
+}
+
+void CoordinatorHeartbeat::run() {
+    const std::string url = id.coordinatorUrl + "/server/heartbeat";
+    bool reachable = true;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        const std::string body = toJson(id, latest);
+        lock.unlock();
+
+        const std::string response = HttpClient::post(url, body, id.secret);
+        const bool ok = response.find("heartbeat_received") != std::string::npos;
+        if (ok) {
+            sent.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (ok != reachable) {
+            // Log transitions only, not every failed attempt
+            if (ok) {
+                std::cout << "Coordinator heartbeat restored (" << url << ")\n";
+            } else {
+                std::cout << "Coordinator heartbeat failed (" << url << "): " << response << "\n";
+            }
+            reachable = ok;
+        }
+
+        lock.lock();
+        wake.wait_for(lock, std::chrono::duration<float>(interval), [this] { return stopping; });
+    }
+}
+
+} // namespace net
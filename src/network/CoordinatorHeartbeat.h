@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace net {
+
+// Load figures a game server reports to the coordinator
+struct ServerCapacity {
+    std::uint32_t maxPlayers{0};
+    std::uint32_t humans{0};
+    std::uint32_t bots{0};      // bots give their ball up to joining humans, so they don't take slots
+    std::uint32_t peers{0};     // every connection, including relays
+    float tickLoad{0.f};        // busy fraction of wall time, 0..1
+};
+
+struct HeartbeatIdentity {
+    std::string coordinatorUrl; // e.g. http://localhost:8888
+    std::string secret;         // the coordinator's SERVER_SECRET, sent as a bearer token
+    std::string serverId;
+    std::string host;           // address clients should connect to
+    std::uint16_t port{0};
+};
+
+// Periodically POSTs the latest ServerCapacity to <coordinator>/server/heartbeat.
+// HTTP runs on its own thread so a slow or unreachable coordinator never
+// stalls the tick loop; publish() only copies the numbers under a lock.
+class CoordinatorHeartbeat {
+public:
+    CoordinatorHeartbeat(HeartbeatIdentity identity, float intervalSec);
+    ~CoordinatorHeartbeat();
+
+    CoordinatorHeartbeat(const CoordinatorHeartbeat&) = delete;
+    CoordinatorHeartbeat& operator=(const CoordinatorHeartbeat&) = delete;
+
+    void start();
+    void stop();
+
+    void publish(const ServerCapacity& capacity);
+
+    std::uint64_t sentCount() const { return sent.load(std::memory_order_relaxed); }
+    std::uint64_t failureCount() const { return failures.load(std::memory_order_relaxed); }
+
+    static std::string toJson(const HeartbeatIdentity& identity, const ServerCapacity& capacity);
+
+private:
+    HeartbeatIdentity id;
+    float interval;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    ServerCapacity latest;
+    bool stopping{false};
+    std::thread worker;
+
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> failures{0};
+
+    void run();
+};
+
+} // namespace net
@@ -0,0 +1,76 @@
+#include "InputHistory.h"
+#include <algorithm>
+
+namespace net {
+
+InputHistory::InputHistory(std::size_t redundancy)
+    : redundancy(std::clamp<std::size_t>(redundancy, 1, MAX_BUNDLED_INPUTS)) {}
+
+std::uint32_t InputHistory::record(InputCommand& cmd) {
+    cmd.sequence = nextSequence++;
+    if (nextSequence == 0) nextSequence = 1;  // 0 means unsequenced
+    head = (head + 1) % ring.size();
+    ring[head] = cmd;
+    count = std::min(count + 1, redundancy);
+    return cmd.sequence;
+}
+
+std::uint8_t* InputHistory::writeBundle(std::uint8_t* out) const {
+    if (count == 0) return out;
+    const InputCommand& newest = ring[head];
+    InputBundleHeader header;
+    header.sequence = newest.sequence;
+    header.timestampMs = newest.timestampMs;
+    header.count = static_cast<std::uint8_t>(count);
+    out = writeMessage(out, MessageType::InputBundle, header);
+    for (std::size_t i = 0; i < count; ++i) {
+        const InputCommand& cmd = ring[(head + ring.size() - i) % ring.size()];
+        InputBundleEntry entry;
+        entry.age = static_cast<std::uint8_t>(newest.sequence - cmd.sequence);
+        entry.dirX = cmd.dirX;
+        entry.dirY = cmd.dirY;
+        out = wire::encode(out, entry);
+    }
+    return out;
+}
+
+void InputHistory::reset() {
+    head = 0;
+    count = 0;
+    nextSequence = 1;
+}
+
+bool InputQueue::push(const InputCommand& cmd) {
+    const bool full = count == CAPACITY;
+    if (full) dropOldest();
+    items[(head + count) % CAPACITY] = cmd;
+    ++count;
+    return !full;
+}
+
+bool InputQueue::popForTick(InputCommand& out) {
+    while (true) {
+        // Sequences at or below the last one applied were simulated already
+        while (count > 0 && items[head].sequence != 0 && items[head].sequence <= applied) {
+            head = (head + 1) % CAPACITY;
+            --count;
+        }
+        if (count == 0) return false;
+        // This tick's input plus at most MAX_HELD for later ticks
+        if (count <= MAX_HELD + 1) break;
+        dropOldest();
+    }
+    out = items[head];
+    head = (head + 1) % CAPACITY;
+    --count;
+    if (out.sequence != 0) applied = out.sequence;
+    return true;
+}
+
+void InputQueue::dropOldest() {
+    head = (head + 1) % CAPACITY;
+    --count;
+    ++droppedCount;
+}
+
+} // namespace net
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "NetProtocol.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace net {
+
+// Client side of redundant input. Every command is stamped with the next
+// sequence and kept; each InputBundle repeats the last `redundancy` of them,
+// so the server recovers an input as long as one of the following packets
+// arrives. Unreliable delivery stays, without waiting on resends.
+class InputHistory {
+public:
+    static constexpr std::size_t DEFAULT_REDUNDANCY = 8;  // ~130ms of inputs at 60 Hz
+
+    explicit InputHistory(std::size_t redundancy = DEFAULT_REDUNDANCY);
+
+    // Assign cmd the next sequence and remember it; returns that sequence
+    std::uint32_t record(InputCommand& cmd);
+
+    // Exact size of the bundle writeBundle produces (0 before the first record)
+    std::size_t bundleSize() const { return count == 0 ? 0 : inputBundleSize(count); }
+
+    // Write the newest command and its predecessors; out holds bundleSize() bytes
+    std::uint8_t* writeBundle(std::uint8_t* out) const;
+
+    // Forget everything, e.g. on reconnect (the server tracks sequences per session)
+    void reset();
+
+    std::size_t size() const { return count; }
+
+private:
+    std::array<InputCommand, MAX_BUNDLED_INPUTS> ring{};
+    std::size_t redundancy;
+    std::size_t head{0};  // slot of the newest command
+    std::size_t count{0};
+    std::uint32_t nextSequence{1};
+};
+
+// Server side: inputs received but not simulated yet. The client predicts one
+// input per tick, so the server consumes one per tick too; inputs that arrive
+// in a clump wait for the following ticks instead of overwriting each other.
+// More than MAX_HELD waiting means the client ran ahead (a burst after a
+// stall): the oldest are skipped so the extra delay stays small.
+class InputQueue {
+public:
+    static constexpr std::size_t CAPACITY = 16;
+    static constexpr std::size_t MAX_HELD = 4;  // ~66ms at 60 Hz
+
+    // Returns false if an older input had to be discarded to make room
+    bool push(const InputCommand& cmd);
+
+    // Input to simulate this tick; false if none arrived in time (the player
+    // keeps the previous direction). Stale sequences are discarded unapplied.
+    bool popForTick(InputCommand& out);
+
+    // Newest sequence handed out by popForTick
+    std::uint32_t lastApplied() const { return applied; }
+    // Inputs overwritten by push or skipped by the MAX_HELD cap
+    std::uint64_t dropped() const { return droppedCount; }
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    void clear() { head = 0; count = 0; }
+
+private:
+    std::array<InputCommand, CAPACITY> items{};
+    std::size_t head{0};
+    std::size_t count{0};
+    std::uint32_t applied{0};
+    std::uint64_t droppedCount{0};
+
+    void dropOldest();
+};
+
+} // namespace net
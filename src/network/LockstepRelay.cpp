@@ -0,0 +1,153 @@
+#include "LockstepRelay.h"
+#include <algorithm>
+
+namespace net {
+
+void LockstepRelay::begin(std::uint32_t startTick, std::uint32_t hashInterval,
+                          const std::vector<std::uint32_t>& roster) {
+    active = true;
+    tick = startTick;
+    interval = hashInterval == 0 ? 30 : hashInterval;
+    members.clear();
+    for (std::uint32_t id : roster) {
+        Member m;
+        m.playerId = id;
+        m.current.playerId = id;
+        m.sent.playerId = id;
+        members.push_back(m);
+    }
+    pending.clear();
+    frames = 0;
+    desyncCount = 0;
+}
+
+void LockstepRelay::end() {
+    active = false;
+    members.clear();
+    pending.clear();
+}
+
+std::size_t LockstepRelay::activePlayers() const {
+    return static_cast<std::size_t>(std::count_if(members.begin(), members.end(),
+                                                  [](const Member& m) { return m.connected; }));
+}
+
+bool LockstepRelay::inRoster(std::uint32_t playerId) const {
+    return std::any_of(members.begin(), members.end(),
+                       [playerId](const Member& m) { return m.playerId == playerId; });
+}
+
+LockstepRelay::Member* LockstepRelay::find(std::uint32_t playerId) {
+    for (Member& m : members) {
+        if (m.playerId == playerId) return &m;
+    }
+    return nullptr;
+}
+
+void LockstepRelay::setInput(std::uint32_t playerId, float dirX, float dirY) {
+    Member* m = find(playerId);
+    if (!m || !m->connected) return;
+    m->current.dirX = dirX;
+    m->current.dirY = dirY;
+}
+
+std::vector<HashCheck> LockstepRelay::dropPlayer(std::uint32_t playerId) {
+    std::vector<HashCheck> settled;
+    Member* m = find(playerId);
+    if (!m || !m->connected) return settled;
+    m->current.dirX = 0.f;
+    m->current.dirY = 0.f;
+    m->connected = false;
+
+    // Their reports no longer vote, and ticks that only lacked theirs are complete now
+    for (auto it = pending.begin(); it != pending.end();) {
+        auto& reports = it->reports;
+        reports.erase(std::remove_if(reports.begin(), reports.end(),
+                                     [playerId](const auto& entry) { return entry.first == playerId; }),
+                      reports.end());
+        if (!ready(*it)) {
+            ++it;
+            continue;
+        }
+        settled.push_back(evaluate(*it));
+        if (!settled.back().agreed) ++desyncCount;
+        it = pending.erase(it);
+    }
+    return settled;
+}
+
+const std::vector<LockstepInput>& LockstepRelay::nextFrame(LockstepFrameHeader& header) {
+    frameInputs.clear();
+    for (Member& m : members) {
+        if (frames == 0 || m.current.dirX != m.sent.dirX || m.current.dirY != m.sent.dirY) {
+            frameInputs.push_back(m.current);
+            m.sent = m.current;
+        }
+    }
+    header.tick = tick;
+    header.inputCount = static_cast<std::uint32_t>(frameInputs.size());
+    ++tick;
+    ++frames;
+    return frameInputs;
+}
+
+HashCheck LockstepRelay::submitHash(std::uint32_t playerId, const StateHash& report) {
+    HashCheck result;
+    const Member* m = find(playerId);
+    if (!active || !m || !m->connected || report.tick >= tick) return result;
+
+    // Forget ticks that can no longer complete (e.g. a peer stopped reporting)
+    const std::uint32_t horizon = interval * MAX_PENDING_INTERVALS;
+    while (!pending.empty() && pending.front().tick + horizon < tick) pending.pop_front();
+
+    auto it = std::find_if(pending.begin(), pending.end(),
+                           [&](const PendingHash& p) { return p.tick == report.tick; });
+    if (it == pending.end()) {
+        if (report.tick + horizon < tick) return result;
+        auto pos = std::find_if(pending.begin(), pending.end(),
+                                [&](const PendingHash& p) { return p.tick > report.tick; });
+        it = pending.insert(pos, PendingHash{report.tick, {}});
+    }
+    for (const auto& entry : it->reports) {
+        if (entry.first == playerId) return result;  // duplicate
+    }
+    it->reports.emplace_back(playerId, report.hash);
+
+    if (!ready(*it)) return result;
+    result = evaluate(*it);
+    pending.erase(it);
+    if (!result.agreed) ++desyncCount;
+    return result;
+}
+
+bool LockstepRelay::ready(const PendingHash& entry) const {
+    return !entry.reports.empty() && entry.reports.size() >= activePlayers();
+}
+
+HashCheck LockstepRelay::evaluate(const PendingHash& entry) {
+    HashCheck result;
+    result.complete = true;
+    result.tick = entry.tick;
+
+    // Majority vote: the hash reported by the most peers
+    std::uint64_t best = 0;
+    std::size_t bestVotes = 0;
+    for (const auto& candidate : entry.reports) {
+        std::size_t votes = 0;
+        for (const auto& other : entry.reports) votes += other.second == candidate.second ? 1 : 0;
+        if (votes > bestVotes) {
+            best = candidate.second;
+            bestVotes = votes;
+        }
+    }
+    result.agreed = bestVotes == entry.reports.size();
+    result.hasMajority = bestVotes * 2 > entry.reports.size();
+    if (!result.agreed) {
+        for (const auto& report : entry.reports) {
+            if (!result.hasMajority || report.second != best) result.outliers.push_back(report.first);
+        }
+    }
+    return result;
+}
+
+} // namespace net
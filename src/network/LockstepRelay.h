@@ -0,0 +1,81 @@
+#pragma once
+
+#include "NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace net {
+
+// Outcome of comparing the hashes every peer reported for one tick
+struct HashCheck {
+    bool complete{false};              // every active peer has reported this tick
+    std::uint32_t tick{0};
+    bool agreed{true};                 // all hashes equal
+    bool hasMajority{true};            // more than half agree, so the rest can be blamed
+    std::vector<std::uint32_t> outliers;  // players whose hash differs from the majority
+};
+
+// Server side of a lockstep match. The server does not simulate: it collects
+// each player's latest input, emits one frame per tick holding only the inputs
+// that changed, and cross-checks the periodic state hashes peers send back.
+class LockstepRelay {
+public:
+    // Start a match with a fixed roster; the first frame carries every input
+    void begin(std::uint32_t startTick, std::uint32_t hashInterval, const std::vector<std::uint32_t>& roster);
+    void end();
+
+    bool running() const { return active; }
+    std::uint32_t nextTick() const { return tick; }
+    std::uint32_t hashInterval() const { return interval; }
+    std::size_t activePlayers() const;
+    bool inRoster(std::uint32_t playerId) const;
+
+    // Latest direction from a player; applies from the next frame on
+    void setInput(std::uint32_t playerId, float dirX, float dirY);
+    // A player left: their ball stops steering and their hashes are no longer awaited.
+    // Returns the checks that were only waiting on them, oldest first.
+    std::vector<HashCheck> dropPlayer(std::uint32_t playerId);
+
+    // Build the frame for nextTick() and advance; the returned inputs stay valid
+    // until the next call
+    const std::vector<LockstepInput>& nextFrame(LockstepFrameHeader& header);
+
+    HashCheck submitHash(std::uint32_t playerId, const StateHash& report);
+
+    std::uint64_t framesSent() const { return frames; }
+    std::uint64_t desyncs() const { return desyncCount; }
+
+private:
+    struct Member {
+        std::uint32_t playerId{0};
+        LockstepInput current;
+        LockstepInput sent;
+        bool connected{true};
+    };
+
+    struct PendingHash {
+        std::uint32_t tick{0};
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> reports;
+    };
+
+    // Reports for ticks further back than this many intervals are abandoned
+    static constexpr std::uint32_t MAX_PENDING_INTERVALS = 8;
+
+    bool active{false};
+    std::uint32_t tick{0};
+    std::uint32_t interval{30};
+    std::vector<Member> members;
+    std::vector<LockstepInput> frameInputs;
+    std::deque<PendingHash> pending;
+    std::uint64_t frames{0};
+    std::uint64_t desyncCount{0};
+
+    Member* find(std::uint32_t playerId);
+    bool ready(const PendingHash& entry) const;
+    HashCheck evaluate(const PendingHash& entry);
+};
+
+} // namespace net
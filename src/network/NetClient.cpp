@@ -6,8 +6,21 @@ namespace net {
 NetClient::NetClient() = default;
 NetClient::~NetClient() { disconnect(); }
 
-bool NetClient::connect(const std::string& host, std::uint16_t port) {
+bool NetClient::connect(const std::string& host, std::uint16_t port, std::uint32_t connectData,
+                        Transport transport) {
     disconnect();
+    clock.reset();
+
+    if (transport == Transport::BatchedUdp) {
+        batched = std::make_unique<UdpBatchTransport>();
+        peer = batched->connect(host, port, connectData);
+        if (!peer) {
+            std::cerr << "[NetClient Error] Failed to initiate batched UDP connection to " << host << ":" << port << std::endl;
+            batched.reset();
+            return false;
+        }
+        return true;
+    }
 
     client = enet_host_create(nullptr, 1, 2, 0, 0);
     if (!client) {
@@ -19,7 +32,7 @@ bool NetClient::connect(const std::string& host, std::uint16_t port) {
     enet_address_set_host(&address, host.c_str());
     address.port = port;
 
-    peer = enet_host_connect(client, &address, 2, 0);
+    peer = enet_host_connect(client, &address, 2, connectData);
     if (!peer) {
         std::cerr << "[NetClient Error] Failed to initiate connection to " << host << ":" << port << std::endl;
         disconnect();
@@ -29,6 +42,13 @@ bool NetClient::connect(const std::string& host, std::uint16_t port) {
 }
 
 void NetClient::disconnect() {
+    connected = false;
+    if (batched) {
+        batched->close();
+        batched.reset();
+        peer = nullptr;
+        return;
+    }
     if (peer) {
         enet_peer_disconnect(peer, 0);
         ENetEvent event{};
@@ -49,8 +69,23 @@ void NetClient::disconnect() {
 
 void NetClient::service(int timeoutMs,
                         const std::function<void()>& onConnect,
-                        const std::function<void()>& onDisconnect,
+                        const std::function<void(DisconnectReason)>& onDisconnect,
                         const std::function<void(const ENetPacket*)>& onPacket) {
+    if (batched) {
+        batched->service(timeoutMs,
+            [&](ENetPeer*) {
+                connected = true;
+                if (onConnect) onConnect();
+            },
+            [&](ENetPeer* closed) {
+                connected = false;
+                if (onDisconnect) onDisconnect(static_cast<DisconnectReason>(closed->eventData));
+                peer = nullptr;
+            },
+            [&](ENetPeer*, const ENetPacket* packet) { receive(packet, onPacket); });
+        syncClock();
+        return;
+    }
     if (!client) return;
 
     ENetEvent event{};
@@ -59,14 +94,16 @@ void NetClient::service(int timeoutMs,
     while (eventCount > 0) {
         switch (event.type) {
             case ENET_EVENT_TYPE_CONNECT:
+                connected = true;
                 if (onConnect) onConnect();
                 break;
             case ENET_EVENT_TYPE_DISCONNECT:
-                if (onDisconnect) onDisconnect();
+                connected = false;
+                if (onDisconnect) onDisconnect(static_cast<DisconnectReason>(event.data));
                 peer = nullptr;
                 break;
             case ENET_EVENT_TYPE_RECEIVE:
-                if (onPacket) onPacket(event.packet);
+                receive(event.packet, onPacket);
                 enet_packet_destroy(event.packet);
                 break;
             case ENET_EVENT_TYPE_NONE:
@@ -75,13 +112,44 @@ void NetClient::service(int timeoutMs,
         }
         eventCount = enet_host_service(client, &event, 0);
     }
+    syncClock();
+}
+
+std::uint32_t NetClient::localTimeMs() const {
+    return static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void NetClient::receive(const ENetPacket* packet, const std::function<void(const ENetPacket*)>& onPacket) {
+    // Pongs may arrive on their own or inside a batch
+    forEachMessage(packet->data, packet->dataLength, [&](const std::uint8_t* data, std::size_t len) {
+        if (data[1] != static_cast<std::uint8_t>(MessageType::Pong)) return;
+        if (decodeMessage(data, len, decoded).isSuccess()) {
+            clock.addSample(decoded.pong.timestampMs, decoded.pong.serverTimeMs, localTimeMs());
+        }
+    });
+    if (onPacket) onPacket(packet);
+}
+
+void NetClient::syncClock() {
+    if (!connected || !peer) return;
+    const std::uint32_t now = localTimeMs();
+    if (!clock.pingDue(now)) return;
+    sendWith(messageSize<Ping>(), false, [&](std::uint8_t* out) {
+        writeMessage(out, MessageType::Ping, Ping{now});
+    });
 }
 
 bool NetClient::send(const std::vector<std::uint8_t>& data, bool reliable) {
     if (!peer) return false;
+    if (batched) return batched->send(peer, data.data(), data.size(), reliable);
     ENetPacket* packet = enet_packet_create(data.data(), data.size(), reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
     if (!packet) return false;
-    return enet_peer_send(peer, reliable ? 1 : 0, packet) == 0;
+    if (enet_peer_send(peer, reliable ? 1 : 0, packet) != 0) {
+        enet_packet_destroy(packet);
+        return false;
+    }
+    return true;
 }
 
 } // namespace net
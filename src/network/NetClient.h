@@ -1,8 +1,12 @@
 #pragma once
 
+#include "ClockSync.h"
 #include "NetCommon.h"
 #include "NetProtocol.h"
+#include "UdpBatchTransport.h"
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -13,22 +17,66 @@ public:
     NetClient();
     ~NetClient();
 
-    bool connect(const std::string& host, std::uint16_t port);
+    // connectData is delivered to the server as the peer's connect event data
+    bool connect(const std::string& host, std::uint16_t port, std::uint32_t connectData = CONNECT_PLAYER,
+                 Transport transport = Transport::ENet);
     void disconnect();
 
+    // onDisconnect gets the reason the server gave; None for timeouts and plain closes
     void service(int timeoutMs,
                  const std::function<void()>& onConnect,
-                 const std::function<void()>& onDisconnect,
+                 const std::function<void(DisconnectReason)>& onDisconnect,
                  const std::function<void(const ENetPacket*)>& onPacket);
 
     bool send(const std::vector<std::uint8_t>& data, bool reliable = false);
 
+    // Serialize straight into a pooled packet: fill(std::uint8_t* data) writes size bytes
+    template <typename Fill>
+    bool sendWith(std::size_t size, bool reliable, Fill&& fill) {
+        if (!peer) return false;
+        if (batched) {
+            std::uint8_t buffer[UdpBatchTransport::MAX_PAYLOAD];
+            if (size > sizeof(buffer)) {
+                // Rare on the client; the transport fragments it
+                std::vector<std::uint8_t> large(size);
+                fill(large.data());
+                return batched->send(peer, large.data(), size, reliable);
+            }
+            fill(buffer);
+            return batched->send(peer, buffer, size, reliable);
+        }
+        ENetPacket* packet = enet_packet_create(nullptr, size, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+        if (!packet) return false;
+        fill(packet->data);
+        if (enet_peer_send(peer, reliable ? 1 : 0, packet) != 0) {
+            enet_packet_destroy(packet);
+            return false;
+        }
+        return true;
+    }
+
     ENetPeer* peerHandle() { return peer; }
 
+    // Server clock, kept in sync by pings sent from service() while connected.
+    // Pongs still reach onPacket.
+    ClockEstimate serverNow() const { return clock.serverNow(localTimeMs()); }
+    const ClockSync& clockSync() const { return clock; }
+
+    // This client's steady clock in milliseconds (also used for ping and input timestamps)
+    std::uint32_t localTimeMs() const;
+
 private:
     ENetContext ctx;
     ENetHost* client{nullptr};
     ENetPeer* peer{nullptr};
+    std::unique_ptr<UdpBatchTransport> batched;
+    std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+    ClockSync clock;
+    DecodedMessage decoded;  // reused by receive()
+    bool connected{false};
+
+    void receive(const ENetPacket* packet, const std::function<void(const ENetPacket*)>& onPacket);
+    void syncClock();
 };
 
 } // namespace net
@@ -1,16 +1,24 @@
 #pragma once
 
+#include "PacketPool.h"
 #include <enet/enet.h>
 #include <stdexcept>
 #include <atomic>
 
 namespace net {
 
+// Wire transport behind NetServer/NetClient. Both ends must use the same one.
+enum class Transport {
+    ENet,        // reliable UDP via ENet (default)
+    BatchedUdp   // recvmmsg/sendmmsg batching, Linux only (see UdpBatchTransport)
+};
+
 class ENetContext {
 public:
     ENetContext() {
         if (initCount.fetch_add(1) == 0) {
-            if (enet_initialize() != 0) {
+            // Packets are allocated from size-classed pools instead of the heap
+            if (enet_initialize_with_callbacks(ENET_VERSION, &PacketPool::enetCallbacks()) != 0) {
                 initCount.fetch_sub(1);
                 throw std::runtime_error("Failed to initialize ENet");
             }
@@ -1,8 +1,21 @@
 #include "NetProtocol.h"
+#include <cmath>
 #include <sstream>
 
 namespace net {
 
+const char* disconnectReasonText(DisconnectReason reason) {
+    switch (reason) {
+        case DisconnectReason::None:            return "Disconnected from the server";
+        case DisconnectReason::ServerBusy:      return "The server is too busy right now, try again later";
+        case DisconnectReason::Rejected:        return "The server refused the connection";
+        case DisconnectReason::Abuse:           return "Disconnected for sending too much traffic";
+        case DisconnectReason::MatchInProgress: return "A match is already in progress on this server";
+        case DisconnectReason::Desync:          return "Disconnected: the game fell out of sync with the other players";
+        default:                                return "Disconnected by the server";
+    }
+}
+
 std::string ParseResult::getErrorMessage() const {
     std::ostringstream oss;
     
@@ -51,4 +64,177 @@ std::string ParseResult::getErrorMessage() const {
     return oss.str();
 }
 
+namespace {
+bool finite(float v) { return std::isfinite(v); }
+
+// The simulation normalizes directions; only NaN and infinity would poison it
+bool finiteDir(float x, float y) { return finite(x) && finite(y); }
+
+// Fixed-size message: exactly header + body
+template <typename T>
+ParseResult decodeFixed(const std::uint8_t* data, std::size_t len, T& out, const char* context) {
+    if (len != messageSize<T>()) return ParseResult::badLength(context, messageSize<T>(), len);
+    wire::decode(data + 2, out);
+    return ParseResult::success(context);
+}
+
+// Header plus count entries of T: the count must match the bytes exactly
+template <typename T>
+ParseResult checkArray(std::size_t len, std::size_t headerSize, std::size_t count, const char* context) {
+    const std::size_t entries = (len - headerSize) / wire::size<T>;
+    if (count != entries || len != headerSize + count * wire::size<T>) {
+        return ParseResult::badLength(context, headerSize + count * wire::size<T>, len);
+    }
+    return ParseResult::success(context);
+}
+}
+
+ParseResult decodeMessage(const std::uint8_t* data, std::size_t len, DecodedMessage& out) {
+    if (len < 2) return ParseResult::badLength("message header", 2, len);
+    if (data[0] != PROTOCOL_VERSION) {
+        ParseResult r = ParseResult::makeError(ParseError::InvalidProtocolVersion, "message header");
+        r.actualVersion = data[0];
+        return r;
+    }
+    if (data[1] < static_cast<std::uint8_t>(MessageType::JoinRequest) ||
+        data[1] > static_cast<std::uint8_t>(MessageType::InputAck)) {
+        return ParseResult::makeError(ParseError::UnknownMessageType, "message header");
+    }
+    out.type = static_cast<MessageType>(data[1]);
+
+    switch (out.type) {
+        case MessageType::JoinRequest:
+            return len == 2 ? ParseResult::success("JoinRequest") : ParseResult::badLength("JoinRequest", 2, len);
+
+        case MessageType::JoinAccept:
+            return decodeFixed(data, len, out.joinAccept, "JoinAccept");
+
+        case MessageType::Input: {
+            ParseResult r = decodeFixed(data, len, out.input, "Input");
+            if (r.isSuccess() && !finiteDir(out.input.dirX, out.input.dirY)) {
+                return ParseResult::badField("dir", "Input direction must be finite");
+            }
+            return r;
+        }
+
+        case MessageType::InputBundle: {
+            if (len < inputBundleSize(0)) return ParseResult::badLength("InputBundle", inputBundleSize(0), len);
+            wire::decode(data + 2, out.inputBundle);
+            if (out.inputBundle.count == 0 || out.inputBundle.count > MAX_BUNDLED_INPUTS) {
+                return ParseResult::badField("count", "InputBundle must carry 1..MAX_BUNDLED_INPUTS inputs");
+            }
+            ParseResult r = checkArray<InputBundleEntry>(len, inputBundleSize(0), out.inputBundle.count, "InputBundle");
+            if (!r.isSuccess()) return r;
+            out.bundleEntries = WireView<InputBundleEntry>(data + inputBundleSize(0), out.inputBundle.count);
+            // At most MAX_BUNDLED_INPUTS entries, so checking them stays bounded
+            for (std::size_t i = 0; i < out.bundleEntries.size(); ++i) {
+                const InputBundleEntry entry = out.bundleEntries[i];
+                if (!finiteDir(entry.dirX, entry.dirY)) {
+                    return ParseResult::badField("dir", "InputBundle direction must be finite");
+                }
+            }
+            return r;
+        }
+
+        case MessageType::State: {
+            if (len < STATE_HEADER_SIZE) return ParseResult::badLength("State", STATE_HEADER_SIZE, len);
+            const std::uint8_t* in = data + 2;
+            in = wire::load(in, out.state.tick);
+            in = wire::load(in, out.state.serverTimeMs);
+            in = wire::load(in, out.state.arenaRadius);
+            std::uint32_t count = 0;
+            wire::load(in, count);
+            if (!finite(out.state.arenaRadius) || out.state.arenaRadius < 0.f) {
+                return ParseResult::badField("arenaRadius", "State arena radius must be finite");
+            }
+            ParseResult r = checkArray<PlayerState>(len, STATE_HEADER_SIZE, count, "State");
+            if (!r.isSuccess()) {
+                r.error = ParseError::InvalidPlayerCount;
+                return r;
+            }
+            out.state.players = WireView<PlayerState>(data + STATE_HEADER_SIZE, count);
+            // Bounded by the packet length, and every entry is read by the client anyway
+            for (std::size_t i = 0; i < out.state.players.size(); ++i) {
+                const PlayerState p = out.state.players[i];
+                if (!finite(p.x) || !finite(p.y) || !finite(p.vx) || !finite(p.vy)) {
+                    return ParseResult::badField("players", "State player position and velocity must be finite");
+                }
+            }
+            return r;
+        }
+
+        case MessageType::Ping:
+            return decodeFixed(data, len, out.ping, "Ping");
+
+        case MessageType::Pong:
+            return decodeFixed(data, len, out.pong, "Pong");
+
+        case MessageType::LockstepStart: {
+            if (len < lockstepStartSize(0)) return ParseResult::badLength("LockstepStart", lockstepStartSize(0), len);
+            wire::decode(data + 2, out.lockstepStart);
+            const LockstepStartHeader& h = out.lockstepStart;
+            if (h.tickRateHz == 0 || h.tickRateHz > 1000) {
+                return ParseResult::badField("tickRateHz", "LockstepStart tick rate must be 1..1000");
+            }
+            if (h.hashInterval == 0) return ParseResult::badField("hashInterval", "LockstepStart hash interval is 0");
+            if (!finite(h.arenaRadius) || h.arenaRadius <= 0.f || !finite(h.arenaCenterX) || !finite(h.arenaCenterY)) {
+                return ParseResult::badField("arena", "LockstepStart arena must be finite");
+            }
+            ParseResult r = checkArray<LockstepPlayer>(len, lockstepStartSize(0), h.playerCount, "LockstepStart");
+            if (!r.isSuccess()) {
+                r.error = ParseError::InvalidPlayerCount;
+                return r;
+            }
+            out.roster = WireView<LockstepPlayer>(data + lockstepStartSize(0), h.playerCount);
+            return r;
+        }
+
+        case MessageType::LockstepFrame: {
+            if (len < lockstepFrameSize(0)) return ParseResult::badLength("LockstepFrame", lockstepFrameSize(0), len);
+            wire::decode(data + 2, out.lockstepFrame);
+            ParseResult r = checkArray<LockstepInput>(len, lockstepFrameSize(0), out.lockstepFrame.inputCount,
+                                                      "LockstepFrame");
+            if (!r.isSuccess()) return r;
+            out.lockstepInputs = WireView<LockstepInput>(data + lockstepFrameSize(0), out.lockstepFrame.inputCount);
+            // Every peer feeds these straight into its simulation
+            for (std::size_t i = 0; i < out.lockstepInputs.size(); ++i) {
+                const LockstepInput input = out.lockstepInputs[i];
+                if (!finiteDir(input.dirX, input.dirY)) {
+                    return ParseResult::badField("dir", "LockstepFrame direction must be finite");
+                }
+            }
+            return r;
+        }
+
+        case MessageType::StateHash:
+            return decodeFixed(data, len, out.stateHash, "StateHash");
+
+        case MessageType::Batch:
+            // Frames are checked by forEachMessage, which callers use to unpack
+            return len > 2 ? ParseResult::success("Batch") : ParseResult::badLength("Batch", 3, len);
+
+        case MessageType::MatchEvents: {
+            if (len < matchEventsSize(0)) return ParseResult::badLength("MatchEvents", matchEventsSize(0), len);
+            wire::decode(data + 2, out.matchEvents);
+            if (out.matchEvents.count == 0) return ParseResult::badField("count", "MatchEvents is empty");
+            ParseResult r = checkArray<MatchEvent>(len, matchEventsSize(0), out.matchEvents.count, "MatchEvents");
+            if (!r.isSuccess()) return r;
+            // At most MAX_MATCH_EVENTS entries; an unknown type would be a bad enum
+            for (std::size_t i = 0; i < out.matchEvents.count; ++i) {
+                const std::uint8_t type = data[matchEventsSize(i)];
+                if (type < static_cast<std::uint8_t>(MatchEventType::Waiting) ||
+                    type > static_cast<std::uint8_t>(MatchEventType::RoundEnded)) {
+                    return ParseResult::badField("type", "Unknown match event type");
+                }
+            }
+            out.events = WireView<MatchEvent>(data + matchEventsSize(0), out.matchEvents.count);
+            return r;
+        }
+
+        case MessageType::InputAck:
+            return decodeFixed(data, len, out.inputAck, "InputAck");
+    }
+    return ParseResult::makeError(ParseError::UnknownMessageType, "message header");
+}
+
 } // namespace net
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "WireFormat.h"
 #include <cstdint>
 #include <cstddef>
-#include <cstring>
 #include <string>
 #include <vector>
 
 namespace net {
 
-constexpr std::uint8_t PROTOCOL_VERSION = 1;
+// v2: packed little-endian wire layout (see WireFormat.h) instead of raw host structs
+// v3: Pong carries the server clock
+// v4: InputAck follows each snapshot to a player
+constexpr std::uint8_t PROTOCOL_VERSION = 4;
 
 enum class MessageType : std::uint8_t {
     JoinRequest = 1,
@@ -16,7 +19,15 @@ enum class MessageType : std::uint8_t {
     Input       = 3,
     State       = 4,
     Ping        = 5,
-    Pong        = 6
+    Pong        = 6,
+    // Lockstep matches: the server relays inputs instead of state
+    LockstepStart = 7,
+    LockstepFrame = 8,
+    StateHash     = 9,
+    InputBundle   = 10,  // newest input plus the ones before it (replaces Input)
+    Batch         = 11,  // several framed messages in one datagram (see forEachMessage)
+    MatchEvents   = 12,  // one tick's match events, on the reliable channel
+    InputAck      = 13   // player's last applied input as of a snapshot tick
 };
 
 enum class ParseError {
@@ -30,20 +41,77 @@ enum class ParseError {
     InvalidMessageStructure
 };
 
+// Outcome of decodeMessage. Context and field names are static strings, so
+// producing a result never allocates; only getErrorMessage() formats text.
 struct ParseResult {
     ParseError error{ParseError::Success};
-    std::string context;
+    const char* context{""};
     std::size_t expectedBytes{0};
     std::size_t actualBytes{0};
     std::uint8_t expectedVersion{PROTOCOL_VERSION};
     std::uint8_t actualVersion{PROTOCOL_VERSION};
-    std::string fieldName;
+    const char* fieldName{""};
+
+    bool isSuccess() const { return error == ParseError::Success; }
+
+    static ParseResult success(const char* context = "") {
+        ParseResult r;
+        r.context = context;
+        return r;
+    }
+    static ParseResult makeError(ParseError error, const char* context) {
+        ParseResult r;
+        r.error = error;
+        r.context = context;
+        return r;
+    }
+    // Too short, or trailing bytes the message does not account for
+    static ParseResult badLength(const char* context, std::size_t expected, std::size_t actual) {
+        ParseResult r = makeError(actual < expected ? ParseError::PacketTooShort : ParseError::InvalidMessageStructure,
+                                  context);
+        r.expectedBytes = expected;
+        r.actualBytes = actual;
+        return r;
+    }
+    static ParseResult badField(const char* fieldName, const char* context) {
+        ParseResult r = makeError(ParseError::InvalidFieldValue, context);
+        r.fieldName = fieldName;
+        return r;
+    }
 
     std::string getErrorMessage() const;
 };
 
+// Connect data (ENetPeer::eventData) of a regular player connection. Relays
+// connect with the server's subscriber key instead and receive the snapshot
+// stream without a ball of their own.
+constexpr std::uint32_t CONNECT_PLAYER = 0;
+
+// Data sent with a server-initiated disconnect so clients can tell why
+enum class DisconnectReason : std::uint32_t {
+    None            = 0,
+    ServerBusy      = 1,  // admission control: server load too high for new players
+    Rejected        = 2,  // unknown connect data
+    Abuse           = 3,  // peer kept exceeding its packet budgets
+    MatchInProgress = 4,  // lockstep match already started; rosters are fixed
+    Desync          = 5   // lockstep state hash disagreed with the other peers
+};
+
+// Human-readable explanation, suitable for showing to the player
+const char* disconnectReasonText(DisconnectReason reason);
+
+// playerId handed to subscribers and spectators in JoinAccept
+constexpr std::uint32_t SPECTATOR_PLAYER_ID = 0;
+
+// Resume windows: a restarted server resumes a checkpoint up to RESUME_WITHIN_SEC
+// old (its --resume-within default), and holds a dropped or restored player's
+// ball for RESUME_GRACE_SEC until they reconnect with their token
+constexpr float RESUME_WITHIN_SEC = 60.f;
+constexpr float RESUME_GRACE_SEC = 30.f;
+
 struct JoinAccept {
     std::uint32_t playerId{0};
+    std::uint32_t resumeToken{0};  // connect data that reclaims this player after a drop or restart
 };
 
 struct InputCommand {
@@ -54,6 +122,23 @@ struct InputCommand {
     std::uint32_t timestampMs{0};
 };
 
+// Redundant input: the newest command followed by the ones before it, so a
+// lost packet's inputs still arrive with the next one. Sequences are coded as
+// offsets back from the header's; playerId is implied by the connection.
+struct InputBundleHeader {
+    std::uint32_t sequence{0};     // sequence of the newest entry
+    std::uint32_t timestampMs{0};  // client time of the newest entry
+    std::uint8_t count{0};
+};
+
+struct InputBundleEntry {
+    std::uint8_t age{0};  // header.sequence minus this entry's sequence
+    float dirX{0.f};
+    float dirY{0.f};
+};
+
+constexpr std::size_t MAX_BUNDLED_INPUTS = 32;
+
 struct PlayerState {
     std::uint32_t playerId{0};
     float x{0.f};
@@ -67,6 +152,38 @@ struct Ping {
     std::uint32_t timestampMs{0};
 };
 
+// Answer to a Ping: its timestamp echoed, plus the server clock when answered
+// (the same clock as StateSnapshot::serverTimeMs)
+struct Pong {
+    std::uint32_t timestampMs{0};
+    std::uint32_t serverTimeMs{0};
+};
+
+// Match events are sent reliably, once, stamped with the server tick they
+// happened on, so clients need not infer them from unreliable snapshots.
+enum class MatchEventType : std::uint8_t {
+    Waiting      = 1,  // too few players for a round
+    Countdown    = 2,  // value = whole seconds until the round starts
+    RoundStarted = 3,  // value = round number; players are back at their spawns
+    Eliminated   = 4,  // playerId left the arena
+    RoundEnded   = 5   // playerId = winner (0 if nobody survived), value = round number
+};
+
+struct MatchEvent {
+    MatchEventType type{MatchEventType::Waiting};
+    std::uint32_t playerId{0};
+    std::uint32_t value{0};
+};
+
+struct MatchEventsHeader {
+    std::uint32_t tick{0};  // server tick every event in the message happened on
+    std::uint8_t count{0};
+};
+
+constexpr std::size_t MAX_MATCH_EVENTS = 0xFF;
+
+// A snapshot may carry only a subset of the players (large lobbies are
+// prioritized per client); receivers merge entries by playerId.
 struct StateSnapshot {
     std::uint32_t tick{0};
     std::uint32_t serverTimeMs{0};
@@ -74,73 +191,265 @@ struct StateSnapshot {
     std::vector<PlayerState> players;
 };
 
-inline bool deserializeState(const std::uint8_t* data, std::size_t len, StateSnapshot& out) {
-    // Expect header already validated (type == State)
-    constexpr std::size_t headerSize = 2;
-    if (len < headerSize + sizeof(std::uint32_t) * 3 + sizeof(float)) return false;
-    std::size_t offset = headerSize;
-    std::memcpy(&out.tick, data + offset, sizeof(out.tick));
-    offset += sizeof(out.tick);
-    std::memcpy(&out.serverTimeMs, data + offset, sizeof(out.serverTimeMs));
-    offset += sizeof(out.serverTimeMs);
-    std::memcpy(&out.arenaRadius, data + offset, sizeof(out.arenaRadius));
-    offset += sizeof(out.arenaRadius);
-    std::uint32_t count = 0;
-    std::memcpy(&count, data + offset, sizeof(count));
-    offset += sizeof(count);
-    if (len < offset + count * sizeof(PlayerState)) return false;
-    out.players.resize(count);
-    std::memcpy(out.players.data(), data + offset, count * sizeof(PlayerState));
+// Sent to a player right behind each State, through its outbox: the newest
+// input sequence the server had applied when it took that snapshot. Clients
+// drop inputs up to it and replay the rest on top of the snapshot.
+struct InputAck {
+    std::uint32_t tick{0};      // matches StateSnapshot::tick
+    std::uint32_t sequence{0};  // 0 until the first sequenced input arrives
+};
+
+// Lockstep mode: every peer runs the Simulation itself from the same start
+// state and the same per-tick inputs; the server only relays inputs and
+// compares the state hashes peers report every hashInterval ticks.
+struct LockstepStartHeader {
+    std::uint32_t startTick{0};
+    std::uint32_t tickRateHz{60};
+    std::uint32_t hashInterval{30};
+    float arenaRadius{0.f};
+    float arenaCenterX{0.f};
+    float arenaCenterY{0.f};
+    std::uint32_t playerCount{0};
+};
+
+// Roster entry, in simulation slot order (clients must add players in this order)
+struct LockstepPlayer {
+    std::uint32_t playerId{0};
+    float x{0.f};
+    float y{0.f};
+};
+
+// Input that takes effect on the frame's tick and holds until changed
+struct LockstepInput {
+    std::uint32_t playerId{0};
+    float dirX{0.f};
+    float dirY{0.f};
+};
+
+struct LockstepFrameHeader {
+    std::uint32_t tick{0};        // the tick these inputs apply to
+    std::uint32_t inputCount{0};  // only inputs that changed since the previous frame
+};
+
+struct StateHash {
+    std::uint32_t tick{0};
+    std::uint32_t reserved{0};  // host alignment only; not sent
+    std::uint64_t hash{0};
+};
+
+// Wire layouts, in wire order. Any change here is a protocol change: the
+// static_asserts below pin the format, so bump PROTOCOL_VERSION with them.
+namespace wire {
+template <> struct Wire<JoinAccept> {
+    using Layout = Fields<&JoinAccept::playerId, &JoinAccept::resumeToken>;
+};
+template <> struct Wire<InputCommand> {
+    using Layout = Fields<&InputCommand::playerId, &InputCommand::dirX, &InputCommand::dirY,
+                          &InputCommand::sequence, &InputCommand::timestampMs>;
+};
+template <> struct Wire<InputBundleHeader> {
+    using Layout = Fields<&InputBundleHeader::sequence, &InputBundleHeader::timestampMs, &InputBundleHeader::count>;
+};
+template <> struct Wire<InputBundleEntry> {
+    using Layout = Fields<&InputBundleEntry::age, &InputBundleEntry::dirX, &InputBundleEntry::dirY>;
+};
+template <> struct Wire<PlayerState> {
+    using Layout = Fields<&PlayerState::playerId, &PlayerState::x, &PlayerState::y,
+                          &PlayerState::vx, &PlayerState::vy, &PlayerState::alive>;
+};
+template <> struct Wire<Ping> {
+    using Layout = Fields<&Ping::timestampMs>;
+};
+template <> struct Wire<Pong> {
+    using Layout = Fields<&Pong::timestampMs, &Pong::serverTimeMs>;
+};
+template <> struct Wire<LockstepStartHeader> {
+    using Layout = Fields<&LockstepStartHeader::startTick, &LockstepStartHeader::tickRateHz,
+                          &LockstepStartHeader::hashInterval, &LockstepStartHeader::arenaRadius,
+                          &LockstepStartHeader::arenaCenterX, &LockstepStartHeader::arenaCenterY,
+                          &LockstepStartHeader::playerCount>;
+};
+template <> struct Wire<LockstepPlayer> {
+    using Layout = Fields<&LockstepPlayer::playerId, &LockstepPlayer::x, &LockstepPlayer::y>;
+};
+template <> struct Wire<LockstepInput> {
+    using Layout = Fields<&LockstepInput::playerId, &LockstepInput::dirX, &LockstepInput::dirY>;
+};
+template <> struct Wire<LockstepFrameHeader> {
+    using Layout = Fields<&LockstepFrameHeader::tick, &LockstepFrameHeader::inputCount>;
+};
+template <> struct Wire<StateHash> {
+    using Layout = Fields<&StateHash::tick, &StateHash::hash>;
+};
+template <> struct Wire<MatchEventsHeader> {
+    using Layout = Fields<&MatchEventsHeader::tick, &MatchEventsHeader::count>;
+};
+template <> struct Wire<InputAck> {
+    using Layout = Fields<&InputAck::tick, &InputAck::sequence>;
+};
+template <> struct Wire<MatchEvent> {
+    using Layout = Fields<&MatchEvent::type, &MatchEvent::playerId, &MatchEvent::value>;
+};
+} // namespace wire
+
+static_assert(wire::size<JoinAccept> == 8);
+static_assert(wire::size<InputCommand> == 20 && wire::offset<InputCommand, 3> == 12);
+static_assert(wire::size<InputBundleHeader> == 9 && wire::size<InputBundleEntry> == 9);
+static_assert(wire::size<PlayerState> == 21 && wire::offset<PlayerState, 5> == 20,
+              "PlayerState is sent without padding: 21 bytes, alive last");
+static_assert(wire::size<Ping> == 4 && wire::size<Pong> == 8);
+static_assert(wire::size<LockstepStartHeader> == 28 && wire::offset<LockstepStartHeader, 6> == 24);
+static_assert(wire::size<LockstepPlayer> == 12);
+static_assert(wire::size<LockstepInput> == 12);
+static_assert(wire::size<LockstepFrameHeader> == 8);
+static_assert(wire::size<StateHash> == 12 && wire::offset<StateHash, 1> == 4);
+static_assert(wire::size<MatchEventsHeader> == 5 && wire::size<MatchEvent> == 9);
+static_assert(wire::size<InputAck> == 8);
+
+inline std::uint8_t* writeMessageHeader(std::uint8_t* out, MessageType type) {
+    out[0] = PROTOCOL_VERSION;
+    out[1] = static_cast<std::uint8_t>(type);
+    return out + 2;
+}
+
+// Header plus one fixed-size body (JoinAccept, Input, Ping, Pong, StateHash, InputAck)
+template <typename T>
+constexpr std::size_t messageSize() { return 2 + wire::size<T>; }
+
+// Writers serialize straight into a packet buffer; the caller provides exactly
+// sized storage and each call returns the advanced pointer.
+template <typename T>
+inline std::uint8_t* writeMessage(std::uint8_t* out, MessageType type, const T& body) {
+    return wire::encode(writeMessageHeader(out, type), body);
+}
+
+// Decode the body of a fixed-size message whose header was already parsed
+template <typename T>
+inline bool readMessage(const std::uint8_t* data, std::size_t len, T& out) {
+    if (len < messageSize<T>()) return false;
+    wire::decode(data + 2, out);
     return true;
 }
 
-// Simple serialization helpers (little-endian, POD only)
-inline void appendBytes(std::vector<std::uint8_t>& out, const void* data, std::size_t len) {
-    const auto* bytes = static_cast<const std::uint8_t*>(data);
-    out.insert(out.end(), bytes, bytes + len);
+template <typename T>
+inline std::uint8_t* writeArray(std::uint8_t* out, const T* items, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) out = wire::encode(out, items[i]);
+    return out;
 }
 
-inline void appendMessageHeader(std::vector<std::uint8_t>& out, MessageType type) {
-    out.push_back(PROTOCOL_VERSION);
-    out.push_back(static_cast<std::uint8_t>(type));
+// Read-only view of count packed entries inside a packet, decoded on access.
+// Valid only while the packet bytes are.
+template <typename T>
+class WireView {
+public:
+    WireView() = default;
+    WireView(const std::uint8_t* data, std::size_t count) : bytes(data), n(count) {}
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    T operator[](std::size_t i) const {
+        T item{};
+        wire::decode(bytes + i * wire::size<T>, item);
+        return item;
+    }
+
+    // Copy into caller storage, reusing its capacity
+    void copyTo(std::vector<T>& out) const {
+        out.resize(n);
+        for (std::size_t i = 0; i < n; ++i) wire::decode(bytes + i * wire::size<T>, out[i]);
+    }
+
+private:
+    const std::uint8_t* bytes{nullptr};
+    std::size_t n{0};
+};
+
+constexpr std::size_t inputBundleSize(std::size_t count) {
+    return messageSize<InputBundleHeader>() + count * wire::size<InputBundleEntry>;
 }
 
-inline std::vector<std::uint8_t> serializeInput(const InputCommand& cmd) {
-    std::vector<std::uint8_t> out;
-    out.reserve(2 + sizeof(InputCommand));
-    appendMessageHeader(out, MessageType::Input);
-    appendBytes(out, &cmd, sizeof(InputCommand));
+constexpr std::size_t STATE_HEADER_SIZE = 2 + sizeof(std::uint32_t) * 3 + sizeof(float);
+
+constexpr std::size_t stateMessageSize(std::size_t playerCount) {
+    return STATE_HEADER_SIZE + playerCount * wire::size<PlayerState>;
+}
+
+// State is written in two steps so players can be streamed from any source:
+// the header (with the final player count), then exactly that many entries.
+inline std::uint8_t* writeStateHeader(std::uint8_t* out, std::uint32_t tick, std::uint32_t serverTimeMs,
+                                      float arenaRadius, std::uint32_t playerCount) {
+    out = writeMessageHeader(out, MessageType::State);
+    out = wire::store(out, tick);
+    out = wire::store(out, serverTimeMs);
+    out = wire::store(out, arenaRadius);
+    return wire::store(out, playerCount);
+}
+
+inline std::uint8_t* writeState(std::uint8_t* out, const StateSnapshot& snap) {
+    out = writeStateHeader(out, snap.tick, snap.serverTimeMs, snap.arenaRadius,
+                           static_cast<std::uint32_t>(snap.players.size()));
+    return writeArray(out, snap.players.data(), snap.players.size());
+}
+
+constexpr std::size_t lockstepStartSize(std::size_t playerCount) {
+    return messageSize<LockstepStartHeader>() + playerCount * wire::size<LockstepPlayer>;
+}
+
+constexpr std::size_t lockstepFrameSize(std::size_t inputCount) {
+    return messageSize<LockstepFrameHeader>() + inputCount * wire::size<LockstepInput>;
+}
+
+inline std::uint8_t* writeLockstepStart(std::uint8_t* out, const LockstepStartHeader& header,
+                                        const LockstepPlayer* players) {
+    out = writeMessage(out, MessageType::LockstepStart, header);
+    return writeArray(out, players, header.playerCount);
+}
+
+inline std::uint8_t* writeLockstepFrame(std::uint8_t* out, const LockstepFrameHeader& header,
+                                        const LockstepInput* inputs) {
+    out = writeMessage(out, MessageType::LockstepFrame, header);
+    return writeArray(out, inputs, header.inputCount);
+}
+
+constexpr std::size_t matchEventsSize(std::size_t count) {
+    return messageSize<MatchEventsHeader>() + count * wire::size<MatchEvent>;
+}
+
+// count must not exceed MAX_MATCH_EVENTS
+inline std::uint8_t* writeMatchEvents(std::uint8_t* out, std::uint32_t tick, const MatchEvent* events,
+                                      std::size_t count) {
+    out = writeMessage(out, MessageType::MatchEvents,
+                       MatchEventsHeader{tick, static_cast<std::uint8_t>(count)});
+    return writeArray(out, events, count);
+}
+
+template <typename T>
+inline std::vector<std::uint8_t> serializeMessage(MessageType type, const T& body) {
+    std::vector<std::uint8_t> out(messageSize<T>());
+    writeMessage(out.data(), type, body);
     return out;
 }
 
+inline std::vector<std::uint8_t> serializeInput(const InputCommand& cmd) {
+    return serializeMessage(MessageType::Input, cmd);
+}
+
 inline std::vector<std::uint8_t> serializeJoinAccept(const JoinAccept& msg) {
-    std::vector<std::uint8_t> out;
-    out.reserve(2 + sizeof(JoinAccept));
-    appendMessageHeader(out, MessageType::JoinAccept);
-    appendBytes(out, &msg, sizeof(JoinAccept));
-    return out;
+    return serializeMessage(MessageType::JoinAccept, msg);
 }
 
-inline std::vector<std::uint8_t> serializePing(MessageType type, const Ping& msg) {
-    std::vector<std::uint8_t> out;
-    out.reserve(2 + sizeof(Ping));
-    appendMessageHeader(out, type);
-    appendBytes(out, &msg, sizeof(Ping));
-    return out;
+inline std::vector<std::uint8_t> serializePing(const Ping& msg) {
+    return serializeMessage(MessageType::Ping, msg);
+}
+
+inline std::vector<std::uint8_t> serializePong(const Pong& msg) {
+    return serializeMessage(MessageType::Pong, msg);
 }
 
 inline std::vector<std::uint8_t> serializeState(const StateSnapshot& snap) {
-    std::vector<std::uint8_t> out;
-    out.reserve(2 + sizeof(std::uint32_t) * 3 + sizeof(float) + snap.players.size() * sizeof(PlayerState));
-    appendMessageHeader(out, MessageType::State);
-    appendBytes(out, &snap.tick, sizeof(snap.tick));
-    appendBytes(out, &snap.serverTimeMs, sizeof(snap.serverTimeMs));
-    appendBytes(out, &snap.arenaRadius, sizeof(snap.arenaRadius));
-    std::uint32_t count = static_cast<std::uint32_t>(snap.players.size());
-    appendBytes(out, &count, sizeof(count));
-    for (const auto& p : snap.players) {
-        appendBytes(out, &p, sizeof(PlayerState));
-    }
+    std::vector<std::uint8_t> out(stateMessageSize(snap.players.size()));
+    writeState(out.data(), snap);
     return out;
 }
 
@@ -152,4 +461,149 @@ inline bool parseHeader(const std::uint8_t* data, std::size_t len, MessageType&
     return true;
 }
 
+// Batch framing: [version][Batch] then ([u16 length][complete message])*.
+// Inner messages keep their own header so handlers parse them unchanged.
+constexpr std::size_t FRAME_PREFIX_SIZE = sizeof(std::uint16_t);
+constexpr std::size_t MAX_FRAMED_MESSAGE = 0xFFFF;
+
+// Call onMessage(const std::uint8_t* data, std::size_t len) for a plain
+// message, or for every message inside a Batch. A batch is validated as a
+// whole first (no empty, truncated or nested frames), so a malformed one
+// delivers nothing and returns false.
+template <typename OnMessage>
+inline bool forEachMessage(const std::uint8_t* data, std::size_t len, OnMessage&& onMessage) {
+    MessageType type;
+    if (!parseHeader(data, len, type)) return false;
+    if (type != MessageType::Batch) {
+        onMessage(data, len);
+        return true;
+    }
+    if (len == 2) return false;
+    std::size_t pos = 2;
+    while (pos < len) {
+        if (len - pos < FRAME_PREFIX_SIZE) return false;
+        std::uint16_t size = 0;
+        wire::load(data + pos, size);
+        pos += FRAME_PREFIX_SIZE;
+        if (size < 2 || size > len - pos || data[pos + 1] == static_cast<std::uint8_t>(MessageType::Batch)) return false;
+        pos += size;
+    }
+    for (pos = 2; pos < len;) {
+        std::uint16_t size = 0;
+        wire::load(data + pos, size);
+        pos += FRAME_PREFIX_SIZE;
+        onMessage(data + pos, static_cast<std::size_t>(size));
+        pos += size;
+    }
+    return true;
+}
+
+// What a player's State costs on top of its own bytes when its InputAck shares
+// the Batch (the outbox frames both). stateBytes <= MAX_FRAMED_MESSAGE.
+constexpr std::size_t STATE_ACK_OVERHEAD = 2 + 2 * FRAME_PREFIX_SIZE + messageSize<InputAck>();
+
+constexpr std::size_t stateWithAckSize(std::size_t stateBytes) {
+    return stateBytes + STATE_ACK_OVERHEAD;
+}
+
+// Decoding. decodeMessage is the one entry point for untrusted bytes: it checks
+// version, type, exact length and header field ranges in constant time before
+// anything is read, then fills the members for that type. Array payloads stay
+// in the packet as views, so decoding never allocates.
+struct StateView {
+    std::uint32_t tick{0};
+    std::uint32_t serverTimeMs{0};
+    float arenaRadius{0.f};
+    WireView<PlayerState> players;
+};
+
+// Reuse one instance across packets; only the members of `type` are written
+struct DecodedMessage {
+    MessageType type{MessageType::JoinRequest};
+    JoinAccept joinAccept;
+    InputCommand input;
+    InputBundleHeader inputBundle;
+    WireView<InputBundleEntry> bundleEntries;
+    StateView state;
+    Ping ping;
+    Pong pong;
+    LockstepStartHeader lockstepStart;
+    WireView<LockstepPlayer> roster;
+    LockstepFrameHeader lockstepFrame;
+    WireView<LockstepInput> lockstepInputs;
+    StateHash stateHash;
+    MatchEventsHeader matchEvents;
+    WireView<MatchEvent> events;
+    InputAck inputAck;
+    // Batch: the frames are walked by forEachMessage, which validates them
+};
+
+ParseResult decodeMessage(const std::uint8_t* data, std::size_t len, DecodedMessage& out);
+
+// Expands a decoded bundle into InputCommands and calls onInput(const
+// InputCommand&) for each, oldest first. Receivers dedupe by sequence;
+// playerId is left 0.
+template <typename OnInput>
+inline void forEachBundledInput(const InputBundleHeader& header, const WireView<InputBundleEntry>& entries,
+                                OnInput&& onInput) {
+    for (std::size_t i = entries.size(); i-- > 0;) {
+        const InputBundleEntry entry = entries[i];
+        if (entry.age >= header.sequence) continue;  // would reach sequence 0 (unsequenced)
+        InputCommand cmd;
+        cmd.sequence = header.sequence - entry.age;
+        cmd.dirX = entry.dirX;
+        cmd.dirY = entry.dirY;
+        cmd.timestampMs = header.timestampMs;
+        onInput(cmd);
+    }
+}
+
+// Convenience wrappers over decodeMessage for callers holding one message
+
+template <typename OnInput>
+inline bool readInputBundle(const std::uint8_t* data, std::size_t len, OnInput&& onInput) {
+    DecodedMessage msg;
+    if (!decodeMessage(data, len, msg).isSuccess() || msg.type != MessageType::InputBundle) return false;
+    forEachBundledInput(msg.inputBundle, msg.bundleEntries, onInput);
+    return true;
+}
+
+inline bool deserializeState(const std::uint8_t* data, std::size_t len, StateSnapshot& out) {
+    DecodedMessage msg;
+    if (!decodeMessage(data, len, msg).isSuccess() || msg.type != MessageType::State) return false;
+    out.tick = msg.state.tick;
+    out.serverTimeMs = msg.state.serverTimeMs;
+    out.arenaRadius = msg.state.arenaRadius;
+    msg.state.players.copyTo(out.players);
+    return true;
+}
+
+inline bool deserializeLockstepStart(const std::uint8_t* data, std::size_t len, LockstepStartHeader& header,
+                                     std::vector<LockstepPlayer>& players) {
+    DecodedMessage msg;
+    if (!decodeMessage(data, len, msg).isSuccess() || msg.type != MessageType::LockstepStart) return false;
+    header = msg.lockstepStart;
+    msg.roster.copyTo(players);
+    return true;
+}
+
+inline bool deserializeLockstepFrame(const std::uint8_t* data, std::size_t len, LockstepFrameHeader& header,
+                                     std::vector<LockstepInput>& inputs) {
+    DecodedMessage msg;
+    if (!decodeMessage(data, len, msg).isSuccess() || msg.type != MessageType::LockstepFrame) return false;
+    header = msg.lockstepFrame;
+    msg.lockstepInputs.copyTo(inputs);
+    return true;
+}
+
+// Calls onEvent(std::uint32_t tick, const MatchEvent&) in order; a malformed
+// message delivers nothing.
+template <typename OnEvent>
+inline bool readMatchEvents(const std::uint8_t* data, std::size_t len, OnEvent&& onEvent) {
+    DecodedMessage msg;
+    if (!decodeMessage(data, len, msg).isSuccess() || msg.type != MessageType::MatchEvents) return false;
+    for (std::size_t i = 0; i < msg.events.size(); ++i) onEvent(msg.matchEvents.tick, msg.events[i]);
+    return true;
+}
+
 } // namespace net
@@ -6,9 +6,19 @@ namespace net {
 NetServer::NetServer() = default;
 NetServer::~NetServer() { stop(); }
 
-bool NetServer::start(std::uint16_t port, std::size_t maxClients) {
+bool NetServer::start(std::uint16_t port, std::size_t maxClients, Transport transport) {
     stop();
 
+    if (transport == Transport::BatchedUdp) {
+        batched = std::make_unique<UdpBatchTransport>();
+        if (!batched->listen(port, maxClients)) {
+            std::cerr << "[NetServer Error] Failed to start batched UDP transport (port: " << port << ")" << std::endl;
+            batched.reset();
+            return false;
+        }
+        return true;
+    }
+
     ENetAddress address{};
     address.host = ENET_HOST_ANY;
     address.port = port;
@@ -22,6 +32,7 @@ bool NetServer::start(std::uint16_t port, std::size_t maxClients) {
 }
 
 void NetServer::stop() {
+    batched.reset();
     if (host) {
         enet_host_destroy(host);
         host = nullptr;
@@ -32,6 +43,10 @@ void NetServer::service(int timeoutMs,
                         const std::function<void(ENetPeer*)>& onConnect,
                         const std::function<void(ENetPeer*)>& onDisconnect,
                         const std::function<void(ENetPeer*, const ENetPacket*)>& onPacket) {
+    if (batched) {
+        batched->service(timeoutMs, onConnect, onDisconnect, onPacket);
+        return;
+    }
     if (!host) return;
 
     ENetEvent event{};
@@ -55,6 +70,7 @@ void NetServer::service(int timeoutMs,
 }
 
 bool NetServer::broadcast(const std::vector<std::uint8_t>& data, bool reliable) {
+    if (batched) return batched->broadcast(data.data(), data.size(), reliable);
     if (!host) return false;
     ENetPacket* packet = enet_packet_create(data.data(), data.size(), reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
     if (!packet) {
@@ -65,17 +81,66 @@ bool NetServer::broadcast(const std::vector<std::uint8_t>& data, bool reliable)
     return true;
 }
 
+ENetPacket* NetServer::createPacket(std::size_t size, bool reliable) {
+    // A null source leaves the pooled buffer uninitialized for the caller to fill
+    ENetPacket* packet = enet_packet_create(nullptr, size, reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+    if (!packet) {
+        std::cerr << "[NetServer Warning] Failed to create packet (size: " << size << " bytes)" << std::endl;
+    }
+    return packet;
+}
+
+bool NetServer::sendPacket(ENetPeer* peer, ENetPacket* packet, bool reliable) {
+    if (!peer || !packet) return false;
+    // The batched transport copies into its send vector; the caller still releases
+    if (batched) return batched->send(peer, packet->data, packet->dataLength, reliable);
+    return enet_peer_send(peer, reliable ? 1 : 0, packet) == 0;
+}
+
+void NetServer::releasePacket(ENetPacket* packet) {
+    if (packet && packet->referenceCount == 0) enet_packet_destroy(packet);
+}
+
+void NetServer::flush() {
+    if (batched) {
+        batched->flush();
+    } else if (host) {
+        enet_host_flush(host);
+    }
+}
+
+void NetServer::disconnect(ENetPeer* peer, DisconnectReason reason) {
+    if (!peer) return;
+    if (batched) {
+        batched->disconnect(peer, static_cast<std::uint32_t>(reason));
+    } else {
+        enet_peer_disconnect(peer, static_cast<enet_uint32>(reason));
+    }
+}
+
 bool NetServer::sendTo(ENetPeer* peer, const std::vector<std::uint8_t>& data, bool reliable) {
     if (!peer) {
         std::cerr << "[NetServer Warning] Attempted to send to null peer" << std::endl;
         return false;
     }
+    if (batched) return batched->send(peer, data.data(), data.size(), reliable);
     ENetPacket* packet = enet_packet_create(data.data(), data.size(), reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
     if (!packet) {
         std::cerr << "[NetServer Warning] Failed to create packet for peer (size: " << data.size() << " bytes)" << std::endl;
         return false;
     }
-    return enet_peer_send(peer, reliable ? 1 : 0, packet) == 0;
+    const bool sent = enet_peer_send(peer, reliable ? 1 : 0, packet) == 0;
+    releasePacket(packet);
+    return sent;
+}
+
+LinkStats NetServer::linkStats(const ENetPeer* peer) {
+    LinkStats stats;
+    if (!peer) return stats;
+    stats.rttMs = static_cast<float>(peer->roundTripTime);
+    stats.packetLoss = static_cast<float>(peer->packetLoss) / static_cast<float>(ENET_PEER_PACKET_LOSS_SCALE);
+    stats.throttle = static_cast<float>(peer->packetThrottle) / static_cast<float>(ENET_PEER_PACKET_THROTTLE_SCALE);
+    return stats;
 }
 
 } // namespace net
@@ -2,7 +2,10 @@
 
 #include "NetCommon.h"
 #include "NetProtocol.h"
+#include "SnapshotRate.h"
+#include "UdpBatchTransport.h"
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace net {
@@ -12,7 +15,7 @@ public:
     NetServer();
     ~NetServer();
 
-    bool start(std::uint16_t port, std::size_t maxClients = 8);
+    bool start(std::uint16_t port, std::size_t maxClients = 8, Transport transport = Transport::ENet);
     void stop();
 
     // Poll incoming events; timeoutMs can be 0 for non-blocking
@@ -24,11 +27,40 @@ public:
     bool broadcast(const std::vector<std::uint8_t>& data, bool reliable = false);
     bool sendTo(ENetPeer* peer, const std::vector<std::uint8_t>& data, bool reliable = false);
 
-    ENetHost* rawHost() { return host; }
+    // Zero-copy sends: allocate a pooled packet, write into packet->data, send.
+    // A packet may go to several peers (ENet refcounts it); call releasePacket()
+    // once done so a packet nobody accepted is freed.
+    static ENetPacket* createPacket(std::size_t size, bool reliable = false);
+    bool sendPacket(ENetPeer* peer, ENetPacket* packet, bool reliable = false);
+    static void releasePacket(ENetPacket* packet);
+
+    // Push queued sends to the socket now instead of on the next service()
+    void flush();
+    void disconnect(ENetPeer* peer, DisconnectReason reason = DisconnectReason::None);
+
+    // Single-use convenience: fill(std::uint8_t* data) writes exactly size bytes
+    template <typename Fill>
+    bool sendWith(ENetPeer* peer, std::size_t size, bool reliable, Fill&& fill) {
+        ENetPacket* packet = createPacket(size, reliable);
+        if (!packet) return false;
+        fill(packet->data);
+        const bool sent = sendPacket(peer, packet, reliable);
+        releasePacket(packet);
+        return sent;
+    }
+
+    ENetHost* rawHost() { return host; }  // null with Transport::BatchedUdp
+    Transport transport() const { return batched ? Transport::BatchedUdp : Transport::ENet; }
+
+    // Normalized link quality of a connected peer (RTT, loss, throttle)
+    static LinkStats linkStats(const ENetPeer* peer);
+    // Data the peer passed to enet_host_connect (valid inside onConnect)
+    static std::uint32_t connectData(const ENetPeer* peer) { return peer ? peer->eventData : 0; }
 
 private:
     ENetContext ctx;
     ENetHost* host{nullptr};
+    std::unique_ptr<UdpBatchTransport> batched;
 };
 
 } // namespace net
@@ -0,0 +1,110 @@
+#include "NetThread.h"
+#include "core/Profiler.h"
+
+#include <cstring>
+
+namespace net {
+
+NetThread::NetThread(std::size_t queueCapacity) : incoming(queueCapacity), outgoing(queueCapacity) {}
+
+NetThread::~NetThread() { stop(); }
+
+bool NetThread::start(const std::string& host, std::uint16_t port, std::uint32_t connectData,
+                      Transport transport) {
+    stop();
+    if (!client.connect(host, port, connectData, transport)) return false;
+    {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        publishedClock = client.clockSync();
+    }
+    running.store(true, std::memory_order_release);
+    worker = std::thread(&NetThread::run, this);
+    return true;
+}
+
+void NetThread::stop() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) worker.join();
+}
+
+ClockEstimate NetThread::serverNow() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return publishedClock.serverNow(client.localTimeMs());
+}
+
+ClockSync NetThread::clockSync() const {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return publishedClock;
+}
+
+NetThreadStats NetThread::stats() const {
+    NetThreadStats s;
+    s.received = received.load(std::memory_order_relaxed);
+    s.droppedIncoming = droppedIncoming.load(std::memory_order_relaxed);
+    s.droppedOutgoing = droppedOutgoing.load(std::memory_order_relaxed);
+    return s;
+}
+
+void NetThread::run() {
+    PROFILE_THREAD_NAME("net-client");
+    while (running.load(std::memory_order_acquire)) {
+        flushOutgoing();
+        // A short timeout wakes on arrival and bounds send latency to about a millisecond
+        client.service(1,
+            [&] { push(NetArrival::Kind::Connected, nullptr, 0, false); },
+            [&](DisconnectReason reason) { push(NetArrival::Kind::Disconnected, nullptr, 0, false, reason); },
+            [&](const ENetPacket* packet) {
+                push(NetArrival::Kind::Packet, packet->data, packet->dataLength,
+                     (packet->flags & ENET_PACKET_FLAG_RELIABLE) != 0);
+            });
+        publishClock();
+    }
+    flushOutgoing();
+    client.disconnect();
+}
+
+void NetThread::flushOutgoing() {
+    while (Outgoing* msg = outgoing.front()) {
+        client.sendWith(msg->size, msg->reliable, [&](std::uint8_t* out) {
+            std::memcpy(out, msg->data.data(), msg->size);
+        });
+        outgoing.popFront();
+    }
+}
+
+void NetThread::push(NetArrival::Kind kind, const std::uint8_t* data, std::size_t size, bool reliable,
+                     DisconnectReason reason) {
+    // Stamp before queueing so the game thread sees when the packet arrived, not when it looked
+    const std::uint32_t now = client.localTimeMs();
+    auto fill = [&](NetArrival& arrival) {
+        arrival.kind = kind;
+        arrival.reason = reason;
+        arrival.arrivalMs = now;
+        arrival.size = static_cast<std::uint16_t>(size);
+        if (size > 0) std::memcpy(arrival.data.data(), data, size);
+    };
+    if (size > NetArrival::MAX_BYTES) {
+        droppedIncoming.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Losing an unreliable packet costs a snapshot. Losing a state change strands the
+    // game thread in the wrong state, and losing a reliable message (a lockstep frame,
+    // match events) breaks the stream ENet promised, so wait for room instead
+    if (kind != NetArrival::Kind::Packet || reliable) {
+        while (!incoming.tryPushWith(fill)) {
+            if (!running.load(std::memory_order_acquire)) return;
+            std::this_thread::yield();
+        }
+    } else if (!incoming.tryPushWith(fill)) {
+        droppedIncoming.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (kind == NetArrival::Kind::Packet) received.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetThread::publishClock() {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    publishedClock = client.clockSync();
+}
+
+} // namespace net
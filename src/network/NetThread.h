@@ -0,0 +1,103 @@
+#pragma once
+
+#include "NetClient.h"
+#include "utils/SpscQueue.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace net {
+
+// Something the network thread saw, stamped with NetClient::localTimeMs() at arrival
+struct NetArrival {
+    enum class Kind : std::uint8_t { Packet, Connected, Disconnected };
+    static constexpr std::size_t MAX_BYTES = 4096;
+
+    Kind kind{Kind::Packet};
+    DisconnectReason reason{DisconnectReason::None};  // Disconnected only
+    std::uint32_t arrivalMs{0};
+    std::uint16_t size{0};
+    std::array<std::uint8_t, MAX_BYTES> data{};
+};
+
+struct NetThreadStats {
+    std::uint64_t received{0};
+    std::uint64_t droppedIncoming{0};  // unreliable packet with the queue full, or any packet larger than MAX_BYTES
+    std::uint64_t droppedOutgoing{0};  // queue full or message larger than MAX_BYTES
+};
+
+// Runs a NetClient on its own thread so receive and send timing no longer
+// depends on render frame time.
+//
+// The game thread pushes outgoing messages and pops arrivals through two
+// bounded lock-free queues; the network thread flushes outgoing messages and
+// services ENet about once a millisecond. Pongs are still consumed by the
+// NetClient's clock sync on the network thread; serverNow() reads a copy of
+// it published after each service.
+class NetThread {
+public:
+    explicit NetThread(std::size_t queueCapacity = 128);
+    ~NetThread();
+
+    NetThread(const NetThread&) = delete;
+    NetThread& operator=(const NetThread&) = delete;
+
+    // Connects on the calling thread, then hands the client to the network thread
+    bool start(const std::string& host, std::uint16_t port, std::uint32_t connectData = CONNECT_PLAYER,
+               Transport transport = Transport::ENet);
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    // Game thread API: never blocks. fill(std::uint8_t* data) writes size bytes.
+    template <typename Fill>
+    bool sendWith(std::size_t size, bool reliable, Fill&& fill) {
+        const bool queued = size <= NetArrival::MAX_BYTES && outgoing.tryPushWith([&](Outgoing& msg) {
+            msg.reliable = reliable;
+            msg.size = static_cast<std::uint16_t>(size);
+            fill(msg.data.data());
+        });
+        if (!queued) droppedOutgoing.fetch_add(1, std::memory_order_relaxed);
+        return queued;
+    }
+
+    // Oldest unread arrival, or nullptr; release it with pop() once handled
+    const NetArrival* front() { return incoming.front(); }
+    void pop() { incoming.popFront(); }
+
+    ClockEstimate serverNow() const;
+    ClockSync clockSync() const;  // copy of the network thread's estimator
+    std::uint32_t localTimeMs() const { return client.localTimeMs(); }
+    NetThreadStats stats() const;
+
+private:
+    struct Outgoing {
+        bool reliable{false};
+        std::uint16_t size{0};
+        std::array<std::uint8_t, NetArrival::MAX_BYTES> data{};
+    };
+
+    NetClient client;  // touched only by the network thread while running
+    SpscQueue<NetArrival> incoming;
+    SpscQueue<Outgoing> outgoing;
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    mutable std::mutex clockMutex;
+    ClockSync publishedClock;
+
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> droppedIncoming{0};
+    std::atomic<std::uint64_t> droppedOutgoing{0};
+
+    void run();
+    void flushOutgoing();
+    // Only unreliable packets are dropped when the queue is full; everything else waits
+    void push(NetArrival::Kind kind, const std::uint8_t* data, std::size_t size, bool reliable,
+              DisconnectReason reason = DisconnectReason::None);
+    void publishClock();
+};
+
+} // namespace net
@@ -0,0 +1,179 @@
+#include "NetworkConditioner.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace net {
+
+namespace {
+LinkConditions link(float latencyMs, float jitterMs, float lossPercent, float lossBurst, float bandwidthKbps = 0.f) {
+    LinkConditions c;
+    c.latencyMs = latencyMs;
+    c.jitterMs = jitterMs;
+    c.lossPercent = lossPercent;
+    c.lossBurst = lossBurst;
+    c.bandwidthKbps = bandwidthKbps;
+    return c;
+}
+
+LinkConditions withShuffle(LinkConditions c, float duplicatePercent, float reorderPercent) {
+    c.duplicatePercent = duplicatePercent;
+    c.reorderPercent = reorderPercent;
+    return c;
+}
+
+std::vector<ConditionProfile> buildProfiles() {
+    std::vector<ConditionProfile> profiles;
+    profiles.push_back({"lan", "Wired LAN: ~1 ms, no loss",
+                        {{"steady", 1000.0, link(1.f, 0.3f, 0.f, 1.f), link(1.f, 0.3f, 0.f, 1.f)}}});
+    profiles.push_back({"broadband", "Home fibre/cable to a nearby server",
+                        {{"steady", 1000.0, link(12.f, 2.f, 0.1f, 1.f, 20000.f), link(12.f, 2.f, 0.1f, 1.f, 100000.f)}}});
+    profiles.push_back({"intercontinental", "Good path to a far-away server: high but stable latency",
+                        {{"steady", 1000.0, link(85.f, 4.f, 0.3f, 1.f), link(85.f, 4.f, 0.3f, 1.f)}}});
+    profiles.push_back({"mobile-4g", "LTE: jittery and bursty, with a cell handover every 10 s",
+                        {{"steady", 9400.0,
+                          withShuffle(link(35.f, 12.f, 1.f, 2.f, 2000.f), 0.f, 0.5f),
+                          withShuffle(link(35.f, 12.f, 1.f, 2.f, 8000.f), 0.f, 0.5f)},
+                         {"handover", 600.0,
+                          link(150.f, 60.f, 15.f, 4.f, 500.f),
+                          link(150.f, 60.f, 15.f, 4.f, 1000.f)}}});
+    profiles.push_back({"congested-wifi", "Shared Wi-Fi: calm spells broken by airtime contention",
+                        {{"calm", 5000.0,
+                          withShuffle(link(4.f, 6.f, 1.f, 3.f), 0.5f, 1.f),
+                          withShuffle(link(4.f, 6.f, 1.f, 3.f), 0.5f, 1.f)},
+                         {"contention", 3000.0,
+                          withShuffle(link(15.f, 40.f, 5.f, 3.f, 1000.f), 1.f, 3.f),
+                          withShuffle(link(15.f, 40.f, 5.f, 3.f, 1500.f), 1.f, 3.f)}}});
+    profiles.push_back({"lossy", "Stress test: heavy independent loss, duplication and reordering",
+                        {{"steady", 1000.0,
+                          withShuffle(link(30.f, 5.f, 10.f, 1.f), 2.f, 5.f),
+                          withShuffle(link(30.f, 5.f, 10.f, 1.f), 2.f, 5.f)}}});
+    return profiles;
+}
+}
+
+const std::vector<ConditionProfile>& conditionProfiles() {
+    static const std::vector<ConditionProfile> profiles = buildProfiles();
+    return profiles;
+}
+
+const ConditionProfile* findConditionProfile(std::string_view name) {
+    for (const ConditionProfile& profile : conditionProfiles()) {
+        if (profile.name == name) return &profile;
+    }
+    return nullptr;
+}
+
+LinkConditioner::LinkConditioner(std::uint32_t seed, std::size_t capacity) : rng(seed), slots(capacity) {
+    freeSlots.reserve(capacity);
+    heap.reserve(capacity);
+    for (std::size_t i = capacity; i > 0; --i) freeSlots.push_back(static_cast<std::uint32_t>(i - 1));
+}
+
+bool LinkConditioner::chance(float percent) {
+    if (percent <= 0.f) return false;
+    return std::uniform_real_distribution<float>(0.f, 100.f)(rng) < percent;
+}
+
+bool LinkConditioner::loseNext() {
+    // Two-state Gilbert-Elliott chain: every datagram in the bad state is lost.
+    // Leaving it with 1/burst keeps the mean burst length at lossBurst, and the
+    // entry rate is chosen so the long-run loss rate is still lossPercent.
+    const float p = std::clamp(cfg.lossPercent / 100.f, 0.f, 1.f);
+    if (p <= 0.f || p >= 1.f) {
+        inLossBurst = p >= 1.f;
+        return inLossBurst;
+    }
+    const float burst = std::max(cfg.lossBurst, 1.f);
+    const float leave = 1.f / burst;
+    const float enter = std::min(1.f, p / (burst * (1.f - p)));
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    inLossBurst = inLossBurst ? uniform(rng) >= leave : uniform(rng) < enter;
+    return inLossBurst;
+}
+
+double LinkConditioner::jitterSample() {
+    if (cfg.jitterMs <= 0.f) return 0.0;
+    return std::exponential_distribution<double>(1.0 / cfg.jitterMs)(rng);
+}
+
+bool LinkConditioner::schedule(double releaseMs, const std::uint8_t* data, std::size_t len) {
+    if (freeSlots.empty()) {
+        ++counters.overflowDrops;
+        return false;
+    }
+    const std::uint32_t index = freeSlots.back();
+    freeSlots.pop_back();
+    Slot& slot = slots[index];
+    slot.releaseMs = releaseMs;
+    slot.order = nextOrder++;
+    slot.size = static_cast<std::uint16_t>(len);
+    std::memcpy(slot.data.data(), data, len);
+    heap.push_back(index);
+    std::push_heap(heap.begin(), heap.end(), Later{slots});
+    return true;
+}
+
+bool LinkConditioner::submit(double nowMs, const std::uint8_t* data, std::size_t len) {
+    ++counters.submitted;
+    if (len > MAX_DATAGRAM) {
+        ++counters.overflowDrops;
+        return false;
+    }
+    if (loseNext()) {
+        ++counters.lost;
+        return false;
+    }
+
+    double sentMs = nowMs;
+    if (cfg.bandwidthKbps > 0.f) {
+        // Serialize behind whatever the link is still sending; kbit/s is bits per ms
+        const double startMs = std::max(nowMs, linkFreeAtMs);
+        if (startMs - nowMs > cfg.queueLimitMs) {
+            ++counters.queueDrops;
+            return false;
+        }
+        linkFreeAtMs = startMs + static_cast<double>((len + UDP_OVERHEAD) * 8) / cfg.bandwidthKbps;
+        sentMs = linkFreeAtMs;
+    }
+
+    double releaseMs = sentMs + cfg.latencyMs + jitterSample();
+    if (chance(cfg.reorderPercent)) {
+        // Held back without holding back its successors
+        releaseMs += cfg.reorderDelayMs;
+        ++counters.reordered;
+    } else {
+        // A queue is first in, first out: jitter alone never reorders
+        releaseMs = std::max(releaseMs, lastInOrderMs);
+        lastInOrderMs = releaseMs;
+    }
+    if (!schedule(releaseMs, data, len)) return false;
+
+    if (chance(cfg.duplicatePercent) && schedule(releaseMs + jitterSample(), data, len)) {
+        ++counters.duplicated;
+    }
+    return true;
+}
+
+NetworkConditioner::NetworkConditioner(const ConditionProfile& profile, std::uint32_t seed, double nowMs)
+    : script(profile), up(seed), down(seed ^ 0x9e3779b9u), startMs(nowMs) {
+    if (script.phases.empty()) script.phases.push_back({"clean", 1000.0, {}, {}});
+    for (const ConditionPhase& phase : script.phases) cycleMs += std::max(phase.durationMs, 1.0);
+    up.setConditions(script.phases[0].up);
+    down.setConditions(script.phases[0].down);
+}
+
+void NetworkConditioner::update(double nowMs) {
+    double t = std::fmod(std::max(nowMs - startMs, 0.0), cycleMs);
+    std::size_t index = 0;
+    while (index + 1 < script.phases.size() && t >= std::max(script.phases[index].durationMs, 1.0)) {
+        t -= std::max(script.phases[index].durationMs, 1.0);
+        ++index;
+    }
+    if (index == phaseIndex) return;
+    phaseIndex = index;
+    up.setConditions(script.phases[index].up);
+    down.setConditions(script.phases[index].down);
+}
+
+} // namespace net
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace net {
+
+// What one direction of a simulated path does to datagrams
+struct LinkConditions {
+    float latencyMs{0.f};         // one-way propagation delay
+    float jitterMs{0.f};          // mean extra queueing delay, exponentially distributed
+    float lossPercent{0.f};
+    float lossBurst{1.f};         // mean losses in a row (Gilbert-Elliott); 1 = independent
+    float duplicatePercent{0.f};
+    float reorderPercent{0.f};    // datagrams held back so later ones overtake them...
+    float reorderDelayMs{25.f};   // ...by this much
+    float bandwidthKbps{0.f};     // 0 = unlimited
+    float queueLimitMs{200.f};    // a capped link tail-drops datagrams that would wait longer
+};
+
+// A stretch of a scripted profile; up = client to server, down = server to client
+struct ConditionPhase {
+    std::string label;
+    double durationMs{0.0};
+    LinkConditions up;
+    LinkConditions down;
+};
+
+// Named network conditions; the phases loop for as long as the simulation runs
+struct ConditionProfile {
+    std::string name;
+    std::string description;
+    std::vector<ConditionPhase> phases;
+};
+
+const std::vector<ConditionProfile>& conditionProfiles();
+const ConditionProfile* findConditionProfile(std::string_view name);
+
+struct ConditionerStats {
+    std::uint64_t submitted{0};
+    std::uint64_t delivered{0};
+    std::uint64_t lost{0};           // random (burst) loss
+    std::uint64_t queueDrops{0};     // bandwidth cap: queue longer than queueLimitMs
+    std::uint64_t overflowDrops{0};  // larger than MAX_DATAGRAM or too many in flight
+    std::uint64_t duplicated{0};
+    std::uint64_t reordered{0};
+    std::uint64_t bytesDelivered{0};
+};
+
+// One direction of an emulated network path. Datagrams go in with submit()
+// and come out of release() once their delivery time has passed, in delivery
+// order. Everything is decided at submit time from a seeded generator, so a
+// given seed and traffic pattern always produce the same drops and delays.
+//
+// Payloads are copied into a fixed slab; nothing is allocated per datagram.
+class LinkConditioner {
+public:
+    static constexpr std::size_t MAX_DATAGRAM = 1500;
+    static constexpr std::size_t UDP_OVERHEAD = 28;  // IPv4 + UDP headers count against the bandwidth cap
+
+    explicit LinkConditioner(std::uint32_t seed = 1, std::size_t capacity = 1024);
+
+    void setConditions(const LinkConditions& conditions) { cfg = conditions; }
+    const LinkConditions& conditions() const { return cfg; }
+
+    // Offer a datagram sent at nowMs; false if the link dropped it
+    bool submit(double nowMs, const std::uint8_t* data, std::size_t len);
+
+    // deliver(const std::uint8_t* data, std::size_t len) for every datagram due by nowMs
+    template <typename Deliver>
+    std::size_t release(double nowMs, Deliver&& deliver) {
+        std::size_t count = 0;
+        while (!heap.empty() && slots[heap.front()].releaseMs <= nowMs) {
+            std::pop_heap(heap.begin(), heap.end(), Later{slots});
+            const std::uint32_t index = heap.back();
+            heap.pop_back();
+            const Slot& slot = slots[index];
+            ++counters.delivered;
+            counters.bytesDelivered += slot.size;
+            deliver(static_cast<const std::uint8_t*>(slot.data.data()), static_cast<std::size_t>(slot.size));
+            freeSlots.push_back(index);
+            ++count;
+        }
+        return count;
+    }
+
+    double nextReleaseMs() const {
+        return heap.empty() ? std::numeric_limits<double>::infinity() : slots[heap.front()].releaseMs;
+    }
+    std::size_t inFlight() const { return heap.size(); }
+    const ConditionerStats& stats() const { return counters; }
+
+private:
+    struct Slot {
+        double releaseMs{0.0};
+        std::uint64_t order{0};  // ties release in submit order
+        std::uint16_t size{0};
+        std::array<std::uint8_t, MAX_DATAGRAM> data{};
+    };
+    // Min-heap on (releaseMs, order)
+    struct Later {
+        const std::vector<Slot>& slots;
+        bool operator()(std::uint32_t a, std::uint32_t b) const {
+            if (slots[a].releaseMs != slots[b].releaseMs) return slots[a].releaseMs > slots[b].releaseMs;
+            return slots[a].order > slots[b].order;
+        }
+    };
+
+    LinkConditions cfg;
+    std::mt19937 rng;
+    std::vector<Slot> slots;
+    std::vector<std::uint32_t> freeSlots;
+    std::vector<std::uint32_t> heap;
+    std::uint64_t nextOrder{0};
+    bool inLossBurst{false};
+    double linkFreeAtMs{0.0};   // when the capped link finishes serializing what it has
+    double lastInOrderMs{0.0};  // datagrams that are not reordered never overtake this
+    ConditionerStats counters;
+
+    bool chance(float percent);
+    bool loseNext();
+    double jitterSample();
+    bool schedule(double releaseMs, const std::uint8_t* data, std::size_t len);
+};
+
+// Both directions of a client's path, following a profile's phases over time
+class NetworkConditioner {
+public:
+    NetworkConditioner(const ConditionProfile& profile, std::uint32_t seed, double nowMs = 0.0);
+
+    // Switch to the phase the script is in at nowMs; call before submit/release
+    void update(double nowMs);
+
+    LinkConditioner& upstream() { return up; }
+    LinkConditioner& downstream() { return down; }
+    const LinkConditioner& upstream() const { return up; }
+    const LinkConditioner& downstream() const { return down; }
+    const ConditionPhase& phase() const { return script.phases[phaseIndex]; }
+
+private:
+    ConditionProfile script;
+    LinkConditioner up;
+    LinkConditioner down;
+    double cycleMs{0.0};
+    double startMs{0.0};
+    std::size_t phaseIndex{0};
+};
+
+} // namespace net
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace net {
+
+struct OutboxFlush {
+    std::size_t packets{0};
+    std::size_t bytes{0};
+    std::size_t messages{0};
+};
+
+// Per-peer coalescing of outgoing messages. Everything queued during a tick is
+// written, framed, into one buffer per channel; flush() then sends each buffer
+// as few packets as possible. A lone message goes out as-is (no framing cost),
+// several go out as Batch packets of at most maxPacketBytes; a message larger
+// than that is sent on its own.
+//
+// Reliable messages share ENet's ordered channel with anything sent directly,
+// so once a peer has reliable messages queued, later reliable sends to it must
+// be queued too (see queued()).
+class Outbox {
+public:
+    static constexpr std::size_t DEFAULT_PACKET_BYTES = 1200;  // stays under a typical path MTU
+
+    explicit Outbox(std::size_t maxPacketBytes = DEFAULT_PACKET_BYTES) : maxPacketBytes(maxPacketBytes) {}
+
+    // Queue a message of exactly size bytes written by fill(std::uint8_t* out)
+    template <typename Fill>
+    bool write(bool reliable, std::size_t size, Fill&& fill) {
+        if (size < 2 || size > MAX_FRAMED_MESSAGE) return false;
+        Channel& ch = channels[reliable ? 1 : 0];
+        const std::size_t at = ch.frames.size();
+        ch.frames.resize(at + FRAME_PREFIX_SIZE + size);
+        wire::store(ch.frames.data() + at, static_cast<std::uint16_t>(size));
+        fill(ch.frames.data() + at + FRAME_PREFIX_SIZE);
+        ++ch.count;
+        return true;
+    }
+
+    bool append(bool reliable, const std::uint8_t* data, std::size_t size) {
+        return write(reliable, size, [&](std::uint8_t* out) { std::memcpy(out, data, size); });
+    }
+
+    bool queued(bool reliable) const { return channels[reliable ? 1 : 0].count > 0; }
+    bool empty() const { return channels[0].count == 0 && channels[1].count == 0; }
+
+    // Send everything through sendWith(std::size_t size, bool reliable, fill),
+    // the shape of NetServer::sendWith bound to a peer and of NetClient::sendWith.
+    template <typename SendWith>
+    OutboxFlush flush(SendWith&& sendWith) {
+        OutboxFlush result;
+        for (int c = 0; c < 2; ++c) {
+            Channel& ch = channels[c];
+            const bool reliable = c == 1;
+            std::size_t pos = 0;
+            while (pos < ch.frames.size()) {
+                // Greedily take frames while the batch stays within the packet budget
+                std::size_t end = pos;
+                std::size_t count = 0;
+                std::size_t batchBytes = 2;
+                while (end < ch.frames.size()) {
+                    const std::size_t frame = FRAME_PREFIX_SIZE + frameSize(ch, end);
+                    if (count > 0 && batchBytes + frame > maxPacketBytes) break;
+                    batchBytes += frame;
+                    end += frame;
+                    ++count;
+                }
+
+                bool sent;
+                std::size_t bytes;
+                if (count == 1) {
+                    bytes = frameSize(ch, pos);
+                    const std::uint8_t* msg = ch.frames.data() + pos + FRAME_PREFIX_SIZE;
+                    sent = sendWith(bytes, reliable, [&](std::uint8_t* out) { std::memcpy(out, msg, bytes); });
+                } else {
+                    bytes = batchBytes;
+                    const std::uint8_t* framed = ch.frames.data() + pos;
+                    sent = sendWith(bytes, reliable, [&](std::uint8_t* out) {
+                        out = writeMessageHeader(out, MessageType::Batch);
+                        std::memcpy(out, framed, batchBytes - 2);
+                    });
+                }
+                if (sent) {
+                    ++result.packets;
+                    result.bytes += bytes;
+                    result.messages += count;
+                }
+                pos = end;
+            }
+            ch.frames.clear();  // keeps capacity: steady state does not allocate
+            ch.count = 0;
+        }
+        return result;
+    }
+
+    void clear() {
+        for (Channel& ch : channels) {
+            ch.frames.clear();
+            ch.count = 0;
+        }
+    }
+
+private:
+    struct Channel {
+        std::vector<std::uint8_t> frames;  // ([u16 length][message])*
+        std::size_t count{0};
+    };
+    Channel channels[2];  // unreliable, reliable
+    std::size_t maxPacketBytes;
+
+    static std::size_t frameSize(const Channel& ch, std::size_t at) {
+        std::uint16_t size = 0;
+        wire::load(ch.frames.data() + at, size);
+        return size;
+    }
+};
+
+} // namespace net
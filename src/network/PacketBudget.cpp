@@ -0,0 +1,51 @@
+#include "PacketBudget.h"
+#include "NetProtocol.h"
+
+namespace net {
+
+const char* dropReasonName(DropReason reason) {
+    switch (reason) {
+        case DropReason::None:       return "none";
+        case DropReason::Malformed:  return "malformed";
+        case DropReason::TooLarge:   return "too large";
+        case DropReason::ByteBudget: return "byte budget";
+        case DropReason::TypeBudget: return "type budget";
+        default:                     return "unknown";
+    }
+}
+
+PacketBudget::PacketBudget(const PacketBudgetConfig& config, double now) {
+    reset(config, now);
+}
+
+void PacketBudget::reset(const PacketBudgetConfig& config, double now) {
+    cfg = config;
+    bytes.configure(cfg.bytesPerSec, cfg.byteBurst, now);
+    for (auto& bucket : perType) bucket.configure(cfg.otherRate, cfg.otherBurst, now);
+    perType[static_cast<std::size_t>(MessageType::Input)].configure(cfg.inputRate, cfg.inputBurst, now);
+    perType[static_cast<std::size_t>(MessageType::InputBundle)].configure(cfg.inputRate, cfg.inputBurst, now);
+    perType[static_cast<std::size_t>(MessageType::Ping)].configure(cfg.pingRate, cfg.pingBurst, now);
+    strikes.configure(cfg.strikeRate, cfg.strikeBurst, now);
+    dropStats = PacketDropStats{};
+    abusive = false;
+}
+
+DropReason PacketBudget::admit(const std::uint8_t* data, std::size_t len, double now) {
+    if (len < 2 || data[0] != PROTOCOL_VERSION) return reject(DropReason::Malformed, now);
+    if (len > cfg.maxPacketBytes) return reject(DropReason::TooLarge, now);
+    if (data[1] == static_cast<std::uint8_t>(MessageType::Batch)) return DropReason::None;
+
+    // Type first: a flood of one message type must not drain the shared byte budget
+    const std::size_t slot = data[1] < TYPE_SLOTS ? data[1] : 0;
+    if (!perType[slot].tryConsume(1.f, now)) return reject(DropReason::TypeBudget, now);
+    if (!bytes.tryConsume(static_cast<float>(len), now)) return reject(DropReason::ByteBudget, now);
+    return DropReason::None;
+}
+
+DropReason PacketBudget::reject(DropReason reason, double now) {
+    dropStats.add(reason);
+    if (!strikes.tryConsume(1.f, now)) abusive = true;
+    return reason;
+}
+
+} // namespace net
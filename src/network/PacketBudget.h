@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace net {
+
+// Classic token bucket refilled lazily from timestamps, so idle peers cost nothing
+struct TokenBucket {
+    float tokens{0.f};
+    float capacity{0.f};
+    float refillPerSec{0.f};
+    double lastRefill{0.0};
+
+    void configure(float ratePerSec, float burst, double now) {
+        refillPerSec = ratePerSec;
+        capacity = burst;
+        tokens = burst;
+        lastRefill = now;
+    }
+
+    bool tryConsume(float amount, double now) {
+        const double elapsed = now - lastRefill;
+        if (elapsed > 0.0) {
+            tokens += static_cast<float>(elapsed) * refillPerSec;
+            if (tokens > capacity) tokens = capacity;
+            lastRefill = now;
+        }
+        if (tokens < amount) return false;
+        tokens -= amount;
+        return true;
+    }
+};
+
+// Inbound limits for one peer. Rates are per second, bursts in messages/bytes.
+struct PacketBudgetConfig {
+    std::size_t maxPacketBytes{1200};
+    float bytesPerSec{16384.f};
+    float byteBurst{8192.f};
+    float inputRate{120.f};      // clients send one input per frame; allow 2x headroom
+    float inputBurst{30.f};
+    float pingRate{4.f};
+    float pingBurst{4.f};
+    float otherRate{10.f};       // any other or unknown message type
+    float otherBurst{10.f};
+    float strikeRate{20.f};      // tolerated drops per second...
+    float strikeBurst{200.f};    // ...before the peer is treated as abusive
+};
+
+enum class DropReason : std::uint8_t {
+    None = 0,
+    Malformed,    // shorter than a header or wrong protocol version
+    TooLarge,
+    ByteBudget,
+    TypeBudget,
+    Count
+};
+
+struct PacketDropStats {
+    std::array<std::uint64_t, static_cast<std::size_t>(DropReason::Count)> byReason{};
+
+    std::uint64_t total() const {
+        std::uint64_t sum = 0;
+        for (auto n : byReason) sum += n;
+        return sum;
+    }
+    std::uint64_t count(DropReason reason) const { return byReason[static_cast<std::size_t>(reason)]; }
+    void add(DropReason reason) { ++byReason[static_cast<std::size_t>(reason)]; }
+};
+
+const char* dropReasonName(DropReason reason);
+
+// Per-peer admission of inbound packets. admit() looks only at the length and
+// the two header bytes, so floods are rejected before any parsing or copying.
+class PacketBudget {
+public:
+    explicit PacketBudget(const PacketBudgetConfig& config = {}, double now = 0.0);
+
+    void reset(const PacketBudgetConfig& config, double now);
+
+    // Returns DropReason::None if the packet may be processed. A Batch is only
+    // checked as a frame here; admit each message inside it on its own.
+    DropReason admit(const std::uint8_t* data, std::size_t len, double now);
+
+    // Count a drop decided after admission (e.g. malformed batch framing)
+    DropReason reject(DropReason reason, double now);
+
+    // True once drops have outrun the strike budget; the peer should be disconnected
+    bool isAbusive() const { return abusive; }
+
+    const PacketDropStats& drops() const { return dropStats; }
+
+private:
+    static constexpr std::size_t TYPE_SLOTS = 16;
+
+    PacketBudgetConfig cfg;
+    TokenBucket bytes;
+    std::array<TokenBucket, TYPE_SLOTS> perType;
+    TokenBucket strikes;
+    PacketDropStats dropStats;
+    bool abusive{false};
+};
+
+} // namespace net
@@ -0,0 +1,96 @@
+#include "PacketPool.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace net {
+
+namespace {
+void* poolMalloc(std::size_t size) { return PacketPool::instance().allocate(size); }
+void poolFree(void* memory) { PacketPool::instance().release(memory); }
+void poolNoMemory() {
+    std::cerr << "[PacketPool Error] Out of memory" << std::endl;
+    std::abort();
+}
+}
+
+PacketPool& PacketPool::instance() {
+    // Intentionally leaked: see class comment
+    static PacketPool* pool = new PacketPool();
+    return *pool;
+}
+
+const ENetCallbacks& PacketPool::enetCallbacks() {
+    static const ENetCallbacks callbacks{poolMalloc, poolFree, poolNoMemory};
+    return callbacks;
+}
+
+std::uint32_t PacketPool::classFor(std::size_t size) {
+    std::uint32_t sizeClass = 0;
+    while (sizeClass < CLASS_COUNT && blockSize(sizeClass) < size) ++sizeClass;
+    return sizeClass < CLASS_COUNT ? sizeClass : HEAP_CLASS;
+}
+
+void* PacketPool::allocate(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::uint32_t sizeClass = classFor(size);
+
+    void* block = nullptr;
+    if (sizeClass == HEAP_CLASS) {
+        heapFallbacks.fetch_add(1, std::memory_order_relaxed);
+        block = std::malloc(sizeof(BlockHeader) + size);
+    } else {
+        SizeClass& cls = classes[sizeClass];
+        {
+            std::lock_guard<std::mutex> lock(cls.mutex);
+            if (cls.head) {
+                block = cls.head;
+                cls.head = cls.head->next;
+                --cls.cached;
+            }
+        }
+        if (block) {
+            reused.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            block = std::malloc(sizeof(BlockHeader) + blockSize(sizeClass));
+        }
+    }
+    if (!block) return nullptr;
+
+    auto* header = static_cast<BlockHeader*>(block);
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+void PacketPool::release(void* memory) {
+    if (!memory) return;
+    auto* header = static_cast<BlockHeader*>(memory) - 1;
+    const std::uint32_t sizeClass = header->sizeClass;
+    if (sizeClass >= CLASS_COUNT) {
+        std::free(header);
+        return;
+    }
+
+    SizeClass& cls = classes[sizeClass];
+    {
+        std::lock_guard<std::mutex> lock(cls.mutex);
+        if (cls.cached < MAX_CACHED_PER_CLASS) {
+            auto* node = new (header) FreeBlock{cls.head};
+            cls.head = node;
+            ++cls.cached;
+            return;
+        }
+    }
+    std::free(header);
+}
+
+PacketPoolStats PacketPool::stats() const {
+    PacketPoolStats s;
+    s.allocations = allocations.load(std::memory_order_relaxed);
+    s.reused = reused.load(std::memory_order_relaxed);
+    s.heapFallbacks = heapFallbacks.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace net
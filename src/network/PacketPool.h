@@ -0,0 +1,65 @@
+#pragma once
+
+#include <enet/enet.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace net {
+
+struct PacketPoolStats {
+    std::uint64_t allocations{0};    // every enet_malloc
+    std::uint64_t reused{0};         // served from a free list
+    std::uint64_t heapFallbacks{0};  // too large for any size class
+};
+
+// Size-classed free lists behind ENet's allocator callbacks. ENet allocates a
+// packet header and a data buffer for every send and receive; after warm-up
+// both come from here instead of the heap. Blocks are kept (up to a cap per
+// class) rather than returned, and the pool is never destroyed so ENet hosts
+// torn down during static destruction can still free into it.
+class PacketPool {
+public:
+    static constexpr std::size_t MIN_BLOCK_SIZE = 32;
+    static constexpr std::size_t CLASS_COUNT = 8;   // 32 B .. 4 KiB
+    static constexpr std::size_t MAX_CACHED_PER_CLASS = 1024;
+
+    static PacketPool& instance();
+    // Callbacks for enet_initialize_with_callbacks
+    static const ENetCallbacks& enetCallbacks();
+
+    void* allocate(std::size_t size);
+    void release(void* memory);
+
+    PacketPoolStats stats() const;
+
+private:
+    PacketPool() = default;
+
+    // Prefix in front of every block so release() knows where it came from
+    struct alignas(alignof(std::max_align_t)) BlockHeader {
+        std::uint32_t sizeClass;
+    };
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    struct SizeClass {
+        std::mutex mutex;
+        FreeBlock* head{nullptr};
+        std::size_t cached{0};
+    };
+
+    static constexpr std::uint32_t HEAP_CLASS = 0xFFFFFFFFu;
+
+    static std::uint32_t classFor(std::size_t size);
+    static std::size_t blockSize(std::uint32_t sizeClass) { return MIN_BLOCK_SIZE << sizeClass; }
+
+    std::array<SizeClass, CLASS_COUNT> classes;
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> reused{0};
+    std::atomic<std::uint64_t> heapFallbacks{0};
+};
+
+} // namespace net
@@ -0,0 +1,36 @@
+#include "PeerSession.h"
+#include <algorithm>
+
+namespace net {
+
+PeerSessionPool::~PeerSessionPool() {
+    for (PeerSession* session : sessions) {
+        if (session->peer) session->peer->data = nullptr;
+        pool.destroy(session);
+    }
+    sessions.clear();
+}
+
+PeerSession* PeerSessionPool::attach(ENetPeer* peer) {
+    if (!peer) return nullptr;
+    detach(peer);
+    PeerSession* session = pool.create();
+    session->peer = peer;
+    peer->data = session;
+    sessions.push_back(session);
+    return session;
+}
+
+void PeerSessionPool::detach(ENetPeer* peer) {
+    PeerSession* session = PeerSession::from(peer);
+    if (!session) return;
+    peer->data = nullptr;
+    auto it = std::find(sessions.begin(), sessions.end(), session);
+    if (it != sessions.end()) {
+        *it = sessions.back();
+        sessions.pop_back();
+    }
+    pool.destroy(session);
+}
+
+} // namespace net
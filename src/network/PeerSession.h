@@ -0,0 +1,79 @@
+#pragma once
+
+#include "NetCommon.h"
+#include "NetProtocol.h"
+#include "InputHistory.h"
+#include "SnapshotRate.h"
+#include "SnapshotPriority.h"
+#include "PacketBudget.h"
+#include "Outbox.h"
+#include "utils/ObjectPool.h"
+#include <array>
+#include <vector>
+
+namespace net {
+
+constexpr std::size_t NO_PLAYER_SLOT = static_cast<std::size_t>(-1);
+
+struct PeerStats {
+    std::uint64_t packetsIn{0};
+    std::uint64_t bytesIn{0};
+    std::uint64_t packetsOut{0};
+    std::uint64_t bytesOut{0};
+    std::uint64_t inputsDropped{0};
+};
+
+enum class SessionRole : std::uint8_t {
+    Player,
+    Subscriber  // relay receiving the snapshot stream; controls no player
+};
+
+// Everything the server tracks per connected peer. Attached to ENetPeer::data
+// so packet handling is a pointer dereference instead of a map lookup.
+struct PeerSession {
+    ENetPeer* peer{nullptr};
+    SessionRole role{SessionRole::Player};
+    std::uint32_t playerId{0};
+    std::size_t playerSlot{NO_PLAYER_SLOT};  // Simulation slot of the controlled player
+    std::uint32_t resumeToken{0};            // reconnect credential, survives in checkpoints
+    InputQueue inputs;                       // lastApplied() is what InputAck reports
+    std::uint32_t receivedInputSequence{0};  // newest input queued (plain or bundled); repeats are dropped
+    // Newest snapshot sent to this peer. Clients do not ack snapshots: they are full
+    // state, never deltas, so no baseline is needed; InputAck carries the other direction
+    std::uint32_t lastSnapshotTick{0};
+    SnapshotRateController snapshotRate;
+    SnapshotPrioritizer snapshotPriority;    // used once the lobby outgrows the snapshot budget
+    PacketBudget budget;                     // inbound limits, checked before parsing
+    Outbox outbox;                           // messages coalesced until the end of the frame
+    bool disconnecting{false};               // server already asked this peer to leave
+    PeerStats stats;
+
+    static PeerSession* from(const ENetPeer* peer) {
+        return peer ? static_cast<PeerSession*>(peer->data) : nullptr;
+    }
+};
+
+// Owns all sessions; storage comes from a pool so connects don't hit the heap
+class PeerSessionPool {
+public:
+    PeerSessionPool() = default;
+    ~PeerSessionPool();
+
+    PeerSessionPool(const PeerSessionPool&) = delete;
+    PeerSessionPool& operator=(const PeerSessionPool&) = delete;
+
+    // Create a session and store it in peer->data
+    PeerSession* attach(ENetPeer* peer);
+    // Destroy the session stored in peer->data (no-op if none)
+    void detach(ENetPeer* peer);
+
+    const std::vector<PeerSession*>& active() const { return sessions; }
+    std::size_t size() const { return sessions.size(); }
+    bool empty() const { return sessions.empty(); }
+
+private:
+    ObjectPool<PeerSession> pool;
+    std::vector<PeerSession*> sessions;
+};
+
+} // namespace net
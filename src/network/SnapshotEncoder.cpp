@@ -0,0 +1,27 @@
+#include "SnapshotEncoder.h"
+#include "game/simulation/Simulation.h"
+
+namespace net {
+
+std::size_t snapshotSize(const Simulation& sim) {
+    return stateMessageSize(sim.playerCount());
+}
+
+std::uint8_t* encodeSnapshot(std::uint8_t* out, const Simulation& sim, std::uint32_t tick,
+                             std::uint32_t serverTimeMs) {
+    out = writeStateHeader(out, tick, serverTimeMs, sim.getArenaRadius(),
+                           static_cast<std::uint32_t>(sim.playerCount()));
+    sim.forEachPlayer([&out](const SimPlayer& p) {
+        PlayerState ps{};
+        ps.playerId = p.id;
+        ps.x = p.position.x;
+        ps.y = p.position.y;
+        ps.vx = p.velocity.x;
+        ps.vy = p.velocity.y;
+        ps.alive = p.alive ? 1 : 0;
+        out = wire::encode(out, ps);
+    });
+    return out;
+}
+
+} // namespace net
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+
+class Simulation;
+
+namespace net {
+
+// Exact size of the State message encodeSnapshot writes for this simulation
+std::size_t snapshotSize(const Simulation& sim);
+
+// Encode every player straight from the simulation's slots into out, which must
+// hold snapshotSize(sim) bytes (e.g. a packet from NetServer::createPacket).
+// One pass, no intermediate StateSnapshot, no allocation. Returns the end pointer.
+std::uint8_t* encodeSnapshot(std::uint8_t* out, const Simulation& sim, std::uint32_t tick,
+                             std::uint32_t serverTimeMs);
+
+} // namespace net
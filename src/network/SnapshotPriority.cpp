@@ -0,0 +1,101 @@
+#include "SnapshotPriority.h"
+#include <algorithm>
+#include <cmath>
+
+namespace net {
+
+namespace {
+// Sort keys above any accumulated priority: the viewer first, then overdue entities
+constexpr float kViewerKey = 1e9f;
+constexpr float kOverdueKey = 1e6f;
+}
+
+SnapshotPrioritizer::SnapshotPrioritizer(const SnapshotPriorityConfig& config) : cfg(config) {}
+
+void SnapshotPrioritizer::reset() {
+    entries.clear();
+    lastSelect = -1.0;
+}
+
+void SnapshotPrioritizer::select(const std::vector<PlayerState>& players,
+                                 const std::vector<PriorityCandidate>& candidates,
+                                 std::uint32_t viewerId, double now, std::size_t maxPlayers,
+                                 std::vector<PlayerState>& out) {
+    const float dt = lastSelect < 0.0 ? 0.f : static_cast<float>(std::max(0.0, now - lastSelect));
+    lastSelect = now;
+
+    float viewerX = 0.f;
+    float viewerY = 0.f;
+    bool hasViewer = false;
+    for (const PlayerState& p : players) {
+        if (p.playerId == viewerId) {
+            viewerX = p.x;
+            viewerY = p.y;
+            hasViewer = true;
+            break;
+        }
+    }
+
+    ranked.clear();
+    const std::size_t n = std::min(players.size(), candidates.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        const PlayerState& p = players[i];
+        const PriorityCandidate& c = candidates[i];
+        if (c.slot >= entries.size()) entries.resize(c.slot + 1);
+        Entry& e = entries[c.slot];
+
+        if (!e.known || e.playerId != p.playerId) {
+            // New occupant of the slot: send it as soon as possible
+            e = Entry{};
+            e.playerId = p.playerId;
+            e.known = true;
+            e.alive = p.alive != 0;
+            e.collisions = c.collisions;
+            e.sinceSent = cfg.maxStaleSec;
+        }
+
+        if (e.collisions != c.collisions || e.alive != (p.alive != 0)) {
+            e.collisions = c.collisions;
+            e.alive = p.alive != 0;
+            e.heat = 1.f;
+        } else if (cfg.eventDecaySec > 0.f) {
+            e.heat = std::max(0.f, e.heat - dt / cfg.eventDecaySec);
+        }
+
+        float weight = cfg.baseWeight + cfg.eventWeight * e.heat;
+        if (hasViewer) {
+            const float dist = std::hypot(p.x - viewerX, p.y - viewerY);
+            weight += cfg.nearWeight * cfg.nearFalloff / (cfg.nearFalloff + dist);
+        }
+        if (cfg.referenceSpeed > 0.f) {
+            weight += cfg.speedWeight * std::hypot(p.vx, p.vy) / cfg.referenceSpeed;
+        }
+        e.priority += weight * dt;
+        e.sinceSent += dt;
+
+        float key = e.priority;
+        if (p.playerId == viewerId) {
+            key = kViewerKey;
+        } else if (e.sinceSent >= cfg.maxStaleSec) {
+            key = kOverdueKey + e.sinceSent;
+        }
+        ranked.push_back({key, i});
+    }
+
+    const std::size_t take = std::min(maxPlayers, ranked.size());
+    auto byKey = [](const Ranked& a, const Ranked& b) { return a.key > b.key; };
+    if (take < ranked.size()) {
+        std::nth_element(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(take), ranked.end(), byKey);
+    }
+
+    out.clear();
+    for (std::size_t r = 0; r < take; ++r) {
+        const std::size_t i = ranked[r].index;
+        Entry& e = entries[candidates[i].slot];
+        e.priority = 0.f;
+        e.sinceSent = 0.f;
+        out.push_back(players[i]);
+    }
+}
+
+} // namespace net
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "NetProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace net {
+
+// Tuning for per-client snapshot prioritization
+struct SnapshotPriorityConfig {
+    float baseWeight{0.25f};        // every entity gains at least this much per second
+    float nearWeight{4.f};          // extra weight for an entity right next to the viewer...
+    float nearFalloff{300.f};       // ...halved at this distance (px)
+    float speedWeight{1.f};         // extra weight at referenceSpeed
+    float referenceSpeed{600.f};
+    float eventWeight{6.f};         // contact or elimination just happened...
+    float eventDecaySec{0.5f};      // ...fading out over this long
+    float maxStaleSec{1.0f};        // hard bound: nobody goes unrefreshed longer than this
+};
+
+// One entity offered to the prioritizer, parallel to the snapshot's players.
+// slot is a stable key for the entity (its Simulation slot).
+struct PriorityCandidate {
+    std::size_t slot{0};
+    std::uint32_t collisions{0};    // the simulation's running contact counter
+};
+
+// Per-client priority accumulator. Every call, each entity's priority grows by
+// its weight (proximity to the viewer, speed, recent contacts) times the time
+// elapsed; the highest priorities fill the packet and are reset to zero. The
+// viewer's own player is always included, and anything not sent for
+// maxStaleSec jumps the queue (stalest first), so every entity is refreshed
+// eventually; within maxStaleSec as long as maxPlayers * snapshot rate *
+// maxStaleSec covers the lobby.
+class SnapshotPrioritizer {
+public:
+    explicit SnapshotPrioritizer(const SnapshotPriorityConfig& config = {});
+
+    // Picks at most maxPlayers of players (with candidates parallel to it) into
+    // out. now is in seconds and only needs to be monotonic for this client.
+    void select(const std::vector<PlayerState>& players,
+                const std::vector<PriorityCandidate>& candidates,
+                std::uint32_t viewerId, double now, std::size_t maxPlayers,
+                std::vector<PlayerState>& out);
+
+    void reset();
+
+private:
+    struct Entry {
+        std::uint32_t playerId{0};
+        bool known{false};
+        bool alive{true};
+        std::uint32_t collisions{0};
+        float priority{0.f};
+        float heat{0.f};            // 1 right after an event, decays to 0
+        float sinceSent{0.f};
+    };
+
+    struct Ranked {
+        float key;
+        std::size_t index;
+    };
+
+    SnapshotPriorityConfig cfg;
+    std::vector<Entry> entries;     // indexed by candidate slot
+    std::vector<Ranked> ranked;     // scratch, reused every call
+    double lastSelect{-1.0};
+};
+
+// Player entries that fit a State message of at most byteBudget bytes
+constexpr std::size_t statePlayersForBudget(std::size_t byteBudget) {
+    return byteBudget > STATE_HEADER_SIZE ? (byteBudget - STATE_HEADER_SIZE) / wire::size<PlayerState> : 0;
+}
+
+} // namespace net
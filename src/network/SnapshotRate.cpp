@@ -0,0 +1,58 @@
+#include "SnapshotRate.h"
+#include <algorithm>
+
+namespace net {
+
+namespace {
+// Baseline RTT creeps upward slowly so a permanent route change is absorbed
+constexpr float kBaselineDriftMsPerSec = 2.f;
+}
+
+SnapshotRateController::SnapshotRateController(const SnapshotRateConfig& config)
+    : cfg(config), rate(std::clamp(config.initialRateHz, config.minRateHz, config.maxRateHz)) {}
+
+void SnapshotRateController::updateLink(const LinkStats& stats, float dt) {
+    sinceDecrease += dt;
+
+    if (stats.rttMs > 0.f) {
+        if (baselineRtt <= 0.f || stats.rttMs < baselineRtt) {
+            baselineRtt = stats.rttMs;
+        } else {
+            baselineRtt = std::min(stats.rttMs, baselineRtt + kBaselineDriftMsPerSec * dt);
+        }
+    }
+
+    const bool lossy = stats.packetLoss > cfg.lossThreshold;
+    const bool throttled = stats.throttle < cfg.throttleThreshold;
+    const bool queueing = baselineRtt > 0.f &&
+                          stats.rttMs > baselineRtt * cfg.rttInflation + cfg.rttSlackMs;
+    congested = lossy || throttled || queueing;
+
+    if (congested) {
+        cleanTime = 0.f;
+        // Back off hard, but give the previous decrease a chance to take effect first
+        if (sinceDecrease >= cfg.reactionTimeSec) {
+            rate = std::max(cfg.minRateHz, rate * cfg.decreaseFactor);
+            sinceDecrease = 0.f;
+        }
+        return;
+    }
+
+    cleanTime += dt;
+    if (cleanTime >= cfg.recoveryHoldSec) {
+        rate = std::min(cfg.maxRateHz, rate + cfg.increasePerSecond * dt);
+    }
+}
+
+bool SnapshotRateController::advance(float dt) {
+    const float interval = 1.f / rate;
+    timer += dt;
+    if (timer < interval) return false;
+    // Keep the remainder so the cadence holds between ticks, but after a stall
+    // (a whole interval or more overdue) start over: one snapshot, not a burst
+    timer -= interval;
+    if (timer >= interval) timer = 0.f;
+    return true;
+}
+
+} // namespace net
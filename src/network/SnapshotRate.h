@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+namespace net {
+
+// Tuning for the per-peer adaptive snapshot rate
+struct SnapshotRateConfig {
+    float minRateHz{10.f};          // floor: never starve a peer below this
+    float maxRateHz{60.f};          // ceiling: one snapshot per simulation tick
+    float initialRateHz{33.f};      // matches the old fixed 30ms cadence
+    float increasePerSecond{6.f};   // additive increase while the link is clean
+    float decreaseFactor{0.5f};     // multiplicative decrease on congestion
+    float lossThreshold{0.02f};     // packet loss fraction treated as congestion
+    float throttleThreshold{0.75f}; // ENet throttle fraction treated as congestion
+    float rttInflation{1.5f};       // RTT above baseline * this is congestion...
+    float rttSlackMs{20.f};         // ...plus a fixed slack for jittery links
+    float reactionTimeSec{0.25f};   // minimum spacing between two decreases
+    float recoveryHoldSec{1.0f};    // clean time required before increasing again
+};
+
+// Link quality as reported by the transport (ENet peer stats, normalized)
+struct LinkStats {
+    float rttMs{0.f};
+    float packetLoss{0.f};  // 0..1
+    float throttle{1.f};    // 0..1, 1 = unthrottled
+};
+
+// AIMD controller deciding how often one peer receives snapshots.
+// Driven by simulation time so the cadence stays aligned with ticks.
+class SnapshotRateController {
+public:
+    explicit SnapshotRateController(const SnapshotRateConfig& config = {});
+
+    // Feed the latest link stats; dt is the wall time since the last update
+    void updateLink(const LinkStats& stats, float dt);
+
+    // Advance the send timer; returns true when a snapshot is due (consumes it)
+    bool advance(float dt);
+
+    float rateHz() const { return rate; }
+    float intervalMs() const { return 1000.f / rate; }
+    bool isCongested() const { return congested; }
+    float baselineRttMs() const { return baselineRtt; }
+
+private:
+    SnapshotRateConfig cfg;
+    float rate;
+    float timer{0.f};
+    float baselineRtt{0.f};
+    float sinceDecrease{0.f};
+    float cleanTime{0.f};
+    bool congested{false};
+};
+
+} // namespace net
@@ -0,0 +1,839 @@
+#include "UdpBatchTransport.h"
+#include "WireFormat.h"
+
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__)
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103  // older libc headers; support is probed at runtime
+#endif
+#endif
+
+namespace net {
+
+#if defined(__linux__)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Every datagram starts with its kind; header fields after it are little-endian (net::wire)
+enum Kind : std::uint8_t {
+    KIND_CONNECT = 1,
+    KIND_ACCEPT = 2,
+    KIND_DATA = 3,
+    KIND_RELIABLE = 4,
+    KIND_ACK = 5,
+    KIND_DISCONNECT = 6,
+    KIND_PING = 7,
+    KIND_PONG = 8,
+    KIND_DISCONNECT_ACK = 9,
+    KIND_FRAGMENT = 10,       // one piece of an unreliable message over MAX_PAYLOAD
+    KIND_RELIABLE_PART = 11   // a reliable message piece; the final piece goes as KIND_RELIABLE
+};
+
+constexpr std::uint32_t CONNECT_MAGIC = 0x54554253;  // "SBUT"
+constexpr std::size_t HEADER_MAX = 5;                // kind + fragment id, index and count
+constexpr std::size_t SEND_STRIDE = UdpBatchTransport::MAX_PAYLOAD + HEADER_MAX;
+constexpr std::size_t RECV_STRIDE = 2048;
+constexpr std::size_t MAX_GSO_SEGMENTS = 64;
+constexpr std::size_t MAX_GSO_BYTES = 60000;
+constexpr auto CONNECT_RETRY = std::chrono::milliseconds(250);
+constexpr auto PING_INTERVAL = std::chrono::milliseconds(500);
+constexpr auto DEFAULT_TIMEOUT = std::chrono::seconds(5);
+constexpr auto MIN_RESEND = std::chrono::milliseconds(50);
+constexpr auto DISCONNECT_RETRY = std::chrono::milliseconds(100);
+constexpr auto CLOSE_LINGER = std::chrono::milliseconds(300);
+constexpr float LOSS_SMOOTHING = 0.1f;
+
+std::uint64_t addressKey(const sockaddr_in& a) {
+    return (static_cast<std::uint64_t>(a.sin_addr.s_addr) << 16) | a.sin_port;
+}
+
+// The ring index of a reliable sequence stays consistent across wraparound
+static_assert(65536 % UdpBatchTransport::MAX_UNACKED == 0, "MAX_UNACKED must divide the sequence space");
+// A whole fragmented message must fit the reliable window and the receive mask
+static_assert(UdpBatchTransport::MAX_FRAGMENTS <= UdpBatchTransport::MAX_UNACKED, "fragments must fit the window");
+static_assert(UdpBatchTransport::MAX_FRAGMENTS <= 64, "fragment mask is 64 bits");
+
+std::size_t fragmentCount(std::size_t len) {
+    return (len + UdpBatchTransport::MAX_PAYLOAD - 1) / UdpBatchTransport::MAX_PAYLOAD;
+}
+
+std::uint32_t nowMs() {
+    return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+struct UdpBatchTransport::Impl {
+    struct PeerSlot {
+        bool used{false};
+        bool connected{false};
+        bool closing{false};        // disconnect requested locally; reported once acked or timed out
+        sockaddr_in addr{};
+        Clock::time_point started{};
+        Clock::time_point lastRecv{};
+        Clock::time_point lastPing{};
+        Clock::time_point lastConnectSend{};
+        Clock::time_point lastResend{};
+        Clock::time_point closeStarted{};
+        Clock::time_point lastDisconnectSend{};
+        std::uint32_t connectData{0};
+        std::uint32_t disconnectData{0};
+        std::uint16_t nextSeq{0};     // sequence of the next reliable message we send
+        std::uint16_t ackedSeq{0};    // oldest unacked sequence
+        std::uint16_t expectedSeq{0}; // next reliable sequence we accept
+        // Unacked payloads indexed by sequence % MAX_UNACKED; the vectors keep
+        // their capacity across messages and connections, so sends don't allocate
+        std::array<std::vector<std::uint8_t>, MAX_UNACKED> unacked;
+        std::array<bool, MAX_UNACKED> unackedPart{};  // more pieces of the same message follow
+        std::vector<std::uint8_t> reliableAssembly;   // pieces received of the current reliable message
+        // Reassembly of one unreliable fragmented message at a time; a newer
+        // message abandons an incomplete older one
+        bool assembling{false};
+        std::uint16_t nextFragmentId{0};
+        std::uint16_t fragmentId{0};
+        std::size_t fragmentTotal{0};
+        std::size_t fragmentBytes{0};
+        std::uint64_t fragmentMask{0};
+        std::vector<std::uint8_t> fragments;
+        bool pingOutstanding{false};
+        float loss{0.f};              // smoothed fraction of unanswered pings
+
+        std::size_t inFlight() const { return static_cast<std::uint16_t>(nextSeq - ackedSeq); }
+        std::vector<std::uint8_t>& payload(std::uint16_t seq) { return unacked[seq % MAX_UNACKED]; }
+    };
+
+    int fd{-1};
+    Clock::duration timeout{DEFAULT_TIMEOUT};
+    bool serverMode{false};
+    bool gso{false};
+    std::vector<ENetPeer> peers;
+    std::vector<PeerSlot> slots;
+    std::unordered_map<std::uint64_t, std::size_t> slotByAddress;
+    UdpBatchStats stats;
+
+    // Preallocated syscall vectors
+    std::vector<std::uint8_t> sendBuffer = std::vector<std::uint8_t>(BATCH * SEND_STRIDE);
+    std::size_t sendLen[BATCH]{};
+    sockaddr_in sendAddr[BATCH]{};
+    iovec sendIov[BATCH]{};
+    mmsghdr sendMsgs[BATCH]{};
+    alignas(cmsghdr) std::uint8_t sendControl[BATCH][CMSG_SPACE(sizeof(std::uint16_t))]{};
+    std::size_t queued{0};
+
+    std::vector<std::uint8_t> recvBuffer = std::vector<std::uint8_t>(BATCH * RECV_STRIDE);
+    sockaddr_in recvAddr[BATCH]{};
+    iovec recvIov[BATCH]{};
+    mmsghdr recvMsgs[BATCH]{};
+
+    bool open(std::uint16_t port) {
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) return false;
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        int bufferSize = 4 * 1024 * 1024;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+        sockaddr_in bindAddr{};
+        bindAddr.sin_family = AF_INET;
+        bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+        bindAddr.sin_port = htons(port);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) != 0) {
+            std::cerr << "[UdpBatch Error] Failed to bind port " << port << ": " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+
+        // GSO is used only if the kernel accepts the socket option
+        int probe = 0;
+        gso = ::setsockopt(fd, SOL_UDP, UDP_SEGMENT, &probe, sizeof(probe)) == 0;
+
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            recvIov[i].iov_base = recvBuffer.data() + i * RECV_STRIDE;
+            recvIov[i].iov_len = RECV_STRIDE;
+            sendIov[i].iov_base = sendBuffer.data() + i * SEND_STRIDE;
+        }
+        return true;
+    }
+
+    void reset(std::size_t peerCount) {
+        peers.assign(peerCount, ENetPeer{});
+        slots.assign(peerCount, PeerSlot{});
+        slotByAddress.clear();
+        for (std::size_t i = 0; i < peerCount; ++i) {
+            peers[i].incomingPeerID = static_cast<enet_uint16>(i);
+            peers[i].state = ENET_PEER_STATE_DISCONNECTED;
+        }
+        queued = 0;
+    }
+
+    std::size_t indexOf(const ENetPeer* peer) const {
+        if (!peer || peers.empty() || peer < peers.data() || peer >= peers.data() + peers.size()) {
+            return static_cast<std::size_t>(-1);
+        }
+        return static_cast<std::size_t>(peer - peers.data());
+    }
+
+    // Back to a fresh slot, keeping the reliable and reassembly buffers for the next peer
+    void clearSlot(std::size_t i) {
+        auto buffers = std::move(slots[i].unacked);
+        auto assembly = std::move(slots[i].reliableAssembly);
+        auto fragments = std::move(slots[i].fragments);
+        slots[i] = PeerSlot{};
+        slots[i].unacked = std::move(buffers);
+        slots[i].reliableAssembly = std::move(assembly);
+        slots[i].reliableAssembly.clear();
+        slots[i].fragments = std::move(fragments);
+    }
+
+    std::size_t claimSlot(const sockaddr_in& addr) {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].used) continue;
+            clearSlot(i);
+            slots[i].used = true;
+            slots[i].addr = addr;
+            slots[i].started = slots[i].lastRecv = slots[i].lastPing = Clock::now();
+            slotByAddress[addressKey(addr)] = i;
+            ENetPeer& peer = peers[i];
+            peer.data = nullptr;
+            peer.eventData = 0;
+            peer.roundTripTime = ENET_PEER_DEFAULT_ROUND_TRIP_TIME;
+            peer.packetLoss = 0;
+            peer.packetThrottle = ENET_PEER_PACKET_THROTTLE_SCALE;
+            peer.address.host = addr.sin_addr.s_addr;
+            peer.address.port = ntohs(addr.sin_port);
+            peer.state = ENET_PEER_STATE_CONNECTING;
+            return i;
+        }
+        return static_cast<std::size_t>(-1);
+    }
+
+    void releaseSlot(std::size_t i) {
+        slotByAddress.erase(addressKey(slots[i].addr));
+        clearSlot(i);
+        peers[i].state = ENET_PEER_STATE_DISCONNECTED;
+    }
+
+    // Reserve a send slot for the address and return where its bytes go
+    std::uint8_t* beginDatagram(const sockaddr_in& to, std::size_t len) {
+        if (queued == BATCH) {
+            ++stats.sendQueueFull;
+            flush();
+        }
+        sendAddr[queued] = to;
+        sendLen[queued] = len;
+        return sendBuffer.data() + queued * SEND_STRIDE;
+    }
+    std::uint8_t* beginDatagram(std::size_t i, std::size_t len) { return beginDatagram(slots[i].addr, len); }
+    void commitDatagram() { ++queued; }
+
+    void sendControl1(std::size_t i, Kind kind) {
+        std::uint8_t* out = beginDatagram(i, 1);
+        out[0] = kind;
+        commitDatagram();
+    }
+
+    void sendControl32(std::size_t i, Kind kind, std::uint32_t value) {
+        std::uint8_t* out = beginDatagram(i, 5);
+        out[0] = kind;
+        net::wire::store(out + 1, value);
+        commitDatagram();
+    }
+
+    void sendConnect(std::size_t i) {
+        std::uint8_t* out = beginDatagram(i, 9);
+        out[0] = KIND_CONNECT;
+        net::wire::store(net::wire::store(out + 1, CONNECT_MAGIC), slots[i].connectData);
+        commitDatagram();
+        slots[i].lastConnectSend = Clock::now();
+    }
+
+    void sendAck(std::size_t i) {
+        std::uint8_t* out = beginDatagram(i, 3);
+        out[0] = KIND_ACK;
+        net::wire::store(out + 1, slots[i].expectedSeq);
+        commitDatagram();
+    }
+
+    void sendReliable(std::size_t i, std::uint16_t seq) {
+        const std::vector<std::uint8_t>& payload = slots[i].payload(seq);
+        std::uint8_t* out = beginDatagram(i, 3 + payload.size());
+        out[0] = slots[i].unackedPart[seq % MAX_UNACKED] ? KIND_RELIABLE_PART : KIND_RELIABLE;
+        net::wire::store(out + 1, seq);
+        std::memcpy(out + 3, payload.data(), payload.size());
+        commitDatagram();
+    }
+
+    void sendDisconnect(std::size_t i) {
+        sendControl32(i, KIND_DISCONNECT, slots[i].disconnectData);
+        slots[i].lastDisconnectSend = Clock::now();
+    }
+
+    // The disconnect is resent until the peer acks it or the timeout passes
+    void startClose(std::size_t i, std::uint32_t data) {
+        PeerSlot& slot = slots[i];
+        if (slot.closing) return;
+        slot.closing = true;
+        slot.disconnectData = data;
+        slot.closeStarted = Clock::now();
+        if (slot.connected) sendDisconnect(i);
+    }
+
+    bool sendData(std::size_t i, const std::uint8_t* data, std::size_t len, bool reliable) {
+        PeerSlot& slot = slots[i];
+        if (!slot.used || !slot.connected || slot.closing) return false;
+        if (len > MAX_MESSAGE) {
+            ++stats.oversizeDropped;
+            return false;
+        }
+        const std::size_t pieces = std::max<std::size_t>(1, fragmentCount(len));
+        if (pieces > 1) ++stats.fragmentedMessages;
+        if (reliable) {
+            // A peer this far behind is gone or hopelessly congested; dropping one
+            // message would break the ordered stream, so drop the peer instead
+            if (slot.inFlight() + pieces > MAX_UNACKED) {
+                ++stats.reliableOverflows;
+                startClose(i, 0);
+                return false;
+            }
+            // A copy of every piece is kept until acked
+            if (slot.inFlight() == 0) slot.lastResend = Clock::now();
+            for (std::size_t k = 0; k < pieces; ++k) {
+                const std::size_t offset = k * MAX_PAYLOAD;
+                const std::size_t chunk = std::min(MAX_PAYLOAD, len - offset);
+                slot.payload(slot.nextSeq).assign(data + offset, data + offset + chunk);
+                slot.unackedPart[slot.nextSeq % MAX_UNACKED] = k + 1 < pieces;
+                sendReliable(i, slot.nextSeq++);
+            }
+            return true;
+        }
+        if (pieces == 1) {
+            std::uint8_t* out = beginDatagram(i, 1 + len);
+            out[0] = KIND_DATA;
+            std::memcpy(out + 1, data, len);
+            commitDatagram();
+            return true;
+        }
+        // Equal-sized pieces to one peer, so GSO hands them over as one message
+        const std::uint16_t id = slot.nextFragmentId++;
+        for (std::size_t k = 0; k < pieces; ++k) {
+            const std::size_t offset = k * MAX_PAYLOAD;
+            const std::size_t chunk = std::min(MAX_PAYLOAD, len - offset);
+            std::uint8_t* out = beginDatagram(i, HEADER_MAX + chunk);
+            out[0] = KIND_FRAGMENT;
+            net::wire::store(out + 1, id);
+            out[3] = static_cast<std::uint8_t>(k);
+            out[4] = static_cast<std::uint8_t>(pieces);
+            std::memcpy(out + HEADER_MAX, data + offset, chunk);
+            commitDatagram();
+        }
+        return true;
+    }
+
+    // Collect one unreliable fragment; true once the whole message is in slot.fragments
+    bool collectFragment(PeerSlot& slot, const std::uint8_t* data, std::size_t len) {
+        if (len < HEADER_MAX) return false;
+        std::uint16_t id = 0;
+        net::wire::load(data + 1, id);
+        const std::size_t index = data[3];
+        const std::size_t total = data[4];
+        const std::size_t chunk = len - HEADER_MAX;
+        // Every piece but the last is exactly MAX_PAYLOAD bytes
+        if (total < 2 || total > MAX_FRAGMENTS || index >= total || chunk > MAX_PAYLOAD ||
+            (index + 1 < total && chunk != MAX_PAYLOAD)) {
+            return false;
+        }
+        if (!slot.assembling || id != slot.fragmentId) {
+            if (slot.assembling && static_cast<std::int16_t>(id - slot.fragmentId) < 0) return false;  // stale
+            slot.assembling = true;
+            slot.fragmentId = id;
+            slot.fragmentTotal = total;
+            slot.fragmentBytes = 0;
+            slot.fragmentMask = 0;
+            slot.fragments.resize(total * MAX_PAYLOAD);
+        }
+        const std::uint64_t bit = std::uint64_t{1} << index;
+        if (total != slot.fragmentTotal || (slot.fragmentMask & bit)) return false;
+        std::memcpy(slot.fragments.data() + index * MAX_PAYLOAD, data + HEADER_MAX, chunk);
+        slot.fragmentMask |= bit;
+        slot.fragmentBytes += chunk;
+        const std::uint64_t full = total == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << total) - 1;
+        if (slot.fragmentMask != full) return false;
+        slot.assembling = false;
+        return true;
+    }
+
+    void flush() {
+        if (fd < 0 || queued == 0) return;
+
+        // Group runs of equal-sized datagrams to one destination into GSO messages;
+        // the final segment of a run may be shorter
+        std::size_t msgCount = 0;
+        std::size_t i = 0;
+        while (i < queued) {
+            sendIov[i].iov_len = sendLen[i];
+            std::size_t j = i + 1;
+            if (gso) {
+                std::size_t bytes = sendLen[i];
+                while (j < queued && j - i < MAX_GSO_SEGMENTS &&
+                       addressKey(sendAddr[j]) == addressKey(sendAddr[i]) &&
+                       sendLen[j] <= sendLen[i] && bytes + sendLen[j] <= MAX_GSO_BYTES) {
+                    sendIov[j].iov_len = sendLen[j];
+                    bytes += sendLen[j];
+                    const bool shorter = sendLen[j] < sendLen[i];
+                    ++j;
+                    if (shorter) break;
+                }
+            }
+
+            mmsghdr& m = sendMsgs[msgCount];
+            m = mmsghdr{};
+            m.msg_hdr.msg_name = &sendAddr[i];
+            m.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            m.msg_hdr.msg_iov = &sendIov[i];
+            m.msg_hdr.msg_iovlen = j - i;
+            if (j - i > 1) {
+                m.msg_hdr.msg_control = sendControl[msgCount];
+                m.msg_hdr.msg_controllen = sizeof(sendControl[msgCount]);
+                cmsghdr* cm = CMSG_FIRSTHDR(&m.msg_hdr);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+                const auto segment = static_cast<std::uint16_t>(sendLen[i]);
+                std::memcpy(CMSG_DATA(cm), &segment, sizeof(segment));
+                ++stats.gsoMessages;
+            }
+            ++msgCount;
+            i = j;
+        }
+
+        std::size_t sent = 0;
+        while (sent < msgCount) {
+            const int r = ::sendmmsg(fd, sendMsgs + sent, static_cast<unsigned>(msgCount - sent), 0);
+            ++stats.sendCalls;
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EIO && gso) {
+                    // No segmentation offload on this route; the rest of this burst is
+                    // dropped like any lost datagram and reliable data is resent later
+                    std::cerr << "[UdpBatch Warning] GSO rejected by the kernel, disabling" << std::endl;
+                    gso = false;
+                }
+                break;
+            }
+            sent += static_cast<std::size_t>(r);
+        }
+        stats.datagramsOut += queued;
+        queued = 0;
+    }
+
+    void handleDatagram(const sockaddr_in& from, const std::uint8_t* data, std::size_t len,
+                        const std::function<void(ENetPeer*)>& onConnect,
+                        const std::function<void(ENetPeer*)>& onDisconnect,
+                        const std::function<void(ENetPeer*, const ENetPacket*)>& onPacket) {
+        if (len == 0) return;
+        const auto now = Clock::now();
+        auto it = slotByAddress.find(addressKey(from));
+
+        if (data[0] == KIND_CONNECT) {
+            if (!serverMode || len < 9) return;
+            std::uint32_t magic = 0;
+            net::wire::load(data + 1, magic);
+            if (magic != CONNECT_MAGIC) return;
+            if (it != slotByAddress.end()) {
+                if (!slots[it->second].closing) {
+                    sendControl1(it->second, KIND_ACCEPT);  // our accept was lost
+                    return;
+                }
+                // Reconnecting from the address of a peer we are still closing
+                peers[it->second].eventData = 0;
+                if (onDisconnect) onDisconnect(&peers[it->second]);
+                releaseSlot(it->second);
+            }
+            const std::size_t i = claimSlot(from);
+            if (i == static_cast<std::size_t>(-1)) return;  // full: let the client time out
+            net::wire::load(data + 5, slots[i].connectData);
+            slots[i].connected = true;
+            peers[i].eventData = slots[i].connectData;
+            peers[i].state = ENET_PEER_STATE_CONNECTED;
+            sendControl1(i, KIND_ACCEPT);
+            if (onConnect) onConnect(&peers[i]);
+            return;
+        }
+
+        if (it == slotByAddress.end()) {
+            // A resend of a disconnect we already handled; ack it so the sender stops
+            if (data[0] == KIND_DISCONNECT) {
+                beginDatagram(from, 1)[0] = KIND_DISCONNECT_ACK;
+                commitDatagram();
+            }
+            return;
+        }
+        const std::size_t i = it->second;
+        PeerSlot& slot = slots[i];
+        ENetPeer* peer = &peers[i];
+        slot.lastRecv = now;
+        // A closing peer only waits for the disconnect handshake
+        if (slot.closing && data[0] != KIND_DISCONNECT && data[0] != KIND_DISCONNECT_ACK) return;
+
+        switch (data[0]) {
+            case KIND_ACCEPT:
+                if (!slot.connected) {
+                    slot.connected = true;
+                    peer->state = ENET_PEER_STATE_CONNECTED;
+                    if (onConnect) onConnect(peer);
+                }
+                break;
+            case KIND_DATA: {
+                if (!slot.connected) break;
+                ENetPacket packet{};
+                packet.data = const_cast<std::uint8_t*>(data + 1);
+                packet.dataLength = len - 1;
+                if (onPacket) onPacket(peer, &packet);
+                break;
+            }
+            case KIND_FRAGMENT: {
+                if (!slot.connected || !collectFragment(slot, data, len)) break;
+                ENetPacket packet{};
+                packet.data = slot.fragments.data();
+                packet.dataLength = slot.fragmentBytes;
+                if (onPacket) onPacket(peer, &packet);
+                break;
+            }
+            case KIND_RELIABLE_PART:
+            case KIND_RELIABLE: {
+                if (!slot.connected || len < 3) break;
+                std::uint16_t seq = 0;
+                net::wire::load(data + 1, seq);
+                const bool inOrder = seq == slot.expectedSeq;
+                if (inOrder) ++slot.expectedSeq;
+                sendAck(i);  // cumulative, so duplicates still move the sender forward
+                if (!inOrder) break;
+                std::vector<std::uint8_t>& assembly = slot.reliableAssembly;
+                if (data[0] == KIND_RELIABLE_PART || !assembly.empty()) {
+                    // The stream is ordered, so pieces arrive back to back
+                    if (assembly.size() + (len - 3) > MAX_MESSAGE) {
+                        assembly.clear();
+                        break;
+                    }
+                    assembly.insert(assembly.end(), data + 3, data + len);
+                    if (data[0] == KIND_RELIABLE_PART) break;
+                }
+                ENetPacket packet{};
+                packet.flags = ENET_PACKET_FLAG_RELIABLE;
+                packet.data = assembly.empty() ? const_cast<std::uint8_t*>(data + 3) : assembly.data();
+                packet.dataLength = assembly.empty() ? len - 3 : assembly.size();
+                if (onPacket) onPacket(peer, &packet);
+                assembly.clear();
+                break;
+            }
+            case KIND_ACK: {
+                if (len < 3) break;
+                std::uint16_t next = 0;
+                net::wire::load(data + 1, next);
+                const auto acked = static_cast<std::uint16_t>(next - slot.ackedSeq);
+                if (acked == 0 || acked > slot.inFlight()) break;
+                slot.ackedSeq = next;
+                slot.lastResend = now;
+                break;
+            }
+            case KIND_PING:
+                if (len >= 5) {
+                    std::uint32_t stamp = 0;
+                    net::wire::load(data + 1, stamp);
+                    sendControl32(i, KIND_PONG, stamp);
+                }
+                break;
+            case KIND_PONG:
+                if (len >= 5) {
+                    std::uint32_t stamp = 0;
+                    net::wire::load(data + 1, stamp);
+                    const std::uint32_t sample = nowMs() - stamp;
+                    // Same 1/8 smoothing ENet applies to its RTT estimate
+                    peer->roundTripTime = peer->roundTripTime - peer->roundTripTime / 8 + sample / 8;
+                    peer->lastRoundTripTime = sample;
+                    slot.pingOutstanding = false;
+                    updateLoss(i, 0.f);
+                }
+                break;
+            case KIND_DISCONNECT:
+                // The sender's disconnect data, as ENet reports it in event.data
+                sendControl1(i, KIND_DISCONNECT_ACK);
+                peer->eventData = 0;
+                if (len >= 5 && !slot.closing) net::wire::load(data + 1, peer->eventData);
+                if (onDisconnect) onDisconnect(peer);
+                releaseSlot(i);
+                break;
+            case KIND_DISCONNECT_ACK:
+                if (!slot.closing) break;
+                peer->eventData = 0;
+                if (onDisconnect) onDisconnect(peer);
+                releaseSlot(i);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void runTimers(const std::function<void(ENetPeer*)>& onDisconnect) {
+        const auto now = Clock::now();
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            PeerSlot& slot = slots[i];
+            if (!slot.used) continue;
+            ENetPeer* peer = &peers[i];
+
+            if (slot.closing) {
+                // Nobody to tell before the handshake; otherwise wait for the ack
+                if (!slot.connected || now - slot.closeStarted > timeout) {
+                    peer->eventData = 0;
+                    if (onDisconnect) onDisconnect(peer);
+                    releaseSlot(i);
+                } else if (now - slot.lastDisconnectSend >= DISCONNECT_RETRY) {
+                    sendDisconnect(i);
+                }
+                continue;
+            }
+            if (!slot.connected) {
+                if (now - slot.started > timeout) {
+                    peer->eventData = 0;
+                    if (onDisconnect) onDisconnect(peer);
+                    releaseSlot(i);
+                } else if (now - slot.lastConnectSend >= CONNECT_RETRY) {
+                    sendConnect(i);
+                }
+                continue;
+            }
+            if (now - slot.lastRecv > timeout) {
+                peer->eventData = 0;
+                if (onDisconnect) onDisconnect(peer);
+                releaseSlot(i);
+                continue;
+            }
+            if (now - slot.lastPing >= PING_INTERVAL) {
+                if (slot.pingOutstanding) updateLoss(i, 1.f);
+                sendControl32(i, KIND_PING, nowMs());
+                slot.lastPing = now;
+                slot.pingOutstanding = true;
+            }
+
+            // Go-back-N: resend every unacked reliable message after ~2 RTT
+            const auto resendAfter = std::max<Clock::duration>(
+                MIN_RESEND, std::chrono::milliseconds(2 * peer->roundTripTime));
+            if (slot.inFlight() > 0 && now - slot.lastResend >= resendAfter) {
+                for (std::uint16_t seq = slot.ackedSeq; seq != slot.nextSeq; ++seq) sendReliable(i, seq);
+                stats.retransmits += slot.inFlight();
+                slot.lastResend = now;
+            }
+        }
+    }
+
+    // Handle everything pending, BATCH datagrams per syscall
+    void receive(const std::function<void(ENetPeer*)>& onConnect,
+                 const std::function<void(ENetPeer*)>& onDisconnect,
+                 const std::function<void(ENetPeer*, const ENetPacket*)>& onPacket) {
+        while (true) {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                mmsghdr& m = recvMsgs[i];
+                m = mmsghdr{};
+                m.msg_hdr.msg_name = &recvAddr[i];
+                m.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                m.msg_hdr.msg_iov = &recvIov[i];
+                m.msg_hdr.msg_iovlen = 1;
+            }
+            const int r = ::recvmmsg(fd, recvMsgs, BATCH, MSG_DONTWAIT, nullptr);
+            if (r <= 0) break;
+            ++stats.recvCalls;
+            stats.datagramsIn += static_cast<std::uint64_t>(r);
+            for (int k = 0; k < r; ++k) {
+                handleDatagram(recvAddr[k], static_cast<const std::uint8_t*>(recvIov[k].iov_base),
+                               recvMsgs[k].msg_len, onConnect, onDisconnect, onPacket);
+            }
+            if (static_cast<std::size_t>(r) < BATCH) break;
+        }
+    }
+
+    bool anyClosing() const {
+        for (const PeerSlot& slot : slots) {
+            if (slot.used && slot.closing) return true;
+        }
+        return false;
+    }
+
+    void updateLoss(std::size_t i, float sample) {
+        PeerSlot& slot = slots[i];
+        slot.loss += LOSS_SMOOTHING * (sample - slot.loss);
+        peers[i].packetLoss = static_cast<enet_uint32>(slot.loss * static_cast<float>(ENET_PEER_PACKET_LOSS_SCALE));
+    }
+};
+
+UdpBatchTransport::UdpBatchTransport() : impl(std::make_unique<Impl>()) {}
+UdpBatchTransport::~UdpBatchTransport() { close(); }
+
+bool UdpBatchTransport::supported() { return true; }
+
+bool UdpBatchTransport::listen(std::uint16_t port, std::size_t maxPeers) {
+    close();
+    if (!impl->open(port)) return false;
+    impl->serverMode = true;
+    impl->reset(maxPeers);
+    return true;
+}
+
+ENetPeer* UdpBatchTransport::connect(const std::string& host, std::uint16_t port, std::uint32_t connectData) {
+    close();
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (::getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        std::cerr << "[UdpBatch Error] Failed to resolve " << host << std::endl;
+        return nullptr;
+    }
+    sockaddr_in target = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+    ::freeaddrinfo(result);
+    target.sin_port = htons(port);
+
+    if (!impl->open(0)) return nullptr;
+    impl->serverMode = false;
+    impl->reset(1);
+    const std::size_t i = impl->claimSlot(target);
+    impl->slots[i].connectData = connectData;
+    impl->sendConnect(i);
+    impl->flush();
+    return &impl->peers[i];
+}
+
+void UdpBatchTransport::close() {
+    if (impl->fd < 0) return;
+    for (std::size_t i = 0; i < impl->slots.size(); ++i) {
+        if (impl->slots[i].used) impl->startClose(i, 0);
+    }
+    // Linger briefly, like ENet's disconnect, so a lost disconnect is resent;
+    // nothing is reported and no new peer is accepted meanwhile
+    impl->serverMode = false;
+    const auto deadline = Clock::now() + CLOSE_LINGER;
+    impl->flush();
+    while (impl->anyClosing() && Clock::now() < deadline) {
+        pollfd pfd{impl->fd, POLLIN, 0};
+        ::poll(&pfd, 1, 10);
+        impl->receive(nullptr, nullptr, nullptr);
+        impl->runTimers(nullptr);
+        impl->flush();
+    }
+    ::close(impl->fd);
+    impl->fd = -1;
+    impl->reset(0);
+}
+
+void UdpBatchTransport::setTimeout(std::uint32_t timeoutMs) {
+    impl->timeout = std::chrono::milliseconds(timeoutMs);
+}
+
+std::uint16_t UdpBatchTransport::localPort() const {
+    if (impl->fd < 0) return 0;
+    sockaddr_in bound{};
+    socklen_t length = sizeof(bound);
+    if (::getsockname(impl->fd, reinterpret_cast<sockaddr*>(&bound), &length) != 0) return 0;
+    return ntohs(bound.sin_port);
+}
+
+void UdpBatchTransport::service(int timeoutMs,
+                                const std::function<void(ENetPeer*)>& onConnect,
+                                const std::function<void(ENetPeer*)>& onDisconnect,
+                                const std::function<void(ENetPeer*, const ENetPacket*)>& onPacket) {
+    if (impl->fd < 0) return;
+    if (timeoutMs > 0) {
+        pollfd pfd{impl->fd, POLLIN, 0};
+        ::poll(&pfd, 1, timeoutMs);
+    }
+
+    impl->receive(onConnect, onDisconnect, onPacket);
+    impl->runTimers(onDisconnect);
+    impl->flush();
+}
+
+bool UdpBatchTransport::send(ENetPeer* peer, const std::uint8_t* data, std::size_t len, bool reliable) {
+    const std::size_t i = impl->indexOf(peer);
+    if (i >= impl->slots.size()) return false;
+    return impl->sendData(i, data, len, reliable);
+}
+
+bool UdpBatchTransport::broadcast(const std::uint8_t* data, std::size_t len, bool reliable) {
+    bool any = false;
+    for (std::size_t i = 0; i < impl->slots.size(); ++i) {
+        if (impl->slots[i].connected) any = impl->sendData(i, data, len, reliable) || any;
+    }
+    return any;
+}
+
+void UdpBatchTransport::flush() { impl->flush(); }
+
+void UdpBatchTransport::disconnect(ENetPeer* peer, std::uint32_t data) {
+    const std::size_t i = impl->indexOf(peer);
+    if (i >= impl->slots.size() || !impl->slots[i].used) return;
+    impl->startClose(i, data);
+}
+
+bool UdpBatchTransport::gsoEnabled() const { return impl->gso; }
+const UdpBatchStats& UdpBatchTransport::stats() const { return impl->stats; }
+
+#else // !__linux__
+
+struct UdpBatchTransport::Impl {
+    UdpBatchStats stats;
+};
+
+UdpBatchTransport::UdpBatchTransport() : impl(std::make_unique<Impl>()) {}
+UdpBatchTransport::~UdpBatchTransport() = default;
+
+bool UdpBatchTransport::supported() { return false; }
+
+bool UdpBatchTransport::listen(std::uint16_t, std::size_t) {
+    std::cerr << "[UdpBatch Error] Batched UDP transport requires Linux" << std::endl;
+    return false;
+}
+
+ENetPeer* UdpBatchTransport::connect(const std::string&, std::uint16_t, std::uint32_t) {
+    std::cerr << "[UdpBatch Error] Batched UDP transport requires Linux" << std::endl;
+    return nullptr;
+}
+
+void UdpBatchTransport::close() {}
+void UdpBatchTransport::setTimeout(std::uint32_t) {}
+std::uint16_t UdpBatchTransport::localPort() const { return 0; }
+void UdpBatchTransport::service(int, const std::function<void(ENetPeer*)>&,
+                                const std::function<void(ENetPeer*)>&,
+                                const std::function<void(ENetPeer*, const ENetPacket*)>&) {}
+bool UdpBatchTransport::send(ENetPeer*, const std::uint8_t*, std::size_t, bool) { return false; }
+bool UdpBatchTransport::broadcast(const std::uint8_t*, std::size_t, bool) { return false; }
+void UdpBatchTransport::flush() {}
+void UdpBatchTransport::disconnect(ENetPeer*, std::uint32_t) {}
+bool UdpBatchTransport::gsoEnabled() const { return false; }
+const UdpBatchStats& UdpBatchTransport::stats() const { return impl->stats; }
+
+#endif
+
+} // namespace net
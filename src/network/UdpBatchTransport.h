@@ -0,0 +1,95 @@
+#pragma once
+
+#include <enet/enet.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace net {
+
+struct UdpBatchStats {
+    std::uint64_t recvCalls{0};
+    std::uint64_t datagramsIn{0};
+    std::uint64_t sendCalls{0};
+    std::uint64_t datagramsOut{0};
+    std::uint64_t gsoMessages{0};      // sendmmsg entries carrying several segments
+    std::uint64_t retransmits{0};
+    std::uint64_t sendQueueFull{0};    // datagrams that forced an early flush
+    std::uint64_t oversizeDropped{0};  // sends larger than MAX_MESSAGE, refused
+    std::uint64_t fragmentedMessages{0};  // sends split across several datagrams
+    std::uint64_t reliableOverflows{0};  // peers dropped with MAX_UNACKED messages in flight
+};
+
+// Plain-UDP alternative to ENet that moves datagrams with recvmmsg/sendmmsg
+// from preallocated message vectors, so a tick's whole send burst costs one
+// syscall. Where the kernel supports UDP_SEGMENT (GSO), runs of equal-sized
+// datagrams to the same peer are handed over as a single message.
+//
+// It speaks a deliberately small protocol: a connect handshake carrying
+// connect data, keepalives that measure RTT and detect timeouts, unreliable
+// datagrams, and an ordered go-back-N reliable stream. Messages over
+// MAX_PAYLOAD are split into up to MAX_FRAGMENTS datagrams and reassembled
+// before delivery; an unreliable message missing a piece is dropped whole.
+// Each peer keeps at most MAX_UNACKED reliable datagrams in flight in buffers
+// it reuses; a peer that falls further behind is disconnected rather than
+// silently losing part of the stream. A disconnect is resent until the other
+// side acks it or the timeout passes. Peers are exposed as ENetPeer structs owned by the transport
+// (data, eventData, roundTripTime, packetLoss, packetThrottle, address and
+// state are maintained), so NetServer/NetClient keep their callback contract.
+//
+// Linux only; elsewhere supported() is false and listen/connect fail.
+class UdpBatchTransport {
+public:
+    static constexpr std::size_t BATCH = 64;           // datagrams per syscall
+    static constexpr std::size_t MAX_PAYLOAD = 1200;   // application bytes per datagram
+    static constexpr std::size_t MAX_FRAGMENTS = 64;   // datagrams one message may span
+    static constexpr std::size_t MAX_MESSAGE = MAX_PAYLOAD * MAX_FRAGMENTS;
+    static constexpr std::size_t MAX_UNACKED = 256;    // reliable datagrams in flight per peer
+
+    UdpBatchTransport();
+    ~UdpBatchTransport();
+
+    UdpBatchTransport(const UdpBatchTransport&) = delete;
+    UdpBatchTransport& operator=(const UdpBatchTransport&) = delete;
+
+    static bool supported();
+
+    // Server mode: accept up to maxPeers peers
+    bool listen(std::uint16_t port, std::size_t maxPeers);
+    // Client mode: a single outgoing peer, reported through onConnect once accepted
+    ENetPeer* connect(const std::string& host, std::uint16_t port, std::uint32_t connectData);
+    // Disconnects every peer, lingering a few hundred ms for their acks
+    void close();
+
+    // Connect and silence timeout for every peer, 5000 ms unless changed
+    void setTimeout(std::uint32_t timeoutMs);
+    // Port the socket is bound to (useful after listen(0)), 0 when closed
+    std::uint16_t localPort() const;
+
+    // Receive everything pending (waiting up to timeoutMs for the first
+    // datagram), run timers, then flush queued sends
+    void service(int timeoutMs,
+                 const std::function<void(ENetPeer*)>& onConnect,
+                 const std::function<void(ENetPeer*)>& onDisconnect,
+                 const std::function<void(ENetPeer*, const ENetPacket*)>& onPacket);
+
+    // Queue a datagram; it goes out on the next flush()/service()
+    bool send(ENetPeer* peer, const std::uint8_t* data, std::size_t len, bool reliable);
+    bool broadcast(const std::uint8_t* data, std::size_t len, bool reliable);
+    void flush();
+
+    // data reaches the other side's onDisconnect as peer->eventData (0 on timeouts);
+    // our own onDisconnect fires once the other side acks, or on timeout
+    void disconnect(ENetPeer* peer, std::uint32_t data = 0);
+
+    bool gsoEnabled() const;
+    const UdpBatchStats& stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace net
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Wire layout for protocol messages: packed, little-endian, independent of the
+// host struct's padding and byte order.
+//
+// Each message struct lists its serialized members once, in wire order:
+//
+//   template <> struct Wire<Ping> { using Layout = Fields<&Ping::timestampMs>; };
+//
+// Sizes and offsets are computed at compile time from that list (so the format
+// can be pinned with static_assert), and encode/decode expand to one fixed-size
+// copy per field; on little-endian hosts those are plain loads and stores.
+namespace net::wire {
+
+template <typename T>
+inline std::uint8_t* store(std::uint8_t* out, T value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "wire fields must be numbers or enums");
+    if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+        std::memcpy(out, &value, sizeof(T));
+    } else {
+        std::uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (std::size_t i = 0; i < sizeof(T); ++i) out[i] = bytes[sizeof(T) - 1 - i];
+    }
+    return out + sizeof(T);
+}
+
+template <typename T>
+inline const std::uint8_t* load(const std::uint8_t* in, T& value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "wire fields must be numbers or enums");
+    if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+        std::memcpy(&value, in, sizeof(T));
+    } else {
+        std::uint8_t bytes[sizeof(T)];
+        for (std::size_t i = 0; i < sizeof(T); ++i) bytes[i] = in[sizeof(T) - 1 - i];
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+    return in + sizeof(T);
+}
+
+// Descriptor of one serialized member
+template <auto Member>
+struct Field;
+
+template <typename C, typename M, M C::*Member>
+struct Field<Member> {
+    using Type = M;
+    static constexpr std::size_t size = sizeof(M);
+};
+
+template <auto... Members>
+struct Fields {
+    static constexpr std::size_t size = (Field<Members>::size + ...);
+
+    template <std::size_t I>
+    static constexpr std::size_t offset() {
+        static_assert(I < sizeof...(Members), "field index out of range");
+        constexpr std::size_t sizes[] = {Field<Members>::size...};
+        std::size_t at = 0;
+        for (std::size_t i = 0; i < I; ++i) at += sizes[i];
+        return at;
+    }
+
+    template <typename C>
+    static std::uint8_t* encode(std::uint8_t* out, const C& value) {
+        ((out = store(out, value.*Members)), ...);
+        return out;
+    }
+
+    template <typename C>
+    static const std::uint8_t* decode(const std::uint8_t* in, C& value) {
+        ((in = load(in, value.*Members)), ...);
+        return in;
+    }
+};
+
+// Specialized next to each message struct with its Fields<...> layout
+template <typename T>
+struct Wire;
+
+template <typename T>
+constexpr std::size_t size = Wire<T>::Layout::size;
+
+template <typename T, std::size_t I>
+constexpr std::size_t offset = Wire<T>::Layout::template offset<I>();
+
+template <typename T>
+inline std::uint8_t* encode(std::uint8_t* out, const T& value) {
+    return Wire<T>::Layout::encode(out, value);
+}
+
+template <typename T>
+inline const std::uint8_t* decode(const std::uint8_t* in, T& value) {
+    return Wire<T>::Layout::decode(in, value);
+}
+
+} // namespace net::wire
@@ -0,0 +1,221 @@
+#include "network/NetClient.h"
+#include "network/NetServer.h"
+#include "network/NetProtocol.h"
+#include "network/Outbox.h"
+#include "core/Profiler.h"
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Spectator relay: subscribes to a game server (or another relay) as a single
+// peer and re-broadcasts its stream to many spectators, optionally delayed.
+// Downstream peers are served exactly like a server serves subscribers, so
+// relays chain into a tree.
+namespace {
+
+struct PendingPacket {
+    std::chrono::steady_clock::time_point releaseAt;
+    std::vector<std::uint8_t> data;
+    bool reliable{false};
+};
+
+constexpr std::size_t MAX_SPARE_BUFFERS = 64;
+
+// Handshake and ping traffic is between this relay and its upstream only
+bool forwarded(const std::uint8_t* data, std::size_t len) {
+    net::MessageType type;
+    return net::parseHeader(data, len, type) && type != net::MessageType::JoinAccept &&
+           type != net::MessageType::Pong;
+}
+
+void printUsage() {
+    std::cout << "Usage: sumo_balls_relay <upstream-host> <upstream-port> [options]\n"
+              << "  --port PORT            port spectators connect to (default 7778)\n"
+              << "  --max-spectators N     downstream peer limit (default 256)\n"
+              << "  --delay-ms MS          hold the stream back by MS milliseconds (default 0)\n"
+              << "  --upstream-key KEY     subscriber key of the upstream server's --relay-key\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    const std::string upstreamHost = argv[1];
+    const auto upstreamPort = static_cast<std::uint16_t>(std::stoi(argv[2]));
+    std::uint16_t port = 7778;
+    std::size_t maxSpectators = 256;
+    int delayMs = 0;
+    std::uint32_t upstreamKey = 0;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = static_cast<std::uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--max-spectators" && i + 1 < argc) {
+            maxSpectators = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--delay-ms" && i + 1 < argc) {
+            delayMs = std::stoi(argv[++i]);
+        } else if (arg == "--upstream-key" && i + 1 < argc) {
+            upstreamKey = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    net::NetServer downstream;
+    if (!downstream.start(port, maxSpectators)) {
+        std::cerr << "Failed to start relay on port " << port << "\n";
+        return 1;
+    }
+    std::cout << "Relay listening on port " << port << ", upstream " << upstreamHost << ":"
+              << upstreamPort << ", delay " << delayMs << " ms\n";
+    PROFILE_THREAD_NAME("relay");
+
+    using Clock = std::chrono::steady_clock;
+    const auto delay = std::chrono::milliseconds(delayMs);
+    const auto reconnectInterval = std::chrono::seconds(2);
+
+    net::NetClient upstream;
+    bool upstreamConnected = false;
+    bool upstreamConnecting = false;
+    auto lastConnectAttempt = Clock::now() - reconnectInterval;
+
+    std::deque<PendingPacket> pending;
+    std::vector<std::vector<std::uint8_t>> spareBuffers;  // storage of released packets, reused
+    net::Outbox repack;                                   // rebuilds batches that lost a message
+    std::vector<std::uint8_t> latestSnapshot;  // handed to spectators as they join
+    std::vector<std::uint8_t> latestPhase;     // one-event MatchEvents, likewise
+    std::size_t spectators = 0;
+    const auto spectatorAccept = net::serializeJoinAccept(net::JoinAccept{net::SPECTATOR_PLAYER_ID});
+
+    // Packets still in the delay line belong to the subscription they came from
+    auto dropPending = [&]() {
+        for (PendingPacket& packet : pending) {
+            if (spareBuffers.size() < MAX_SPARE_BUFFERS) spareBuffers.push_back(std::move(packet.data));
+        }
+        pending.clear();
+    };
+    auto onUpstreamConnect = [&]() {
+        upstreamConnected = true;
+        upstreamConnecting = false;
+        // A (re)subscription may be to a restarted match: nothing from before it is current
+        dropPending();
+        latestSnapshot.clear();
+        latestPhase.clear();
+        std::cout << "Subscribed to upstream\n";
+    };
+    auto onUpstreamDisconnect = [&](net::DisconnectReason reason) {
+        upstreamConnected = false;
+        upstreamConnecting = false;
+        dropPending();
+        std::cout << "Upstream lost (" << net::disconnectReasonText(reason) << "), reconnecting\n";
+    };
+    auto queuePacket = [&](std::chrono::steady_clock::time_point releaseAt, bool reliable, std::size_t size,
+                           auto&& fill) {
+        std::vector<std::uint8_t> data;
+        if (!spareBuffers.empty()) {
+            data = std::move(spareBuffers.back());
+            spareBuffers.pop_back();
+        }
+        data.resize(size);
+        fill(data.data());
+        pending.push_back(PendingPacket{releaseAt, std::move(data), reliable});
+        return true;
+    };
+    auto onUpstreamPacket = [&](const ENetPacket* packet) {
+        if (!packet) return;
+        const bool reliable = (packet->flags & ENET_PACKET_FLAG_RELIABLE) != 0;
+        const auto releaseAt = Clock::now() + delay;
+        // Spectators get the server's packets, batches and all; only a batch that
+        // carried upstream-only messages is rebuilt from the rest
+        bool filtered = false;
+        if (!net::forEachMessage(packet->data, packet->dataLength, [&](const std::uint8_t* data, std::size_t len) {
+                if (!forwarded(data, len)) filtered = true;
+            })) {
+            return;
+        }
+        if (!filtered) {
+            queuePacket(releaseAt, reliable, packet->dataLength, [&](std::uint8_t* out) {
+                std::memcpy(out, packet->data, packet->dataLength);
+            });
+            return;
+        }
+        net::forEachMessage(packet->data, packet->dataLength, [&](const std::uint8_t* data, std::size_t len) {
+            if (forwarded(data, len)) repack.append(reliable, data, len);
+        });
+        repack.flush([&](std::size_t size, bool packetReliable, auto&& fill) {
+            return queuePacket(releaseAt, packetReliable, size, fill);
+        });
+    };
+
+    auto onSpectatorConnect = [&](ENetPeer* peer) {
+        ++spectators;
+        downstream.sendTo(peer, spectatorAccept, true);
+        // The server tells its own joiners the phase right behind the accept; so does the relay
+        if (!latestPhase.empty()) downstream.sendTo(peer, latestPhase, true);
+        if (!latestSnapshot.empty()) downstream.sendTo(peer, latestSnapshot, false);
+    };
+    auto onSpectatorDisconnect = [&](ENetPeer*) {
+        if (spectators > 0) --spectators;
+    };
+    net::DecodedMessage spectatorMessage;
+    auto onSpectatorPacket = [&](ENetPeer* peer, const ENetPacket* packet) {
+        if (!packet || !net::decodeMessage(packet->data, packet->dataLength, spectatorMessage).isSuccess()) return;
+        // Spectators can measure their RTT to the relay and sync to the server
+        // clock through it (the relay's own estimate); everything else is ignored
+        if (spectatorMessage.type == net::MessageType::Ping) {
+            const net::ClockEstimate server = upstream.serverNow();
+            const net::Pong pong{spectatorMessage.ping.timestampMs,
+                                 static_cast<std::uint32_t>(server.serverMs > 0.0 ? server.serverMs : 0.0)};
+            downstream.sendTo(peer, net::serializePong(pong), false);
+        }
+    };
+
+    while (true) {
+        PROFILE_SCOPE("Relay::frame");
+        const auto now = Clock::now();
+        if (!upstreamConnected && !upstreamConnecting && now - lastConnectAttempt >= reconnectInterval) {
+            lastConnectAttempt = now;
+            upstreamConnecting = upstream.connect(upstreamHost, upstreamPort, upstreamKey);
+        }
+
+        upstream.service(0, onUpstreamConnect, onUpstreamDisconnect, onUpstreamPacket);
+        downstream.service(0, onSpectatorConnect, onSpectatorDisconnect, onSpectatorPacket);
+
+        // One broadcast packet is shared by every spectator (ENet refcounts it)
+        const auto releaseNow = Clock::now();
+        while (!pending.empty() && pending.front().releaseAt <= releaseNow) {
+            PendingPacket& out = pending.front();
+            if (spectators > 0) downstream.broadcast(out.data, out.reliable);
+            net::forEachMessage(out.data.data(), out.data.size(), [&](const std::uint8_t* data, std::size_t len) {
+                net::MessageType type;
+                if (!net::parseHeader(data, len, type)) return;
+                if (type == net::MessageType::State) {
+                    latestSnapshot.assign(data, data + len);
+                } else if (type == net::MessageType::MatchEvents) {
+                    // Eliminations happen within a phase; every other event starts one
+                    net::readMatchEvents(data, len, [&](std::uint32_t tick, const net::MatchEvent& event) {
+                        if (event.type == net::MatchEventType::Eliminated) return;
+                        latestPhase.resize(net::matchEventsSize(1));
+                        net::writeMatchEvents(latestPhase.data(), tick, &event, 1);
+                    });
+                }
+            });
+            if (spareBuffers.size() < MAX_SPARE_BUFFERS) spareBuffers.push_back(std::move(out.data));
+            pending.pop_front();
+        }
+
+        PROFILE_POLL_DUMP();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return 0;
+}
@@ -1,84 +1,644 @@
 #include "network/NetServer.h"
 #include "network/NetProtocol.h"
+#include "network/PeerSession.h"
+#include "network/CoordinatorHeartbeat.h"
+#include "network/LockstepRelay.h"
+#include "network/SnapshotEncoder.h"
 #include "game/simulation/Simulation.h"
+#include "game/controllers/BotManager.h"
+#include "game/replay/ReplayRecorder.h"
+#include "game/checkpoint/MatchCheckpoint.h"
+#include "game/match/MatchFlow.h"
+#include "core/Profiler.h"
 
 #include "utils/VectorMath.h"
+#include <algorithm>
 #include <iostream>
-#include <unordered_map>
 #include <thread>
 #include <chrono>
 #include <cmath>
-
-struct ClientInfo {
-    std::uint32_t playerId{0};
-};
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
 
 int main(int argc, char** argv) {
     std::uint16_t port = 7777;
-    if (argc >= 2) {
-        port = static_cast<std::uint16_t>(std::stoi(argv[1]));
+    std::string replayDir = "replays";
+    float profileEverySec = 0.f;
+    BotConfig botConfig;
+    std::uint32_t relayKey = 0;
+    net::Transport transport = net::Transport::ENet;
+    std::string checkpointPath;  // default derived from the port below
+    bool checkpointEnabled = true;
+    float checkpointEverySec = 1.f;
+    float resumeWithinSec = net::RESUME_WITHIN_SEC;
+    float maxLoad = 0.85f;
+    std::size_t snapshotBudget = 1200;
+    std::size_t maxPlayers = 8;
+    std::size_t lockstepPlayers = 0;  // 0 = authoritative simulation
+    std::uint32_t lockstepHashEvery = 30;
+    net::HeartbeatIdentity heartbeatIdentity;
+    heartbeatIdentity.host = "127.0.0.1";
+    // Kept out of argv (and ps) unless given explicitly
+    if (const char* secret = std::getenv("SERVER_SECRET")) heartbeatIdentity.secret = secret;
+    float heartbeatEverySec = 5.f;
+    net::PacketBudgetConfig budgetConfig;
+    match::MatchFlowConfig matchConfig;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay-dir" && i + 1 < argc) {
+            replayDir = argv[++i];
+        } else if (arg == "--no-replay") {
+            replayDir.clear();
+        } else if (arg == "--bots" && i + 1 < argc) {
+            botConfig.targetPlayers = static_cast<std::size_t>(std::stoi(argv[++i]));
+        } else if (arg == "--bot-budget-ms" && i + 1 < argc) {
+            botConfig.budgetMs = std::stof(argv[++i]);
+        } else if (arg == "--transport" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "batched") {
+                transport = net::Transport::BatchedUdp;
+            } else if (name != "enet") {
+                std::cerr << "Unknown transport '" << name << "' (expected enet or batched)\n";
+                return 1;
+            }
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--no-checkpoint") {
+            checkpointEnabled = false;
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            checkpointEverySec = std::stof(argv[++i]);
+        } else if (arg == "--resume-within" && i + 1 < argc) {
+            resumeWithinSec = std::stof(argv[++i]);
+        } else if (arg == "--snapshot-budget" && i + 1 < argc) {
+            snapshotBudget = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--max-load" && i + 1 < argc) {
+            maxLoad = std::stof(argv[++i]);
+        } else if (arg == "--input-rate" && i + 1 < argc) {
+            budgetConfig.inputRate = std::stof(argv[++i]);
+        } else if (arg == "--max-players" && i + 1 < argc) {
+            maxPlayers = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--coordinator" && i + 1 < argc) {
+            heartbeatIdentity.coordinatorUrl = argv[++i];
+        } else if (arg == "--coordinator-secret" && i + 1 < argc) {
+            heartbeatIdentity.secret = argv[++i];
+        } else if (arg == "--server-id" && i + 1 < argc) {
+            heartbeatIdentity.serverId = argv[++i];
+        } else if (arg == "--public-host" && i + 1 < argc) {
+            heartbeatIdentity.host = argv[++i];
+        } else if (arg == "--heartbeat-every" && i + 1 < argc) {
+            heartbeatEverySec = std::stof(argv[++i]);
+        } else if (arg == "--lockstep" && i + 1 < argc) {
+            lockstepPlayers = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--hash-every" && i + 1 < argc) {
+            lockstepHashEvery = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--relay-key" && i + 1 < argc) {
+            relayKey = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--countdown" && i + 1 < argc) {
+            matchConfig.countdownSec = std::stof(argv[++i]);
+        } else if (arg == "--profile-every" && i + 1 < argc) {
+            profileEverySec = std::stof(argv[++i]);
+        } else {
+            port = static_cast<std::uint16_t>(std::stoi(arg));
+        }
+    }
+
+    // Replays and checkpoints hold a fixed number of balls; more would go unrecorded
+    std::size_t ballLimit = std::numeric_limits<std::size_t>::max();
+    if (lockstepPlayers == 0 && !replayDir.empty()) ballLimit = std::min(ballLimit, replay::MAX_PLAYERS);
+    if (lockstepPlayers == 0 && checkpointEnabled) {
+        ballLimit = std::min<std::size_t>(ballLimit, checkpoint::MAX_PLAYERS);
+    }
+    if (maxPlayers > ballLimit) {
+        std::cout << "--max-players " << maxPlayers << " lowered to " << ballLimit
+                  << ", the most replays and checkpoints can hold\n";
+        maxPlayers = ballLimit;
+    }
+    if (botConfig.targetPlayers > ballLimit) {
+        std::cout << "--bots " << botConfig.targetPlayers << " lowered to " << ballLimit
+                  << ", the most replays and checkpoints can hold\n";
+        botConfig.targetPlayers = ballLimit;
     }
 
     net::NetServer server;
-    if (!server.start(port, 8)) {
+    if (!server.start(port, maxPlayers, transport)) {
         std::cerr << "Failed to start server on port " << port << "\n";
         return 1;
     }
-    std::cout << "Authoritative server listening on port " << port << "\n";
+    std::cout << "Authoritative server listening on port " << port
+              << (transport == net::Transport::BatchedUdp ? " (batched UDP)" : "") << "\n";
+    if (lockstepPlayers > 0) {
+        // Peers run the simulation; the server only relays inputs, so there is
+        // no server-side state to drive bots, checkpoint or record
+        botConfig.targetPlayers = 0;
+        checkpointEnabled = false;
+        replayDir.clear();
+        std::cout << "Lockstep mode: match starts with " << lockstepPlayers << " players, state hashes every "
+                  << lockstepHashEvery << " ticks (bots, checkpoints and replays disabled)\n";
+    }
+    if (botConfig.targetPlayers > 0) {
+        std::cout << "Filling matches to " << botConfig.targetPlayers << " players with bots ("
+                  << botConfig.budgetMs << " ms/tick budget)\n";
+    }
+
+#if defined(SUMO_PROFILING)
+    // Traces are dumped on SIGUSR1 and optionally every --profile-every seconds
+    auto& profiler = profiling::Profiler::instance();
+    profiler.setOutputPrefix("server_profile");
+    profiler.installSignalHandler();
+    profiler.setAutoDumpInterval(profileEverySec);
+    PROFILE_THREAD_NAME("server");
+#else
+    (void)profileEverySec;
+#endif
 
     Simulation sim(300.f, {600.f, 450.f});
-    std::unordered_map<ENetPeer*, ClientInfo> peers;
+    net::PeerSessionPool sessions;
+    std::size_t humanCount = 0;
+    BotManager bots(sim, botConfig);
     std::uint32_t nextPlayerId = 1;
 
     auto startTime = std::chrono::steady_clock::now();
     auto last = startTime;
     float accumulator = 0.f;
     const float fixedDt = 1.f / 60.f;
-    float snapshotTimer = 0.f;
     std::uint32_t tick = 0;
 
+    // A match is recorded from the first connect until the server empties again
+    replay::ReplayRecorder recorder;
+    auto startRecording = [&]() {
+        if (replayDir.empty()) return;
+        std::error_code ec;
+        std::filesystem::create_directories(replayDir, ec);
+        const auto unixMs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        replay::ReplayHeader header;
+        header.tickRate = 60;
+        header.arenaRadius = sim.getArenaRadius();
+        header.arenaCenterX = sim.arenaCenter.x;
+        header.arenaCenterY = sim.arenaCenter.y;
+        header.startUnixMs = unixMs;
+        const std::string file = replayDir + "/match_" + std::to_string(unixMs) + ".sbr";
+        if (recorder.begin(file, header)) {
+            std::cout << "Recording match to " << file << "\n";
+        }
+    };
+    auto stopRecording = [&]() {
+        if (!recorder.isRecording()) return;
+        const auto stats = recorder.stats();
+        // The writer thread flushes the rest and writes the index; the tick goes on
+        recorder.finish();
+        std::cout << "Replay closing (" << stats.framesQueued << " frames, "
+                  << stats.framesDropped << " dropped)\n";
+    };
+
+    // Spawn players in a ring
+    auto spawnFor = [](std::uint32_t id) {
+        const float angle = static_cast<float>(id % 6) / 6.f * 6.2831853f;
+        return Vec2(600.f + 200.f * std::cos(angle), 450.f + 200.f * std::sin(angle));
+    };
+
+    // Rounds: countdown, play until one ball is left, show the result, repeat.
+    // Phase changes and eliminations go to every peer as reliable MatchEvents.
+    match::MatchFlow matchFlow(matchConfig);
+    std::vector<net::MatchEvent> matchEvents;
+    std::vector<std::uint8_t> matchEventMessage;
+
+    // Crash resume: the match is checkpointed to a mapped file while it runs.
+    // Humans restored from it, or whose connection dropped, have resumeGrace to
+    // reconnect with their token; their ball stands still meanwhile.
+    constexpr float resumeGraceSec = net::RESUME_GRACE_SEC;
+    struct ResumableSeat {
+        std::uint32_t playerId{0};
+        std::chrono::steady_clock::time_point deadline;
+    };
+    std::unordered_map<std::uint32_t, ResumableSeat> resumable;  // resume token -> seat
+    auto holdSeat = [&](std::uint32_t token, std::uint32_t playerId) {
+        sim.applyInput(playerId, {0.f, 0.f});
+        resumable[token] = {playerId, std::chrono::steady_clock::now() +
+                                          std::chrono::milliseconds(static_cast<int>(resumeGraceSec * 1000.f))};
+    };
+
+    // Bots only play while at least one human is connected or may come back,
+    // topping the match up to --bots balls in total
+    auto balanceBots = [&]() {
+        const std::size_t target = humanCount + resumable.size() == 0 ? 0 : botConfig.targetPlayers;
+        while (sim.playerCount() < target) {
+            const std::uint32_t id = nextPlayerId++;
+            bots.addBot(id, spawnFor(id));
+            recorder.recordEvent(tick, replay::EventType::PlayerJoined, id);
+        }
+        while (bots.count() > 0 && sim.playerCount() > target) {
+            recorder.recordEvent(tick, replay::EventType::PlayerLeft, bots.removeAny());
+        }
+    };
+
+    checkpoint::CheckpointFile checkpointFile;
+    checkpoint::MatchState checkpointState;
+    float checkpointTimer = 0.f;
+    std::mt19937 tokenRng{std::random_device{}()};
+
+    auto newResumeToken = [&]() {
+        std::uint32_t token = 0;
+        while (token == net::CONNECT_PLAYER || token == relayKey || resumable.count(token) > 0) {
+            token = tokenRng();
+        }
+        return token;
+    };
+
+    if (checkpointEnabled) {
+        if (checkpointPath.empty()) checkpointPath = "checkpoints/server_" + std::to_string(port) + ".sbck";
+        std::error_code ec;
+        const auto dir = std::filesystem::path(checkpointPath).parent_path();
+        if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+
+        if (checkpointFile.open(checkpointPath) && checkpointFile.load(checkpointState)) {
+            const auto nowUnixMs = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count());
+            const double ageSec = static_cast<double>(nowUnixMs - checkpointState.savedUnixMs) / 1000.0;
+            if (checkpointState.savedUnixMs <= nowUnixMs && ageSec <= resumeWithinSec) {
+                checkpoint::restoreSimulation(checkpointState, sim);
+                tick = checkpointState.tick;
+                nextPlayerId = checkpointState.nextPlayerId;
+                for (std::uint32_t i = 0; i < checkpointState.playerCount; ++i) {
+                    const auto& p = checkpointState.players[i];
+                    if (p.flags & checkpoint::PLAYER_BOT) {
+                        bots.adoptBot(p.id);
+                    } else {
+                        holdSeat(p.resumeToken, p.id);
+                    }
+                }
+                matchFlow.resumePlaying(sim);
+                std::cout << "Resumed match at tick " << tick << " from " << checkpointPath << " ("
+                          << ageSec << " s old, " << resumable.size() << " players may reconnect)\n";
+            } else {
+                checkpointFile.clear();
+            }
+        }
+    }
+
+    bool checkpointTruncated = false;
+    auto writeCheckpoint = [&]() {
+        PROFILE_SCOPE("Server::checkpoint");
+        const std::uint32_t left = checkpoint::captureSimulation(sim, checkpointState);
+        if (left > 0 && !checkpointTruncated) {
+            checkpointTruncated = true;
+            std::cout << "Checkpoint holds " << checkpoint::MAX_PLAYERS << " players; " << left
+                      << " more cannot be resumed\n";
+        }
+        checkpointState.tick = tick;
+        checkpointState.nextPlayerId = nextPlayerId;
+        checkpointState.savedUnixMs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        for (std::uint32_t i = 0; i < checkpointState.playerCount; ++i) {
+            auto& p = checkpointState.players[i];
+            if (bots.isBot(p.id)) p.flags |= checkpoint::PLAYER_BOT;
+        }
+        auto setToken = [&](std::uint32_t playerId, std::uint32_t token) {
+            for (std::uint32_t i = 0; i < checkpointState.playerCount; ++i) {
+                if (checkpointState.players[i].id == playerId) checkpointState.players[i].resumeToken = token;
+            }
+        };
+        for (net::PeerSession* session : sessions.active()) {
+            if (session->role == net::SessionRole::Player) setToken(session->playerId, session->resumeToken);
+        }
+        for (const auto& [token, seat] : resumable) setToken(seat.playerId, token);
+        checkpointFile.write(checkpointState);
+    };
+
+    // Load = busy fraction of wall time over the last second; above --max-load
+    // new players are turned away so the ones already playing keep their tick
+    double frameNowSec = 0.0;
+    float serverLoad = 0.f;
+    double loadBusySec = 0.0;
+    double loadWindowStart = 0.0;
+    std::uint64_t connectionsRefused = 0;
+    net::PacketDropStats inboundDrops;
+    std::uint64_t lastReportedDrops = 0;
+    double lastDropReport = 0.0;
+
+    auto attachSession = [&](ENetPeer* peer) {
+        net::PeerSession* session = sessions.attach(peer);
+        session->budget.reset(budgetConfig, frameNowSec);
+        return session;
+    };
+
+    // Lockstep: once enough players are in, the roster is frozen and every tick
+    // the server relays one input frame; peers report state hashes back
+    net::LockstepRelay lockstep;
+    std::vector<net::LockstepPlayer> lockstepRoster;
+
+    auto startLockstep = [&]() {
+        lockstepRoster.clear();
+        std::vector<std::uint32_t> ids;
+        sim.forEachPlayer([&](const SimPlayer& p) {
+            lockstepRoster.push_back({p.id, p.position.x, p.position.y});
+            ids.push_back(p.id);
+        });
+        net::LockstepStartHeader header;
+        header.startTick = tick;
+        header.tickRateHz = static_cast<std::uint32_t>(std::lround(1.f / fixedDt));
+        header.hashInterval = lockstepHashEvery;
+        header.arenaRadius = sim.getArenaRadius();
+        header.arenaCenterX = sim.arenaCenter.x;
+        header.arenaCenterY = sim.arenaCenter.y;
+        header.playerCount = static_cast<std::uint32_t>(lockstepRoster.size());
+        for (net::PeerSession* session : sessions.active()) {
+            if (session->role != net::SessionRole::Player) continue;
+            session->outbox.write(true, net::lockstepStartSize(lockstepRoster.size()), [&](std::uint8_t* out) {
+                net::writeLockstepStart(out, header, lockstepRoster.data());
+            });
+        }
+        // Inputs queued before the start were meant for the server's simulation,
+        // not for the first lockstep frames
+        for (net::PeerSession* session : sessions.active()) session->inputs.clear();
+        lockstep.begin(tick, lockstepHashEvery, ids);
+        std::cout << "Lockstep match started at tick " << tick << " with " << ids.size() << " players\n";
+    };
+
+    auto endLockstep = [&](net::DisconnectReason reason) {
+        for (net::PeerSession* session : sessions.active()) {
+            if (session->role == net::SessionRole::Player) server.disconnect(session->peer, reason);
+        }
+        std::cout << "Lockstep match ended after " << lockstep.framesSent() << " frames ("
+                  << lockstep.desyncs() << " desyncs)\n";
+        lockstep.end();
+    };
+
+    // A packet shared by many peers goes out directly, unless the peer already
+    // has messages queued on that channel this frame: then it joins them (one
+    // copy, one datagram fewer, and channel order is kept).
+    auto sendShared = [&](net::PeerSession* session, ENetPacket* packet, bool reliable) {
+        if (session->outbox.queued(reliable)) {
+            return session->outbox.append(reliable, packet->data, packet->dataLength);
+        }
+        if (!server.sendPacket(session->peer, packet, reliable)) return false;
+        session->stats.packetsOut++;
+        session->stats.bytesOut += packet->dataLength;
+        return true;
+    };
+
+    auto lockstepTick = [&]() {
+        if (!lockstep.running()) return;
+        for (net::PeerSession* session : sessions.active()) {
+            net::InputCommand cmd{};
+            if (session->inputs.popForTick(cmd)) lockstep.setInput(session->playerId, cmd.dirX, cmd.dirY);
+        }
+        net::LockstepFrameHeader header;
+        const std::vector<net::LockstepInput>& inputs = lockstep.nextFrame(header);
+        // One reliable packet shared by every peer; frames must not be lost or reordered
+        ENetPacket* framePacket = net::NetServer::createPacket(net::lockstepFrameSize(inputs.size()), true);
+        if (!framePacket) return;
+        net::writeLockstepFrame(framePacket->data, header, inputs.data());
+        for (net::PeerSession* session : sessions.active()) {
+            if (session->role == net::SessionRole::Player) sendShared(session, framePacket, true);
+        }
+        net::NetServer::releasePacket(framePacket);
+    };
+
+    // A completed hash check that disagrees drops the minority, which may in turn
+    // complete ticks that were only waiting on them; without a majority the match ends
+    auto settleHashChecks = [&](std::vector<net::HashCheck> checks) {
+        for (std::size_t i = 0; i < checks.size() && lockstep.running(); ++i) {
+            const net::HashCheck check = checks[i];
+            if (check.agreed) continue;
+            std::cout << "Lockstep desync at tick " << check.tick << " (" << check.outliers.size() << " of "
+                      << lockstep.activePlayers() << " peers disagree)\n";
+            if (!check.hasMajority) {
+                endLockstep(net::DisconnectReason::Desync);
+                return;
+            }
+            for (std::uint32_t playerId : check.outliers) {
+                for (net::PeerSession* other : sessions.active()) {
+                    if (other->role == net::SessionRole::Player && other->playerId == playerId &&
+                        !other->disconnecting) {
+                        other->disconnecting = true;
+                        server.disconnect(other->peer, net::DisconnectReason::Desync);
+                    }
+                }
+                const std::vector<net::HashCheck> unblocked = lockstep.dropPlayer(playerId);
+                checks.insert(checks.end(), unblocked.begin(), unblocked.end());
+            }
+        }
+    };
+
+    auto onLockstepHash = [&](net::PeerSession* session, const net::StateHash& report) {
+        const net::HashCheck check = lockstep.submitHash(session->playerId, report);
+        if (check.complete) settleHashChecks({check});
+    };
+
+    // Joiners also learn the match phase, right behind the accept on the same channel
+    auto queueJoinAccept = [&](net::PeerSession* session, const net::JoinAccept& msg) {
+        session->outbox.write(true, net::messageSize<net::JoinAccept>(), [&](std::uint8_t* out) {
+            net::writeMessage(out, net::MessageType::JoinAccept, msg);
+        });
+        if (lockstepPlayers > 0) return;
+        const net::MatchEvent phase = matchFlow.currentPhase();
+        session->outbox.write(true, net::matchEventsSize(1), [&](std::uint8_t* out) {
+            net::writeMatchEvents(out, tick, &phase, 1);
+        });
+    };
+
+    // One message per tick with events, encoded once and queued for every peer
+    auto sendMatchEvents = [&]() {
+        for (std::size_t at = 0; at < matchEvents.size(); at += net::MAX_MATCH_EVENTS) {
+            const std::size_t count = std::min(net::MAX_MATCH_EVENTS, matchEvents.size() - at);
+            matchEventMessage.resize(net::matchEventsSize(count));
+            net::writeMatchEvents(matchEventMessage.data(), tick, matchEvents.data() + at, count);
+            for (net::PeerSession* session : sessions.active()) {
+                session->outbox.append(true, matchEventMessage.data(), matchEventMessage.size());
+            }
+        }
+    };
+
+    // A new round puts every ball back at its spawn; slots (and so sessions) are kept
+    std::vector<std::uint32_t> roundPlayers;
+    auto startRound = [&]() {
+        roundPlayers.clear();
+        sim.forEachPlayer([&](const SimPlayer& p) { roundPlayers.push_back(p.id); });
+        for (std::uint32_t id : roundPlayers) sim.addPlayer(id, spawnFor(id));
+    };
+
     auto onConnect = [&](ENetPeer* peer) {
+        const std::uint32_t connectData = net::NetServer::connectData(peer);
+        if (relayKey != 0 && connectData == relayKey) {
+            // Relays only subscribe to the snapshot stream and fan it out to spectators
+            net::PeerSession* session = attachSession(peer);
+            session->role = net::SessionRole::Subscriber;
+            session->playerId = net::SPECTATOR_PLAYER_ID;
+            queueJoinAccept(session, net::JoinAccept{net::SPECTATOR_PLAYER_ID});
+            std::cout << "Relay subscribed\n";
+            return;
+        }
+        if (connectData != net::CONNECT_PLAYER && lockstepPlayers == 0) {
+            // The client may be back before its old connection timed out here;
+            // the new connection takes the session's seat over
+            for (net::PeerSession* old : sessions.active()) {
+                if (old->role != net::SessionRole::Player || old->resumeToken != connectData) continue;
+                if (old->disconnecting) break;
+                const std::uint32_t playerId = old->playerId;
+                ENetPeer* oldPeer = old->peer;
+                sessions.detach(oldPeer);  // its disconnect then finds no session
+                server.disconnect(oldPeer);
+                --humanCount;
+                holdSeat(connectData, playerId);
+                break;
+            }
+        }
+        auto resumed = resumable.find(connectData);
+        if (connectData != net::CONNECT_PLAYER && resumed != resumable.end()) {
+            // A client reclaiming its ball after a server restart or a dropped connection
+            if (!recorder.isRecording()) startRecording();
+            ++humanCount;
+            net::PeerSession* session = attachSession(peer);
+            session->playerId = resumed->second.playerId;
+            session->playerSlot = sim.slotOf(session->playerId);
+            session->resumeToken = connectData;
+            resumable.erase(resumed);
+            queueJoinAccept(session, net::JoinAccept{session->playerId, session->resumeToken});
+            std::cout << "Client resumed playerId=" << session->playerId << "\n";
+            return;
+        }
+        if (connectData != net::CONNECT_PLAYER) {
+            std::cout << "Rejected connection with unknown connect data " << connectData << "\n";
+            server.disconnect(peer, net::DisconnectReason::Rejected);
+            return;
+        }
+        if (lockstep.running()) {
+            server.disconnect(peer, net::DisconnectReason::MatchInProgress);
+            return;
+        }
+        if (serverLoad > maxLoad) {
+            ++connectionsRefused;
+            std::cout << "Refused new player: server load " << serverLoad << " > " << maxLoad
+                      << " (" << connectionsRefused << " refused so far)\n";
+            server.disconnect(peer, net::DisconnectReason::ServerBusy);
+            return;
+        }
+
         std::uint32_t id = nextPlayerId++;
-        peers[peer] = ClientInfo{id};
+        if (!recorder.isRecording()) startRecording();
+        ++humanCount;
+        net::PeerSession* session = attachSession(peer);
+        session->playerId = id;
+        session->resumeToken = newResumeToken();
 
-        // Spawn players in a ring
-        const float angle = static_cast<float>(id % 6) / 6.f * 6.2831853f;
-        Vec2 spawn(600.f + 200.f * std::cos(angle), 450.f + 200.f * std::sin(angle));
-        sim.addPlayer(id, spawn);
+        // A joining human takes over a living bot's ball where it stands
+        const std::uint32_t botId = bots.releaseForHuman();
+        if (botId != 0 && sim.reassignPlayer(botId, id)) {
+            session->playerSlot = sim.slotOf(id);
+            recorder.recordEvent(tick, replay::EventType::PlayerLeft, botId);
+            std::cout << "Client replaces bot " << botId << "\n";
+        } else {
+            session->playerSlot = sim.addPlayer(id, spawnFor(id));
+        }
+        recorder.recordEvent(tick, replay::EventType::PlayerJoined, id);
+        balanceBots();
 
-        net::JoinAccept msg{ id };
-        server.sendTo(peer, net::serializeJoinAccept(msg), true);
+        queueJoinAccept(session, net::JoinAccept{id, session->resumeToken});
         std::cout << "Client connected, assigned playerId=" << id << "\n";
+        if (lockstepPlayers > 0 && humanCount >= lockstepPlayers) startLockstep();
     };
 
     auto onDisconnect = [&](ENetPeer* peer) {
-        auto it = peers.find(peer);
-        if (it != peers.end()) {
-            sim.removePlayer(it->second.playerId);
-            peers.erase(it);
-            std::cout << "Client disconnected\n";
+        net::PeerSession* session = net::PeerSession::from(peer);
+        if (session && session->role == net::SessionRole::Subscriber) {
+            sessions.detach(peer);
+            std::cout << "Relay unsubscribed\n";
+        } else if (session) {
+            --humanCount;
+            // A dropped player keeps their ball for resumeGrace; players the server
+            // sent away, and lockstep peers (fixed roster), leave right away
+            const bool canResume = lockstepPlayers == 0 && !session->disconnecting && session->resumeToken != 0;
+            if (canResume) {
+                holdSeat(session->resumeToken, session->playerId);
+                std::cout << "Client disconnected, playerId=" << session->playerId << " may resume for "
+                          << resumeGraceSec << " s\n";
+            } else {
+                if (lockstep.running()) settleHashChecks(lockstep.dropPlayer(session->playerId));
+                sim.removePlayer(session->playerId);
+                recorder.recordEvent(tick, replay::EventType::PlayerLeft, session->playerId);
+                std::cout << "Client disconnected\n";
+            }
+            sessions.detach(peer);
+            balanceBots();
+            if (humanCount == 0) {
+                if (lockstep.running()) endLockstep(net::DisconnectReason::None);
+                if (resumable.empty()) {
+                    stopRecording();
+                    checkpointFile.clear();  // nothing left to resume
+                }
+            }
         }
     };
 
-    auto onPacket = [&](ENetPeer* peer, const ENetPacket* packet) {
-        if (!packet || packet->dataLength < 2) return;
-        net::MessageType type;
-        if (!net::parseHeader(packet->data, packet->dataLength, type)) return;
+    auto onDrop = [&](ENetPeer* peer, net::PeerSession* session, net::DropReason drop) {
+        inboundDrops.add(drop);
+        if (session->budget.isAbusive() && !session->disconnecting) {
+            session->disconnecting = true;
+            std::cout << "Disconnecting client " << session->playerId << ": flooding ("
+                      << session->budget.drops().total() << " packets dropped)\n";
+            server.disconnect(peer, net::DisconnectReason::Abuse);
+        }
+    };
 
-        switch (type) {
-            case net::MessageType::Input: {
-                if (packet->dataLength < 2 + sizeof(net::InputCommand)) return;
-                net::InputCommand cmd{};
-                std::memcpy(&cmd, packet->data + 2, sizeof(net::InputCommand));
-                sim.applyInput(cmd.playerId, {cmd.dirX, cmd.dirY});
+    // One message, on its own or out of a Batch; decoded into reused storage
+    net::DecodedMessage decoded;
+    // Input and InputBundle share one sequence space: bundles repeat recent inputs
+    // and a plain Input may repeat a bundled one, so only sequences not seen yet
+    // are queued. Unsequenced (0) inputs always are.
+    auto receiveInput = [&](net::PeerSession* session, const net::InputCommand& cmd) {
+        if (cmd.sequence != 0) {
+            if (cmd.sequence <= session->receivedInputSequence) return;
+            session->receivedInputSequence = cmd.sequence;
+        }
+        if (!session->inputs.push(cmd)) session->stats.inputsDropped++;
+    };
+
+    auto onMessage = [&](ENetPeer* peer, net::PeerSession* session, const std::uint8_t* data, std::size_t len) {
+        // Budgets are checked on the raw header bytes, before any parsing
+        const net::DropReason drop = session->budget.admit(data, len, frameNowSec);
+        if (drop != net::DropReason::None) {
+            onDrop(peer, session, drop);
+            return;
+        }
+
+        // Malformed messages count against the peer like any other drop
+        if (!net::decodeMessage(data, len, decoded).isSuccess()) {
+            onDrop(peer, session, session->budget.reject(net::DropReason::Malformed, frameNowSec));
+            return;
+        }
+
+        switch (decoded.type) {
+            case net::MessageType::Input:
+                if (session->role != net::SessionRole::Player) return;
+                // The session decides which player moves, not the packet
+                receiveInput(session, decoded.input);
+                break;
+            case net::MessageType::InputBundle:
+                if (session->role != net::SessionRole::Player) return;
+                net::forEachBundledInput(decoded.inputBundle, decoded.bundleEntries, [&](const net::InputCommand& cmd) {
+                    receiveInput(session, cmd);
+                });
+                break;
+            case net::MessageType::StateHash:
+                if (!lockstep.running() || session->role != net::SessionRole::Player) return;
+                onLockstepHash(session, decoded.stateHash);
                 break;
-            }
             case net::MessageType::Ping: {
-                if (packet->dataLength < 2 + sizeof(net::Ping)) return;
-                net::Ping ping{};
-                std::memcpy(&ping, packet->data + 2, sizeof(net::Ping));
-                auto data = net::serializePing(net::MessageType::Pong, ping);
-                server.sendTo(peer, data, false);
+                // Answered with the rest of this frame's traffic to the peer, stamped
+                // with the snapshot clock as of receipt (the wait is inside the RTT)
+                const net::Pong pong{decoded.ping.timestampMs, static_cast<std::uint32_t>(frameNowSec * 1000.0)};
+                session->outbox.write(false, net::messageSize<net::Pong>(), [&](std::uint8_t* out) {
+                    net::writeMessage(out, net::MessageType::Pong, pong);
+                });
                 break;
             }
             default:
@@ -86,42 +646,244 @@ int main(int argc, char** argv) {
         }
     };
 
+    auto onPacket = [&](ENetPeer* peer, const ENetPacket* packet) {
+        net::PeerSession* session = net::PeerSession::from(peer);
+        if (!session || !packet) return;
+        session->stats.packetsIn++;
+        session->stats.bytesIn += packet->dataLength;
+
+        const bool batch = packet->dataLength >= 2 &&
+                           packet->data[1] == static_cast<std::uint8_t>(net::MessageType::Batch);
+        if (!batch) {
+            onMessage(peer, session, packet->data, packet->dataLength);
+            return;
+        }
+        // The batch is checked once as a frame; each message in it then counts
+        // against the budgets by itself, so batching cannot dodge the per-type limits
+        const net::DropReason drop = session->budget.admit(packet->data, packet->dataLength, frameNowSec);
+        if (drop != net::DropReason::None) {
+            onDrop(peer, session, drop);
+            return;
+        }
+        const bool framed = net::forEachMessage(packet->data, packet->dataLength,
+                                                [&](const std::uint8_t* data, std::size_t len) {
+                                                    onMessage(peer, session, data, len);
+                                                });
+        if (!framed) onDrop(peer, session, session->budget.reject(net::DropReason::Malformed, frameNowSec));
+    };
+
+    net::StateSnapshot snap;  // prioritization input, reused every frame; keeps its player capacity
+    net::StateSnapshot partial;  // per-client subset for prioritized snapshots
+    std::vector<net::PriorityCandidate> candidates;
+
+    // Capacity heartbeats let the coordinator place matches on the least-loaded server
+    auto currentCapacity = [&]() {
+        net::ServerCapacity capacity;
+        capacity.maxPlayers = static_cast<std::uint32_t>(maxPlayers);
+        capacity.humans = static_cast<std::uint32_t>(humanCount + resumable.size());
+        capacity.bots = static_cast<std::uint32_t>(bots.count());
+        capacity.peers = static_cast<std::uint32_t>(sessions.size());
+        capacity.tickLoad = serverLoad;
+        return capacity;
+    };
+    std::unique_ptr<net::CoordinatorHeartbeat> heartbeat;
+    if (!heartbeatIdentity.coordinatorUrl.empty()) {
+        if (heartbeatIdentity.serverId.empty()) heartbeatIdentity.serverId = "server_" + std::to_string(port);
+        heartbeatIdentity.port = port;
+        heartbeat = std::make_unique<net::CoordinatorHeartbeat>(heartbeatIdentity, heartbeatEverySec);
+        heartbeat->publish(currentCapacity());
+        heartbeat->start();
+        if (heartbeatIdentity.secret.empty()) {
+            std::cout << "No coordinator secret (--coordinator-secret or SERVER_SECRET); heartbeats will be refused\n";
+        }
+        std::cout << "Reporting capacity to " << heartbeatIdentity.coordinatorUrl << " as "
+                  << heartbeatIdentity.serverId << " every " << heartbeatEverySec << " s\n";
+    }
+
     while (true) {
-        server.service(0, onConnect, onDisconnect, onPacket);
+        PROFILE_SCOPE("Server::frame");
+        const auto frameStart = std::chrono::steady_clock::now();
+        frameNowSec = std::chrono::duration<double>(frameStart - startTime).count();
+        {
+            PROFILE_SCOPE("Server::service");
+            server.service(0, onConnect, onDisconnect, onPacket);
+        }
 
         auto now = std::chrono::steady_clock::now();
         float dt = std::chrono::duration_cast<std::chrono::duration<float>>(now - last).count();
         last = now;
         accumulator += dt;
+        int ticksThisFrame = 0;
         while (accumulator >= fixedDt) {
-            sim.tick(fixedDt);
+            PROFILE_SCOPE("Server::tick");
+            if (lockstepPlayers > 0) {
+                lockstepTick();
+                accumulator -= fixedDt;
+                ++tick;
+                ++ticksThisFrame;
+                continue;
+            }
+            // One input per player per tick, as the client predicted them; the rest wait
+            for (net::PeerSession* session : sessions.active()) {
+                net::InputCommand cmd{};
+                if (session->inputs.popForTick(cmd)) sim.applyInputAt(session->playerSlot, {cmd.dirX, cmd.dirY});
+            }
+            bots.update(fixedDt);
+            // Balls hold still through the countdown
+            if (!matchFlow.countdown()) sim.tick(fixedDt);
             accumulator -= fixedDt;
             ++tick;
-            snapshotTimer += fixedDt;
+            ++ticksThisFrame;
+            matchEvents.clear();
+            if (matchFlow.update(sim, fixedDt, matchEvents)) startRound();
+            sendMatchEvents();
+            if (recorder.isRecording()) recorder.recordFrame(tick, sim);
+        }
+
+        const float simElapsed = static_cast<float>(ticksThisFrame) * fixedDt;
+
+        if (!resumable.empty()) {
+            // Players who did not come back in time leave the match
+            bool expired = false;
+            for (auto it = resumable.begin(); it != resumable.end();) {
+                if (now < it->second.deadline) {
+                    ++it;
+                    continue;
+                }
+                sim.removePlayer(it->second.playerId);
+                recorder.recordEvent(tick, replay::EventType::PlayerLeft, it->second.playerId);
+                it = resumable.erase(it);
+                expired = true;
+            }
+            if (expired) {
+                balanceBots();
+                if (humanCount == 0 && resumable.empty()) {
+                    stopRecording();
+                    checkpointFile.clear();
+                }
+            }
+        }
+
+        checkpointTimer += simElapsed;
+        if (checkpointFile.isOpen() && checkpointTimer >= checkpointEverySec &&
+            (humanCount > 0 || !resumable.empty())) {
+            checkpointTimer = 0.f;
+            writeCheckpoint();
         }
 
-        if (snapshotTimer >= 0.03f) {  // 30ms between snapshots (33 per second)
-            snapshotTimer = 0.f;
-            net::StateSnapshot snap;
-            snap.tick = tick;
-            auto now = std::chrono::steady_clock::now();
-            snap.serverTimeMs = static_cast<std::uint32_t>(
+        // Lockstep peers simulate for themselves and get no snapshots
+        if (lockstepPlayers == 0) {
+            // Each peer gets snapshots at its own adaptive rate; the full packet is
+            // encoded at most once per frame in a single pass from the simulation
+            // straight into a pooled ENet buffer, and shared by every peer that is
+            // due; players get their InputAck beside it through the outbox.
+            // When the whole lobby does not fit the snapshot budget, players instead
+            // get the entities that matter most to them (relays always get everything).
+            ENetPacket* snapshotPacket = nullptr;
+            bool frameCaptured = false;
+            const std::uint32_t serverTimeMs = static_cast<std::uint32_t>(
                 std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count());
-            snap.arenaRadius = sim.getArenaRadius();
-            for (const auto& p : sim.snapshotPlayers()) {
-                net::PlayerState ps{};
-                ps.playerId = p.id;
-                ps.x = p.position.x;
-                ps.y = p.position.y;
-                ps.vx = p.velocity.x;
-                ps.vy = p.velocity.y;
-                ps.alive = p.alive ? 1 : 0;
-                snap.players.push_back(ps);
+            // Measured as a player gets it, batched with its InputAck; relays and spectators always get everything
+            const bool overBudget = snapshotBudget > 0 && net::stateWithAckSize(net::snapshotSize(sim)) > snapshotBudget;
+            const std::size_t playerStateBudget =
+                snapshotBudget > net::STATE_ACK_OVERHEAD ? snapshotBudget - net::STATE_ACK_OVERHEAD : 0;
+            PROFILE_SCOPE("Server::snapshots");
+            for (net::PeerSession* session : sessions.active()) {
+                const bool wasCongested = session->snapshotRate.isCongested();
+                session->snapshotRate.updateLink(net::NetServer::linkStats(session->peer), dt);
+                if (session->snapshotRate.isCongested() && !wasCongested) {
+                    std::cout << "Client " << session->playerId << " link congested, snapshot rate now "
+                              << session->snapshotRate.rateHz() << " Hz\n";
+                }
+                if (!session->snapshotRate.advance(simElapsed)) continue;
+
+                const bool player = session->role == net::SessionRole::Player;
+                bool sent;
+                if (overBudget && player) {
+                    PROFILE_SCOPE("Server::prioritizeSnapshot");
+                    if (!frameCaptured) {
+                        snap.players.clear();
+                        candidates.clear();
+                        sim.forEachSlot([&](std::size_t slot, const SimPlayer& p) {
+                            net::PlayerState ps{};
+                            ps.playerId = p.id;
+                            ps.x = p.position.x;
+                            ps.y = p.position.y;
+                            ps.vx = p.velocity.x;
+                            ps.vy = p.velocity.y;
+                            ps.alive = p.alive ? 1 : 0;
+                            snap.players.push_back(ps);
+                            candidates.push_back({slot, p.collisions});
+                        });
+                        frameCaptured = true;
+                    }
+                    partial.tick = tick;
+                    partial.serverTimeMs = serverTimeMs;
+                    partial.arenaRadius = sim.getArenaRadius();
+                    session->snapshotPriority.select(snap.players, candidates, session->playerId, frameNowSec,
+                                                     net::statePlayersForBudget(playerStateBudget), partial.players);
+                    // Unique to this player: encoded straight into its outbox, where the ack joins it
+                    sent = session->outbox.write(false, net::stateMessageSize(partial.players.size()),
+                                                 [&](std::uint8_t* out) { net::writeState(out, partial); });
+                } else {
+                    if (!snapshotPacket) {
+                        snapshotPacket = net::NetServer::createPacket(net::snapshotSize(sim));
+                        if (!snapshotPacket) break;
+                        net::encodeSnapshot(snapshotPacket->data, sim, tick, serverTimeMs);
+                    }
+                    sent = sendShared(session, snapshotPacket, false);
+                }
+                if (!sent) continue;
+                session->lastSnapshotTick = tick;
+                // Players reconcile their prediction against the snapshot with the ack for its
+                // tick, sent right behind it: in the same Batch when the State went through the
+                // outbox, as the next datagram when it was the shared packet.
+                if (player) {
+                    session->outbox.write(false, net::messageSize<net::InputAck>(), [&](std::uint8_t* out) {
+                        net::writeMessage(out, net::MessageType::InputAck,
+                                          net::InputAck{tick, session->inputs.lastApplied()});
+                    });
+                }
+            }
+            net::NetServer::releasePacket(snapshotPacket);
+        }
+        // Each peer's coalesced messages, as few packets as possible
+        for (net::PeerSession* session : sessions.active()) {
+            if (session->outbox.empty()) continue;
+            const net::OutboxFlush sent = session->outbox.flush([&](std::size_t size, bool reliable, auto&& fill) {
+                return server.sendWith(session->peer, size, reliable, fill);
+            });
+            session->stats.packetsOut += sent.packets;
+            session->stats.bytesOut += sent.bytes;
+        }
+        // Hand the whole snapshot (or lockstep frame) burst to the socket together
+        server.flush();
+
+        PROFILE_POLL_DUMP();
+
+        loadBusySec += std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+        if (frameNowSec - loadWindowStart >= 1.0) {
+            serverLoad = static_cast<float>(loadBusySec / (frameNowSec - loadWindowStart));
+            loadBusySec = 0.0;
+            loadWindowStart = frameNowSec;
+            if (heartbeat) heartbeat->publish(currentCapacity());
+        }
+        if (frameNowSec - lastDropReport >= 10.0) {
+            const std::uint64_t total = inboundDrops.total();
+            if (total != lastReportedDrops) {
+                std::cout << "Inbound packets dropped: " << total - lastReportedDrops << " in the last "
+                          << static_cast<int>(frameNowSec - lastDropReport) << " s (";
+                for (std::size_t r = 1; r < static_cast<std::size_t>(net::DropReason::Count); ++r) {
+                    const auto reason = static_cast<net::DropReason>(r);
+                    std::cout << (r > 1 ? ", " : "") << net::dropReasonName(reason) << " " << inboundDrops.count(reason);
+                }
+                std::cout << " total), load " << serverLoad << "\n";
+                lastReportedDrops = total;
             }
-            std::cout << "Server: Broadcasting snapshot with " << snap.players.size() << " players, serverTime=" << snap.serverTimeMs << "\n";
-            server.broadcast(net::serializeState(snap), false);
+            lastDropReport = frameNowSec;
         }
 
+        PROFILE_SCOPE("Server::idle");
         std::this_thread::sleep_for(std::chrono::milliseconds(2));
     }
 
@@ -2,6 +2,7 @@
 #include "ui/components/UIComponents.h"
 #include "core/Settings.h"
 #include "core/KeyBindings.h"
+#include "core/Profiler.h"
 #include <imgui.h>
 #include <SDL2/SDL.h>
 #include <iostream>
@@ -9,6 +10,12 @@
 #include <algorithm>
 #include <string>
 
+namespace {
+// Reconnect attempts back off from the first to the last delay
+constexpr uint32_t RECONNECT_BACKOFF_MIN_MS = 500;
+constexpr uint32_t RECONNECT_BACKOFF_MAX_MS = 8000;
+}
+
 bool MatchScene::handleInput(const SDL_Event& event) {
     // Handle ESC key for pause during active gameplay (any game mode)
     if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
@@ -25,6 +32,8 @@ MatchScene::MatchScene(bool singlePlayer)
     : singleplayer(singlePlayer) {
     if (singleplayer) {
         initializeSingleplayerGame();
+    } else {
+        initializeOnlineGame();
     }
 }
 
@@ -79,8 +88,29 @@ void MatchScene::initializeSingleplayerGame() {
     std::cout << "[GameScreen] Singleplayer game initialized with player and 5 AI opponents" << std::endl;
 }
 
+void MatchScene::initializeOnlineGame() {
+    playerController = std::make_unique<HumanController>();
+    netThread = std::make_unique<net::NetThread>();
+    onlineStatus = OnlineStatus::Connecting;
+    onlineError.clear();
+    resumeToken = 0;
+    reconnectPending = false;
+    gameRunning = true;
+    gameEnded = false;
+    countdownActive = false;
+    gameTime = 0.0f;
+
+    const auto port = static_cast<std::uint16_t>(Settings::onlinePort);
+    if (!netThread->start(Settings::onlineHost, port)) {
+        onlineStatus = OnlineStatus::Failed;
+        onlineError = "Could not connect to " + Settings::onlineHost + ":" + std::to_string(port);
+        return;
+    }
+    std::cout << "[GameScreen] Connecting to " << Settings::onlineHost << ":" << port << std::endl;
+}
+
 void MatchScene::update() {
-    if (!singleplayer || !gameRunning || gameEnded) {
+    if (!gameRunning || gameEnded) {
         return;
     }
     
@@ -90,10 +120,264 @@ void MatchScene::update() {
     float dt = std::min(0.033f, (currentTime - lastTime) / 1000.0f);
     lastTime = currentTime;
     
-    updateGameLogic(dt);
+    if (singleplayer) {
+        updateGameLogic(dt);
+    } else {
+        updateOnline(dt);
+    }
+}
+
+void MatchScene::updateOnline(float dt) {
+    PROFILE_SCOPE("MatchScene::updateOnline");
+    if (!netThread) return;
+    // Packets were received (and timestamped) on the network thread; this only decodes them
+    while (const net::NetArrival* arrival = netThread->front()) {
+        handleArrival(*arrival);
+        netThread->pop();
+    }
+    if (reconnectPending) {
+        // The server hands the ball back to whoever presents its resume token
+        if (SDL_TICKS_PASSED(SDL_GetTicks(), reconnectAtMs)) {
+            reconnectPending = false;
+            if (!netThread->start(Settings::onlineHost, static_cast<std::uint16_t>(Settings::onlinePort), resumeToken)) {
+                scheduleReconnect();
+            }
+        }
+        return;
+    }
+    if (onlineStatus != OnlineStatus::Playing) return;
+
+    if (lockstepSim) {
+        stepLockstep(dt);
+    } else {
+        if (!spectating) stepOnline(dt);
+        remoteView.update(netThread->localTimeMs(), dt);
+    }
+    if (countdownActive) countdownTime = std::max(0.0f, countdownTime - dt);
+    else if (!waitingForPlayers && !roundOver) gameTime += dt;
+
+    gatherOnlinePlayers();
+    survivorCount = 0;
+    for (const auto& p : onlinePlayers) {
+        if (p.alive) survivorCount++;
+    }
+    updateExitAnimations(dt, onlinePlayers);
+}
+
+void MatchScene::gatherOnlinePlayers() {
+    onlinePlayers.clear();
+    if (lockstepSim) {
+        lockstepSim->simulation().forEachPlayer([&](const SimPlayer& p) {
+            onlinePlayers.push_back({p.id, p.position, p.velocity, p.alive});
+        });
+        return;
+    }
+    for (const prediction::InterpolatedPlayer& p : remoteView.players()) {
+        if (spectating || p.id != playerId) onlinePlayers.push_back({p.id, p.position, p.velocity, p.alive});
+    }
+    if (spectating) return;
+    const Simulation& world = predictor.world();
+    if (const SimPlayer* self = world.playerAt(world.slotOf(playerId))) {
+        onlinePlayers.push_back({self->id, predictor.displayPosition(self->id, self->position), self->velocity, self->alive});
+    }
+}
+
+void MatchScene::stepOnline(float dt) {
+    // Inputs go out at the server's tick rate, however fast frames are rendered
+    const float tickDt = 1.0f / 60.0f;
+    stepAccumulator = std::min(stepAccumulator + dt, 0.25f);
+    while (stepAccumulator >= tickDt) {
+        stepAccumulator -= tickDt;
+        const Vec2 direction = steer(predictor.world(), tickDt);
+
+        net::InputCommand cmd;
+        cmd.dirX = direction.x;
+        cmd.dirY = direction.y;
+        cmd.timestampMs = netThread->localTimeMs();
+        inputHistory.record(cmd);
+        // The server holds every ball still through the countdown
+        predictor.step(cmd, countdownActive);
+        netThread->sendWith(inputHistory.bundleSize(), false, [&](std::uint8_t* out) {
+            inputHistory.writeBundle(out);
+        });
+    }
+    predictor.decayCorrection(dt);
+}
+
+void MatchScene::stepLockstep(float dt) {
+    // Inputs go out at the tick rate as usual, but nothing is predicted: every
+    // ball, ours included, moves only when the server's frame for a tick arrives
+    const float tickDt = lockstepSim->tickDt();
+    stepAccumulator = std::min(stepAccumulator + dt, 0.25f);
+    while (stepAccumulator >= tickDt) {
+        stepAccumulator -= tickDt;
+        const Vec2 direction = steer(lockstepSim->simulation(), tickDt);
+        net::InputCommand cmd;
+        cmd.dirX = direction.x;
+        cmd.dirY = direction.y;
+        cmd.timestampMs = netThread->localTimeMs();
+        inputHistory.record(cmd);
+        netThread->sendWith(inputHistory.bundleSize(), false, [&](std::uint8_t* out) {
+            inputHistory.writeBundle(out);
+        });
+    }
+
+    lockstepSim->advance();
+    // The server compares every peer's hash for a tick, so none may be lost
+    net::StateHash report;
+    while (lockstepSim->takeHash(report)) {
+        netThread->sendWith(net::messageSize<net::StateHash>(), true, [&](std::uint8_t* out) {
+            net::writeMessage(out, net::MessageType::StateHash, report);
+        });
+    }
+}
+
+Vec2 MatchScene::steer(const Simulation& world, float tickDt) {
+    const SimPlayer* self = world.playerAt(world.slotOf(playerId));
+    if (!self || !self->alive || paused) return {0.f, 0.f};
+    steerOthers.clear();
+    world.forEachPlayer([&](const SimPlayer& p) {
+        if (p.id != playerId && p.alive) steerOthers.push_back({p.position, p.velocity});
+    });
+    return playerController->getMovementDirection(tickDt, self->position, self->velocity, steerOthers,
+                                                  world.arenaCenter, world.getCurrentArenaRadius(),
+                                                  world.getArenaAge());
+}
+
+void MatchScene::handleArrival(const net::NetArrival& arrival) {
+    switch (arrival.kind) {
+        case net::NetArrival::Kind::Connected:
+            break;  // the JoinAccept that follows says which ball is ours
+        case net::NetArrival::Kind::Disconnected:
+            // Only a lost connection (timeout, server restart) is worth reclaiming the
+            // ball for; a kick with a reason would just be repeated, and a lockstep
+            // roster is fixed, so rejoining one would be refused
+            if (arrival.reason == net::DisconnectReason::None && resumeToken != 0 && !lockstepSim &&
+                (onlineStatus == OnlineStatus::Playing || onlineStatus == OnlineStatus::Reconnecting)) {
+                scheduleReconnect();
+            } else {
+                onlineStatus = OnlineStatus::Failed;
+                onlineError = net::disconnectReasonText(arrival.reason);
+            }
+            break;
+        case net::NetArrival::Kind::Packet:
+            net::forEachMessage(arrival.data.data(), arrival.size, [&](const uint8_t* data, size_t len) {
+                handleOnlineMessage(data, len, arrival.arrivalMs);
+            });
+            break;
+    }
+}
+
+void MatchScene::scheduleReconnect() {
+    const uint32_t now = SDL_GetTicks();
+    if (onlineStatus != OnlineStatus::Reconnecting) {
+        // First attempt right away; a server that is restarting may take a while,
+        // so keep trying for as long as it could still hold our ball
+        onlineStatus = OnlineStatus::Reconnecting;
+        reconnectAtMs = now;
+        reconnectBackoffMs = RECONNECT_BACKOFF_MIN_MS;
+        reconnectGiveUpMs = now + static_cast<uint32_t>((net::RESUME_WITHIN_SEC + net::RESUME_GRACE_SEC) * 1000.0f);
+    } else {
+        if (SDL_TICKS_PASSED(now, reconnectGiveUpMs)) {
+            onlineStatus = OnlineStatus::Failed;
+            onlineError = "Lost connection to the server";
+            return;
+        }
+        reconnectAtMs = now + reconnectBackoffMs;
+        reconnectBackoffMs = std::min(reconnectBackoffMs * 2, RECONNECT_BACKOFF_MAX_MS);
+    }
+    reconnectPending = true;
+}
+
+void MatchScene::handleOnlineMessage(const uint8_t* data, size_t len, uint32_t arrivalMs) {
+    if (!net::decodeMessage(data, len, decoded).isSuccess()) return;
+    switch (decoded.type) {
+        case net::MessageType::JoinAccept:
+            playerId = decoded.joinAccept.playerId;
+            resumeToken = decoded.joinAccept.resumeToken;
+            // A relay's viewers get no ball: nothing to predict or send
+            spectating = playerId == net::SPECTATOR_PLAYER_ID;
+            // Sequences restart with every session on the server
+            predictor.reset(playerId);
+            remoteView.clear();
+            lockstepSim.reset();
+            inputHistory.reset();
+            stepAccumulator = 0.0f;
+            prevAlive.clear();
+            exitAnims.clear();
+            onlineStatus = OnlineStatus::Playing;
+            if (spectating) std::cout << "[GameScreen] Joined as spectator" << std::endl;
+            else std::cout << "[GameScreen] Joined as player " << playerId << std::endl;
+            break;
+        case net::MessageType::State:
+            predictor.onState(decoded.state);
+            remoteView.push(decoded.state, arrivalMs);
+            break;
+        case net::MessageType::InputAck:
+            predictor.onInputAck(decoded.inputAck);
+            break;
+        case net::MessageType::MatchEvents:
+            for (size_t i = 0; i < decoded.events.size(); ++i) handleMatchEvent(decoded.events[i]);
+            break;
+        case net::MessageType::LockstepStart:
+            // The roster is fixed from here on and the server stops sending snapshots
+            decoded.roster.copyTo(lockstepRoster);
+            lockstepSim = std::make_unique<lockstep::LockstepSimulation>(decoded.lockstepStart, lockstepRoster);
+            waitingForPlayers = false;
+            countdownActive = false;
+            roundOver = false;
+            gameTime = 0.0f;
+            stepAccumulator = 0.0f;
+            prevAlive.clear();
+            exitAnims.clear();
+            std::cout << "[GameScreen] Lockstep match started with " << lockstepRoster.size() << " players" << std::endl;
+            break;
+        case net::MessageType::LockstepFrame:
+            if (!lockstepSim) break;
+            decoded.lockstepInputs.copyTo(lockstepInputs);
+            // Frames come reliable and in order; a gap means this peer can no longer stay in sync
+            if (!lockstepSim->pushFrame(decoded.lockstepFrame, lockstepInputs)) {
+                onlineStatus = OnlineStatus::Failed;
+                onlineError = "Lost a lockstep frame; the match cannot continue";
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void MatchScene::handleMatchEvent(const net::MatchEvent& event) {
+    switch (event.type) {
+        case net::MatchEventType::Waiting:
+            waitingForPlayers = true;
+            countdownActive = false;
+            roundOver = false;
+            break;
+        case net::MatchEventType::Countdown:
+            waitingForPlayers = false;
+            roundOver = false;
+            countdownActive = true;
+            countdownTime = static_cast<float>(event.value);
+            break;
+        case net::MatchEventType::RoundStarted:
+            waitingForPlayers = false;
+            countdownActive = false;
+            roundOver = false;
+            roundNumber = event.value;
+            gameTime = 0.0f;
+            break;
+        case net::MatchEventType::Eliminated:
+            break;  // the exit animation starts once a snapshot shows it
+        case net::MatchEventType::RoundEnded:
+            roundOver = true;
+            roundWinner = event.playerId;
+            roundNumber = event.value;
+            break;
+    }
 }
 
 void MatchScene::updateGameLogic(float dt) {
+    PROFILE_SCOPE("MatchScene::updateGameLogic");
     if (!simulation || paused) return;
     if (countdownActive) {
         countdownTime -= dt;
@@ -228,14 +512,11 @@ void MatchScene::render() {
     ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
     ImGui::Begin("##GameScreen", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoMove);
     
+    renderGameView();
     if (singleplayer) {
-        renderGameView();
         renderUI();
     } else {
-        ImGui::Text("Multiplayer game (stub)");
-        if (ImGui::Button("Return to Main Menu")) {
-            action = ScreenTransition::TO_MAIN_MENU;
-        }
+        renderOnlineUI();
     }
     
     ImGui::End();
@@ -249,12 +530,17 @@ void MatchScene::renderGameView() {
     ImVec2 arena_center = ImVec2(window_size.x * 0.5f, window_size.y * 0.62f);
     float arena_pixel_radius = 300.0f; // Display scale
     
+    // Online, the arena comes from the predicted (or lockstep) world and the balls from onlinePlayers
+    const Simulation* world = singleplayer ? simulation.get()
+                            : lockstepSim  ? &lockstepSim->simulation()
+                                           : &predictor.world();
+
     // Get current arena state
     float simArenaRadius = 500.0f;  // Initial radius
     float currentSimRadius = simArenaRadius;
-    if (simulation) {
-        simArenaRadius = simulation->arenaRadius;
-        currentSimRadius = simulation->getCurrentArenaRadius();
+    if (world) {
+        simArenaRadius = world->arenaRadius;
+        currentSimRadius = world->getCurrentArenaRadius();
     }
     
     // Calculate current arena display radius
@@ -269,19 +555,20 @@ void MatchScene::renderGameView() {
     draw_list->AddCircle(arena_center, currentDisplayRadius, arena_border_color, 32, 3.0f);
     
     // Draw players if simulation exists
-    if (simulation) {
-        auto players = simulation->snapshotPlayers();
-        const Vec2& simArenaCenter = simulation->arenaCenter;
-        float simRadius = simulation->arenaRadius;  // Use initial radius for coordinate mapping
+    if (world) {
+        const auto players = singleplayer ? world->snapshotPlayers() : onlinePlayers;
+        const Vec2& simArenaCenter = world->arenaCenter;
+        float simRadius = world->arenaRadius;  // Use initial radius for coordinate mapping
         float drawScale = (simRadius > 0.01f) ? (arena_pixel_radius / simRadius) : 0.6f;
-        float drawPlayerRadius = simulation->getPlayerRadius() * drawScale;
+        float drawPlayerRadius = world->getPlayerRadius() * drawScale;
         
         for (const auto& player : players) {
             if (!player.alive) continue;
             
             // Convert simulation coords to screen coords
-            float relX = (player.position.x - simArenaCenter.x) / simRadius;
-            float relY = (player.position.y - simArenaCenter.y) / simRadius;
+            Vec2 pos = player.position;
+            float relX = (pos.x - simArenaCenter.x) / simRadius;
+            float relY = (pos.y - simArenaCenter.y) / simRadius;
             
             ImVec2 screen_pos = ImVec2(
                 arena_center.x + relX * arena_pixel_radius,
@@ -294,7 +581,7 @@ void MatchScene::renderGameView() {
                 // Player is blue
                 player_color = ImGui::GetColorU32(ImVec4(0.26f, 0.59f, 0.98f, 1.0f));
             } else {
-                // AI are red/orange
+                // AI (and other players online) are red/orange
                 player_color = ImGui::GetColorU32(ImVec4(1.0f, 0.5f, 0.2f, 1.0f));
             }
             
@@ -322,7 +609,6 @@ void MatchScene::renderGameView() {
 void MatchScene::renderUI() {
     ImGuiIO& io = ImGui::GetIO();
     float window_width = ImGui::GetWindowWidth();
-    float window_height = ImGui::GetWindowHeight();
     
     // Top HUD - Game info
     ImGui::SetCursorPos(ImVec2(20.0f, 20.0f));
@@ -406,8 +692,78 @@ void MatchScene::renderUI() {
         ImGui::End();
     }
     
+    renderControlHints();
+    if (countdownActive) renderCountdownOverlay();
+}
+
+void MatchScene::renderOnlineUI() {
+    float window_width = ImGui::GetWindowWidth();
+    float window_height = ImGui::GetWindowHeight();
+
+    ImGui::SetCursorPos(ImVec2(20.0f, 20.0f));
+    if (onlineStatus != OnlineStatus::Playing) {
+        if (onlineStatus == OnlineStatus::Failed) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", onlineError.c_str());
+            ImGui::SetCursorPosX(20.0f);
+            if (UIComponents::SecondaryButton("Main Menu", ImVec2(200, 40))) {
+                action = ScreenTransition::TO_MAIN_MENU;
+            }
+        } else if (onlineStatus == OnlineStatus::Reconnecting) {
+            ImGui::Text("Connection lost, reclaiming your ball...");
+        } else {
+            ImGui::Text("Connecting to %s:%d...", Settings::onlineHost.c_str(), Settings::onlinePort);
+        }
+        return;
+    }
+
+    // Top HUD - Round info
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.26f, 0.59f, 0.98f, 1.0f));
+    ImGui::Text("ROUND %u  TIME: %.1fs", roundNumber, gameTime);
+    ImGui::PopStyleColor();
+
+    ImGui::SetCursorPos(ImVec2(window_width - 250.0f, 20.0f));
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.8f, 0.2f, 1.0f));
+    ImGui::Text("SURVIVORS: %u", survivorCount);
+    ImGui::PopStyleColor();
+
+    // Connection telemetry
+    const net::ClockSync clock = netThread->clockSync();
+    ImGui::SetCursorPos(ImVec2(window_width - 250.0f, 45.0f));
+    ImGui::Text("PING: %.0f ms", clock.samples() > 0 ? clock.minRttMs() : 0.0);
+    ImGui::SetCursorPos(ImVec2(window_width - 250.0f, 65.0f));
+    if (lockstepSim) {
+        ImGui::TextDisabled("LOCKSTEP tick %u | buffered: %zu", lockstepSim->nextTick(), lockstepSim->bufferedFrames());
+    } else {
+        if (spectating) {
+            ImGui::TextDisabled("SPECTATING");
+        } else {
+            ImGui::TextDisabled("ahead: %zu inputs | correction: %.1f", predictor.pendingInputs(), predictor.lastCorrection());
+        }
+        ImGui::SetCursorPos(ImVec2(window_width - 250.0f, 85.0f));
+        ImGui::TextDisabled("jitter: %.1f ms | interp: %.0f ms", remoteView.jitterMs(), remoteView.delayMs());
+    }
+
+    // Match phase banner
+    if (waitingForPlayers || roundOver) {
+        ImGui::SetCursorPosY(window_height * 0.12f);
+        if (waitingForPlayers) {
+            UIComponents::CenteredHeading("WAITING FOR PLAYERS");
+        } else if (!spectating && roundWinner == playerId) {
+            UIComponents::CenteredHeading("YOU WIN!");
+        } else if (roundWinner == 0) {
+            UIComponents::CenteredHeading("NO SURVIVORS");
+        } else {
+            UIComponents::CenteredHeading(("PLAYER " + std::to_string(roundWinner) + " WINS").c_str());
+        }
+    }
+
+    renderControlHints();
+    if (countdownActive) renderCountdownOverlay();
+}
+
+void MatchScene::renderControlHints() {
     // Control hints (reflect current keybindings)
-    ImGui::SetCursorPos(ImVec2(20.0f, window_height - 50.0f));
+    ImGui::SetCursorPos(ImVec2(20.0f, ImGui::GetWindowHeight() - 50.0f));
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.70f, 0.70f, 0.72f, 0.6f));
     bool lefty = Settings::leftyMode;
     SDL_Scancode up = KeyBindings::getMoveUpKey(lefty);
@@ -421,27 +777,27 @@ void MatchScene::renderUI() {
     std::string hint = "Use " + moveKeys + " to move | ESC to pause";
     ImGui::TextUnformatted(hint.c_str());
     ImGui::PopStyleColor();
+}
 
+void MatchScene::renderCountdownOverlay() {
     // Countdown overlay
-    if (countdownActive) {
-        ImDrawList* dl = ImGui::GetForegroundDrawList();
-        ImVec2 vp = ImGui::GetMainViewport()->Pos;
-        ImVec2 vs = ImGui::GetMainViewport()->Size;
-        dl->AddRectFilled(vp, ImVec2(vp.x + vs.x, vp.y + vs.y), ImGui::GetColorU32(ImVec4(0, 0, 0, 0.35f)));
-
-        int number = static_cast<int>(std::ceil(countdownTime));
-        float frac = countdownTime - std::floor(countdownTime);
-        float alpha = 0.2f + 0.8f * (1.0f - frac); // fade per number
-
-        ImGui::SetNextWindowPos(ImVec2(vp.x + vs.x * 0.5f, vp.y + vs.y * 0.45f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
-        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, alpha));
-        ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0]);
-        ImGui::Begin("##CountdownOverlay", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_AlwaysAutoResize);
-        ImGui::Text("%d", number);
-        ImGui::End();
-        ImGui::PopFont();
-        ImGui::PopStyleColor();
-    }
+    ImDrawList* dl = ImGui::GetForegroundDrawList();
+    ImVec2 vp = ImGui::GetMainViewport()->Pos;
+    ImVec2 vs = ImGui::GetMainViewport()->Size;
+    dl->AddRectFilled(vp, ImVec2(vp.x + vs.x, vp.y + vs.y), ImGui::GetColorU32(ImVec4(0, 0, 0, 0.35f)));
+
+    int number = static_cast<int>(std::ceil(countdownTime));
+    float frac = countdownTime - std::floor(countdownTime);
+    float alpha = 0.2f + 0.8f * (1.0f - frac); // fade per number
+
+    ImGui::SetNextWindowPos(ImVec2(vp.x + vs.x * 0.5f, vp.y + vs.y * 0.45f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, alpha));
+    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0]);
+    ImGui::Begin("##CountdownOverlay", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::Text("%d", number);
+    ImGui::End();
+    ImGui::PopFont();
+    ImGui::PopStyleColor();
 }
 
 void MatchScene::handleGameEnd() {
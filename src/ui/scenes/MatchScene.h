@@ -5,10 +5,16 @@
 #include "game/simulation/Simulation.h"
 #include "game/controllers/HumanController.h"
 #include "game/controllers/AIController.h"
+#include "game/lockstep/LockstepSimulation.h"
+#include "game/prediction/ClientPrediction.h"
+#include "game/prediction/InterpolationBuffer.h"
+#include "network/InputHistory.h"
+#include "network/NetThread.h"
 #include <memory>
+#include <string>
 #include <vector>
 
-// Gameplay scene with singleplayer support
+// Gameplay scene: singleplayer against local AI, or online against sumo_balls_server
 class MatchScene : public Screen {
 public:
     explicit MatchScene(bool singlePlayer = false);
@@ -55,8 +61,50 @@ private:
     // Countdown
     bool countdownActive = true;
     float countdownTime = 3.0f;
+
+    // Online match: the server is authoritative; the local ball is predicted,
+    // everyone else is interpolated (spectators interpolate every ball). In a
+    // lockstep match (server --lockstep) every ball is simulated here from the
+    // server's input frames instead, and state hashes go back for cross-checking.
+    enum class OnlineStatus { Connecting, Playing, Reconnecting, Failed };
+    std::unique_ptr<net::NetThread> netThread;
+    net::InputHistory inputHistory;
+    prediction::ClientPrediction predictor;
+    prediction::InterpolationBuffer remoteView;
+    std::vector<SimSnapshotPlayer> onlinePlayers;  // what is drawn this frame
+    bool spectating = false;
+    std::unique_ptr<lockstep::LockstepSimulation> lockstepSim;  // set from LockstepStart on
+    std::vector<net::LockstepPlayer> lockstepRoster;
+    std::vector<net::LockstepInput> lockstepInputs;
+    std::vector<std::pair<Vec2, Vec2>> steerOthers;  // reused by steer()
+    net::DecodedMessage decoded;
+    OnlineStatus onlineStatus = OnlineStatus::Connecting;
+    std::string onlineError;
+    uint32_t resumeToken = 0;
+    bool reconnectPending = false;
+    uint32_t reconnectAtMs = 0;       // SDL ticks of the next attempt
+    uint32_t reconnectGiveUpMs = 0;   // the server's resume window closes here
+    uint32_t reconnectBackoffMs = 0;  // wait before the attempt after next
+    float stepAccumulator = 0.0f;
+    bool waitingForPlayers = false;
+    bool roundOver = false;
+    uint32_t roundNumber = 0;
+    uint32_t roundWinner = 0;
     
     void initializeSingleplayerGame();
+    void initializeOnlineGame();
+    void updateOnline(float dt);
+    void stepOnline(float dt);
+    void stepLockstep(float dt);
+    Vec2 steer(const Simulation& world, float tickDt);
+    void handleArrival(const net::NetArrival& arrival);
+    void scheduleReconnect();
+    void handleOnlineMessage(const uint8_t* data, size_t len, uint32_t arrivalMs);
+    void gatherOnlinePlayers();
+    void handleMatchEvent(const net::MatchEvent& event);
+    void renderOnlineUI();
+    void renderControlHints();
+    void renderCountdownOverlay();
     void updateGameLogic(float dt);
     void renderGameView();
     void renderUI();
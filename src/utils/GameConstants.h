@@ -39,8 +39,8 @@ constexpr int NETWORK_TIMEOUT_MS = 5000;
 constexpr int SNAPSHOT_RATE_MS = 30;          // Server sends snapshots every 30ms
 
 // === Interpolation & Prediction ===
-constexpr float INTERP_BLEND_FACTOR = 0.35f;  // Client-side interpolation blend
 constexpr float SNAPSHOT_INTERP_DELAY = 100.f; // ms to delay for smooth interpolation
+constexpr float INTERP_DELAY_SHRINK_PER_SEC = 0.35f;  // 1/s: how fast a raised delay eases back down
 
 // === Game Timing ===
 constexpr float COUNTDOWN_DURATION = 3.f;     // Seconds
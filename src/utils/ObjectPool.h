@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// Fixed-size object pool backed by chunked storage and an intrusive free list.
+/// Objects never move once created; create()/destroy() are O(1) and only touch
+/// the heap when the pool has to grow by another chunk.
+/// Objects still alive when the pool is destroyed are released without running
+/// their destructors, so owners must destroy() everything first.
+template <typename T, std::size_t ChunkSize = 16>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!freeList) grow();
+        Slot* slot = freeList;
+        freeList = slot->next;
+        ++live;
+        return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* obj) {
+        if (!obj) return;
+        obj->~T();
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        slot->next = freeList;
+        freeList = slot;
+        --live;
+    }
+
+    std::size_t liveCount() const { return live; }
+    std::size_t capacity() const { return chunks.size() * ChunkSize; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void grow() {
+        auto chunk = std::make_unique<Slot[]>(ChunkSize);
+        for (std::size_t i = 0; i < ChunkSize; ++i) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+        chunks.push_back(std::move(chunk));
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList{nullptr};
+    std::size_t live{0};
+};
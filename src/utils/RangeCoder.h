@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Adaptive binary range coder (the LZMA construction: 32-bit range, 11-bit
+/// probabilities, carry propagation through a cached byte).
+///
+/// Everything is coded as binary decisions against a BitModel, which adapts
+/// toward the bits it sees; values that are hard to predict can be written as
+/// direct (equiprobable) bits. The encoder writes into caller-provided storage
+/// and never allocates; when the storage runs out it reports overflow instead.
+namespace rc {
+
+/// Probability that the next bit is 0, in 1/2048ths
+struct BitModel {
+    static constexpr std::uint32_t BITS = 11;
+    static constexpr std::uint32_t ONE = 1u << BITS;
+    static constexpr std::uint32_t ADAPT_SHIFT = 4;  // fast adaptation: models see few symbols per frame
+
+    std::uint16_t p{ONE / 2};
+};
+
+class RangeEncoder {
+public:
+    RangeEncoder(std::uint8_t* out, std::size_t capacity) : out(out), capacity(capacity) {}
+
+    void encodeBit(BitModel& model, std::uint32_t bit) {
+        const std::uint32_t bound = (range >> BitModel::BITS) * model.p;
+        if (bit == 0) {
+            range = bound;
+            model.p = static_cast<std::uint16_t>(model.p + ((BitModel::ONE - model.p) >> BitModel::ADAPT_SHIFT));
+        } else {
+            low += bound;
+            range -= bound;
+            model.p = static_cast<std::uint16_t>(model.p - (model.p >> BitModel::ADAPT_SHIFT));
+        }
+        normalize();
+    }
+
+    // Low `bits` bits of value, most significant first, each with probability 1/2
+    void encodeDirect(std::uint32_t value, std::uint32_t bits) {
+        while (bits-- > 0) {
+            range >>= 1;
+            if ((value >> bits) & 1u) low += range;
+            normalize();
+        }
+    }
+
+    // Flush the remaining state and return the encoded size (which may be 0).
+    // Trailing zero bytes are dropped: the decoder reads past the end as zeros.
+    std::size_t finish() {
+        for (int i = 0; i < 5; ++i) shiftLow();
+        while (written > 0 && out[written - 1] == 0) --written;
+        return written;
+    }
+
+    // True once the output storage ran out; the stream is then unusable
+    bool overflow() const { return overflowed; }
+
+private:
+    static constexpr std::uint32_t TOP = 1u << 24;
+
+    std::uint8_t* out;
+    std::size_t capacity;
+    std::size_t written{0};
+    bool overflowed{false};
+    bool first{true};  // the first byte out of shiftLow is always 0 and is not stored
+
+    std::uint64_t low{0};
+    std::uint32_t range{0xFFFFFFFFu};
+    std::uint8_t cache{0};
+    std::uint64_t cacheSize{1};
+
+    void normalize() {
+        while (range < TOP) {
+            range <<= 8;
+            shiftLow();
+        }
+    }
+
+    void put(std::uint8_t byte) {
+        if (first) {
+            first = false;
+            return;
+        }
+        if (written < capacity) out[written++] = byte;
+        else overflowed = true;
+    }
+
+    void shiftLow() {
+        if (static_cast<std::uint32_t>(low) < 0xFF000000u || (low >> 32) != 0) {
+            std::uint8_t carry = static_cast<std::uint8_t>(low >> 32);
+            std::uint8_t temp = cache;
+            do {
+                put(static_cast<std::uint8_t>(temp + carry));
+                temp = 0xFF;
+            } while (--cacheSize != 0);
+            cache = static_cast<std::uint8_t>(static_cast<std::uint32_t>(low) >> 24);
+        }
+        ++cacheSize;
+        low = (low & 0x00FFFFFFu) << 8;
+    }
+};
+
+class RangeDecoder {
+public:
+    RangeDecoder(const std::uint8_t* data, std::size_t size) : data(data), size(size) {
+        for (int i = 0; i < 4; ++i) code = (code << 8) | next();
+    }
+
+    std::uint32_t decodeBit(BitModel& model) {
+        const std::uint32_t bound = (range >> BitModel::BITS) * model.p;
+        std::uint32_t bit;
+        if (code < bound) {
+            range = bound;
+            model.p = static_cast<std::uint16_t>(model.p + ((BitModel::ONE - model.p) >> BitModel::ADAPT_SHIFT));
+            bit = 0;
+        } else {
+            code -= bound;
+            range -= bound;
+            model.p = static_cast<std::uint16_t>(model.p - (model.p >> BitModel::ADAPT_SHIFT));
+            bit = 1;
+        }
+        normalize();
+        return bit;
+    }
+
+    std::uint32_t decodeDirect(std::uint32_t bits) {
+        std::uint32_t value = 0;
+        while (bits-- > 0) {
+            range >>= 1;
+            std::uint32_t bit = 0;
+            if (code >= range) {
+                code -= range;
+                bit = 1;
+            }
+            value = (value << 1) | bit;
+            normalize();
+        }
+        return value;
+    }
+
+private:
+    static constexpr std::uint32_t TOP = 1u << 24;
+
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t pos{0};
+    std::uint32_t range{0xFFFFFFFFu};
+    std::uint32_t code{0};
+
+    std::uint8_t next() {
+        const std::uint8_t byte = pos < size ? data[pos] : 0;
+        ++pos;
+        return byte;
+    }
+
+    void normalize() {
+        while (range < TOP) {
+            range <<= 8;
+            code = (code << 8) | next();
+        }
+    }
+};
+
+/// Signed integers in a few adaptive contexts. A value is coded as a zero
+/// flag, a sign, its bit length (5-level bit tree) and the bits below the
+/// leading one: the first of them modeled per length, the rest direct.
+/// Small residuals therefore cost a fraction of a bit once the model settles.
+template <std::size_t Contexts>
+class ResidualModel {
+public:
+    void encode(RangeEncoder& enc, std::int32_t value, std::size_t ctx) {
+        Context& c = contexts[ctx];
+        enc.encodeBit(c.zero, value != 0);
+        if (value == 0) return;
+        enc.encodeBit(c.sign, value < 0);
+        const std::uint32_t mag = value < 0 ? 0u - static_cast<std::uint32_t>(value) : static_cast<std::uint32_t>(value);
+        const std::uint32_t length = bitLength(mag) - 1;  // 0..31
+        std::uint32_t node = 1;
+        for (int i = 4; i >= 0; --i) {
+            const std::uint32_t bit = (length >> i) & 1u;
+            enc.encodeBit(c.length[node], bit);
+            node = (node << 1) | bit;
+        }
+        if (length == 0) return;
+        enc.encodeBit(c.high[length], (mag >> (length - 1)) & 1u);
+        enc.encodeDirect(mag, length - 1);
+    }
+
+    std::int32_t decode(RangeDecoder& dec, std::size_t ctx) {
+        Context& c = contexts[ctx];
+        if (!dec.decodeBit(c.zero)) return 0;
+        const bool negative = dec.decodeBit(c.sign) != 0;
+        std::uint32_t node = 1;
+        for (int i = 0; i < 5; ++i) node = (node << 1) | dec.decodeBit(c.length[node]);
+        const std::uint32_t length = node - 32;
+        std::uint32_t mag = 1;
+        if (length > 0) {
+            mag = (mag << 1) | dec.decodeBit(c.high[length]);
+            mag = (mag << (length - 1)) | dec.decodeDirect(length - 1);
+        }
+        return negative ? static_cast<std::int32_t>(0u - mag) : static_cast<std::int32_t>(mag);
+    }
+
+    void reset() { contexts = {}; }
+
+private:
+    struct Context {
+        BitModel zero;
+        BitModel sign;
+        std::array<BitModel, 32> length;
+        std::array<BitModel, 32> high;
+    };
+    std::array<Context, Contexts> contexts{};
+
+    static std::uint32_t bitLength(std::uint32_t v) {
+        std::uint32_t n = 0;
+        while (v != 0) {
+            ++n;
+            v >>= 1;
+        }
+        return n;
+    }
+};
+
+} // namespace rc
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/// Bounded lock-free single-producer / single-consumer ring buffer.
+/// tryPush() is called from exactly one thread and tryPop() from exactly one
+/// other thread; neither ever blocks or allocates after construction.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : cap(roundUpPow2(capacity + 1)), mask(cap - 1), slots(std::make_unique<T[]>(cap)) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// Returns false (and leaves the queue untouched) when full
+    bool tryPush(const T& item) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t next = (h + 1) & mask;
+        if (next == tail.load(std::memory_order_acquire)) return false;
+        slots[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// Construct the next element in place via a writer callback; returns false when full
+    template <typename Fn>
+    bool tryPushWith(Fn&& fill) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t next = (h + 1) & mask;
+        if (next == tail.load(std::memory_order_acquire)) return false;
+        fill(slots[h]);
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        out = std::move(slots[t]);
+        tail.store((t + 1) & mask, std::memory_order_release);
+        return true;
+    }
+
+    /// Peek at the oldest element without removing it (consumer thread only)
+    T* front() {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return nullptr;
+        return &slots[t];
+    }
+
+    /// Drop the element returned by front() (consumer thread only)
+    void popFront() {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        tail.store((t + 1) & mask, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return cap - 1; }
+
+private:
+    static std::size_t roundUpPow2(std::size_t v) {
+        std::size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const std::size_t cap;
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+};
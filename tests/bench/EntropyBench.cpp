@@ -0,0 +1,124 @@
+// Snapshot/replay payload size and codec cost: raw wire snapshots versus the
+// range-coded FrameCoder residuals, on a bot match.
+//
+//   sumo_balls_entropy_bench [--players P] [--ticks T] [--interval N]
+//
+// "packet" codes every Nth tick against the frame N ticks earlier with fresh
+// models (one snapshot against the client's acknowledged baseline); "stream"
+// codes every tick against the previous one with models carried between
+// keyframes, as replay files do.
+
+#include "game/controllers/BotManager.h"
+#include "game/replay/FrameCoder.h"
+#include "game/simulation/Simulation.h"
+#include "network/NetProtocol.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    std::size_t players{16};
+    int ticks{3600};
+    std::uint32_t interval{2};  // 60 Hz simulation, ~30 Hz snapshots
+    std::uint32_t keyframeInterval{120};
+};
+
+using Clock = std::chrono::steady_clock;
+
+bool sameFrame(const replay::ReplayFrame& a, const replay::ReplayFrame& b) {
+    if (a.tick != b.tick || a.count != b.count) return false;
+    for (std::uint32_t i = 0; i < a.count; ++i) {
+        const replay::ReplayPlayer& p = a.players[i];
+        const replay::ReplayPlayer& q = b.players[i];
+        if (p.id != q.id || p.x != q.x || p.y != q.y || p.vx != q.vx || p.vy != q.vy || p.alive != q.alive) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<replay::ReplayFrame> recordMatch(const BenchConfig& cfg) {
+    Simulation sim(650.f, {600.f, 450.f});
+    BotManager bots(sim, BotConfig{cfg.players, DifficultyLevel::Medium, 10.f});
+    for (std::size_t i = 0; i < cfg.players; ++i) {
+        const float angle = static_cast<float>(i) * 6.2831853f / static_cast<float>(cfg.players);
+        bots.addBot(static_cast<std::uint32_t>(i + 1), {600.f + 400.f * std::cos(angle), 450.f + 400.f * std::sin(angle)});
+    }
+    std::vector<replay::ReplayFrame> frames(static_cast<std::size_t>(cfg.ticks) + 1);
+    replay::captureFrame(sim, 0, frames[0]);
+    for (int t = 1; t <= cfg.ticks; ++t) {
+        bots.update(1.f / 60.f);
+        sim.tick(1.f / 60.f);
+        replay::captureFrame(sim, static_cast<std::uint32_t>(t), frames[static_cast<std::size_t>(t)]);
+    }
+    return frames;
+}
+
+bool run(const std::vector<replay::ReplayFrame>& frames, std::uint32_t step, bool stream,
+         std::uint32_t keyframeInterval, const char* label) {
+    replay::FrameCoder encoder(60);
+    replay::FrameCoder decoder(60);
+    std::vector<std::uint8_t> buffer(replay::FrameCoder::MAX_ENCODED_SIZE);
+    std::size_t bytes = 0;
+    std::size_t playerFrames = 0;
+    double encodeSec = 0.0;
+    double decodeSec = 0.0;
+    replay::ReplayFrame decoded;
+    for (std::size_t i = step; i < frames.size(); i += step) {
+        const replay::ReplayFrame& ref = frames[i - step];
+        const replay::ReplayFrame& cur = frames[i];
+        if (!stream || cur.tick % keyframeInterval < step) {
+            encoder.reset();
+            decoder.reset();
+        }
+
+        std::size_t size = 0;
+        const auto encodeStart = Clock::now();
+        const bool ok = encoder.encode(ref, cur, buffer.data(), buffer.size(), size);
+        const auto decodeStart = Clock::now();
+        const bool decodedOk = ok && decoder.decode(ref, buffer.data(), size, decoded);
+        const auto end = Clock::now();
+        if (!decodedOk || !sameFrame(decoded, cur)) {
+            std::printf("%-8s round trip failed at tick %u\n", label, cur.tick);
+            return false;
+        }
+        encodeSec += std::chrono::duration<double>(decodeStart - encodeStart).count();
+        decodeSec += std::chrono::duration<double>(end - decodeStart).count();
+        bytes += size;
+        playerFrames += cur.count;
+    }
+    const double perPlayer = static_cast<double>(playerFrames);
+    std::printf("%-8s %6.2f bytes/player/frame  encode %5.0f ns/player  decode %5.0f ns/player\n",
+                label, static_cast<double>(bytes) / perPlayer, encodeSec / perPlayer * 1e9,
+                decodeSec / perPlayer * 1e9);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--players") cfg.players = static_cast<std::size_t>(std::stoul(argv[i + 1]));
+        else if (arg == "--ticks") cfg.ticks = std::stoi(argv[i + 1]);
+        else if (arg == "--interval") cfg.interval = static_cast<std::uint32_t>(std::stoul(argv[i + 1]));
+    }
+    if (cfg.players == 0 || cfg.players > replay::MAX_PLAYERS || cfg.interval == 0) {
+        std::printf("players must be 1..%zu and interval > 0\n", replay::MAX_PLAYERS);
+        return 1;
+    }
+
+    const auto frames = recordMatch(cfg);
+    std::printf("%zu players, %d ticks at 60 Hz\n", cfg.players, cfg.ticks);
+    std::printf("%-8s %6.2f bytes/player/frame\n", "wire",
+                static_cast<double>(net::stateMessageSize(cfg.players)) / static_cast<double>(cfg.players));
+    const bool packetOk = run(frames, cfg.interval, false, cfg.keyframeInterval, "packet");
+    const bool streamOk = run(frames, 1, true, cfg.keyframeInterval, "stream");
+    return packetOk && streamOk ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// Loopback benchmark: server-side CPU cost of the per-tick snapshot burst
+// with ENet versus the batched UDP transport.
+//
+//   sumo_balls_transport_bench [--clients N] [--ticks T] [--players P] [--rate HZ]
+//
+// Clients run on their own thread, so the reported CPU time (thread CPU clock)
+// covers only the server loop: service(), one send per client, flush().
+
+#include "network/NetClient.h"
+#include "network/NetServer.h"
+#include "network/NetProtocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    std::size_t clients{64};
+    int ticks{600};
+    std::size_t players{8};
+    int rateHz{60};
+    std::uint16_t port{7790};
+};
+
+double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+bool run(const BenchConfig& cfg, net::Transport transport, const char* label) {
+    net::NetServer server;
+    if (!server.start(cfg.port, cfg.clients, transport)) {
+        std::printf("%-10s failed to start\n", label);
+        return false;
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> connected{0};
+    std::atomic<std::uint64_t> received{0};
+    std::thread clientThread([&]() {
+        std::vector<std::unique_ptr<net::NetClient>> clients;
+        for (std::size_t i = 0; i < cfg.clients; ++i) {
+            clients.push_back(std::make_unique<net::NetClient>());
+            clients.back()->connect("127.0.0.1", cfg.port, net::CONNECT_PLAYER, transport);
+        }
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (auto& client : clients) {
+                client->service(0,
+                    [&]() { connected.fetch_add(1, std::memory_order_relaxed); },
+                    nullptr,
+                    [&](const ENetPacket*) { received.fetch_add(1, std::memory_order_relaxed); });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (auto& client : clients) client->disconnect();
+    });
+
+    std::vector<ENetPeer*> peers;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (peers.size() < cfg.clients && std::chrono::steady_clock::now() < deadline) {
+        server.service(1, [&](ENetPeer* peer) { peers.push_back(peer); }, nullptr, nullptr);
+    }
+    if (peers.size() < cfg.clients) {
+        std::printf("%-10s only %zu/%zu clients connected\n", label, peers.size(), cfg.clients);
+    }
+
+    net::StateSnapshot snap;
+    snap.players.resize(cfg.players);
+    const auto tickInterval = std::chrono::microseconds(1000000 / cfg.rateHz);
+    std::uint64_t sent = 0;
+    double cpu = 0.0;
+    auto next = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < cfg.ticks; ++tick) {
+        const double start = threadCpuSeconds();
+        server.service(0, nullptr, nullptr, nullptr);
+        snap.tick = static_cast<std::uint32_t>(tick);
+        ENetPacket* packet = net::NetServer::createPacket(net::stateMessageSize(snap.players.size()));
+        net::writeState(packet->data, snap);
+        for (ENetPeer* peer : peers) {
+            if (server.sendPacket(peer, packet)) ++sent;
+        }
+        net::NetServer::releasePacket(packet);
+        server.flush();
+        cpu += threadCpuSeconds() - start;
+
+        next += tickInterval;
+        std::this_thread::sleep_until(next);
+    }
+
+    // Let the last packets land before counting
+    const auto drainUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < drainUntil) server.service(1, nullptr, nullptr, nullptr);
+    stop.store(true);
+    clientThread.join();
+
+    const double perTickUs = cpu / cfg.ticks * 1e6;
+    const double perSendNs = sent ? cpu / static_cast<double>(sent) * 1e9 : 0.0;
+    std::printf("%-10s %4zu clients  %8.1f us/tick  %7.0f ns/send  delivered %llu/%llu\n",
+                label, peers.size(), perTickUs, perSendNs,
+                static_cast<unsigned long long>(received.load()),
+                static_cast<unsigned long long>(sent));
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--clients") cfg.clients = static_cast<std::size_t>(std::stoul(argv[i + 1]));
+        else if (arg == "--ticks") cfg.ticks = std::stoi(argv[i + 1]);
+        else if (arg == "--players") cfg.players = static_cast<std::size_t>(std::stoul(argv[i + 1]));
+        else if (arg == "--rate") cfg.rateHz = std::stoi(argv[i + 1]);
+    }
+
+    std::printf("snapshot %zu bytes, %d ticks at %d Hz\n",
+                net::stateMessageSize(cfg.players), cfg.ticks, cfg.rateHz);
+    run(cfg, net::Transport::ENet, "enet");
+    if (net::UdpBatchTransport::supported()) {
+        ++cfg.port;
+        run(cfg, net::Transport::BatchedUdp, "batched");
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "TestFramework.h"
+#include "game/controllers/BotManager.h"
+#include "game/simulation/Simulation.h"
+
+bool testBotManagerHumanTakesOverBot(std::string& errorMsg) {
+    Simulation sim(300.f, {600.f, 450.f});
+    BotManager bots(sim, BotConfig{4, DifficultyLevel::Medium, 0.5f});
+    bots.addBot(10, {500.f, 450.f});
+    bots.addBot(11, {700.f, 450.f});
+    for (int i = 0; i < 30; ++i) {
+        bots.update(1.f / 60.f);
+        sim.tick(1.f / 60.f);
+    }
+
+    const std::uint32_t botId = bots.releaseForHuman();
+    TEST_ASSERT(botId == 10 || botId == 11, "A living bot should be released");
+    const std::size_t slot = sim.slotOf(botId);
+    const Vec2 before = sim.playerAt(slot)->position;
+
+    TEST_TRUE(sim.reassignPlayer(botId, 42));
+    TEST_EQUAL(slot, sim.slotOf(42), "Human should inherit the bot's slot");
+    TEST_EQUAL(Simulation::INVALID_SLOT, sim.slotOf(botId), "Bot id should be gone");
+    TEST_EQUAL(before.x, sim.playerAt(slot)->position.x, "Ball must not move on takeover");
+    TEST_EQUAL(1u, bots.count(), "Released bot is no longer managed");
+    TEST_FALSE(bots.isBot(42));
+    return true;
+}
+
+bool testBotManagerBudgetRoundRobin(std::string& errorMsg) {
+    Simulation sim(300.f, {600.f, 450.f});
+    // A zero budget still guarantees one decision per tick
+    BotManager bots(sim, BotConfig{6, DifficultyLevel::Medium, 0.f});
+    for (std::uint32_t id = 1; id <= 4; ++id) {
+        bots.addBot(id, {500.f + 50.f * static_cast<float>(id), 450.f});
+    }
+
+    for (int i = 0; i < 8; ++i) bots.update(1.f / 60.f);
+    TEST_EQUAL(8u, bots.stats().updates, "Exactly one bot should be updated per tick");
+    TEST_EQUAL(8u * 3u, bots.stats().deferred, "The other bots should be deferred");
+
+    TEST_ASSERT(bots.removeAny() != 0, "removeAny should remove a bot");
+    TEST_EQUAL(3u, bots.count(), "Three bots should remain");
+    bots.clear();
+    TEST_EQUAL(0u, sim.playerCount(), "clear() should remove bot balls from the simulation");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct BotManagerTestsRegistration {
+        BotManagerTestsRegistration() {
+            test::TestSuite::instance().registerTest("BotManager::HumanTakesOverBot", testBotManagerHumanTakesOverBot);
+            test::TestSuite::instance().registerTest("BotManager::BudgetRoundRobin", testBotManagerBudgetRoundRobin);
+        }
+    } botManagerTests;
+}
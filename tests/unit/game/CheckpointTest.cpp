@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+#include "game/checkpoint/MatchCheckpoint.h"
+#include "game/simulation/Simulation.h"
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+std::string tempCheckpointPath(const char* name) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+}
+
+bool testCheckpointRestoresMatch(std::string& errorMsg) {
+    const std::string path = tempCheckpointPath("sumo_checkpoint_restore.sbck");
+    Simulation sim(300.f, {600.f, 450.f});
+    sim.addPlayer(1, {500.f, 450.f});
+    sim.addPlayer(2, {700.f, 450.f});
+    for (int i = 0; i < 30; ++i) {
+        sim.applyInput(1, {1.f, 0.f});
+        sim.tick(1.f / 60.f);
+    }
+
+    {
+        checkpoint::CheckpointFile file;
+        TEST_TRUE(file.open(path));
+        checkpoint::MatchState state;
+        checkpoint::captureSimulation(sim, state);
+        state.tick = 30;
+        state.nextPlayerId = 3;
+        state.players[0].resumeToken = 1234;
+        file.write(state);
+    }
+
+    // A fresh process maps the same file and rebuilds the match
+    checkpoint::CheckpointFile file;
+    TEST_TRUE(file.open(path));
+    checkpoint::MatchState loaded;
+    TEST_TRUE(file.load(loaded));
+    TEST_EQUAL(30u, loaded.tick, "Tick counter should survive");
+    TEST_EQUAL(3u, loaded.nextPlayerId, "Id allocator should survive");
+    TEST_EQUAL(1234u, loaded.players[0].resumeToken, "Resume token should survive");
+
+    Simulation restored(300.f, {600.f, 450.f});
+    checkpoint::restoreSimulation(loaded, restored);
+    TEST_EQUAL(2u, restored.playerCount(), "Both players should be restored");
+    const SimPlayer* before = sim.playerAt(sim.slotOf(1));
+    const SimPlayer* after = restored.playerAt(restored.slotOf(1));
+    TEST_TRUE(after != nullptr);
+    TEST_EQUAL(before->position.x, after->position.x, "Position should be exact");
+    TEST_EQUAL(before->velocity.x, after->velocity.x, "Velocity should be exact");
+
+    file.clear();
+    TEST_FALSE(file.load(loaded));
+    file.close();
+    std::filesystem::remove(path);
+    return true;
+}
+
+bool testCheckpointFallsBackOnTornSlot(std::string& errorMsg) {
+    const std::string path = tempCheckpointPath("sumo_checkpoint_torn.sbck");
+    checkpoint::CheckpointFile file;
+    TEST_TRUE(file.open(path));
+
+    checkpoint::MatchState state;
+    state.tick = 100;
+    file.write(state);
+    state.tick = 160;
+    file.write(state);
+
+    checkpoint::MatchState loaded;
+    TEST_TRUE(file.load(loaded));
+    TEST_EQUAL(160u, loaded.tick, "Newest checkpoint should win");
+    file.close();
+
+    // Corrupt the newest slot on disk (second slot after the 64-byte header)
+    {
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        TEST_TRUE(f != nullptr);
+        const long slotStride = static_cast<long>((sizeof(checkpoint::MatchState) + 63) / 64 * 64);
+        std::fseek(f, 64 + slotStride + 20, SEEK_SET);
+        std::fputc(0x5A, f);
+        std::fclose(f);
+    }
+
+    TEST_TRUE(file.open(path));
+    TEST_TRUE(file.load(loaded));
+    TEST_EQUAL(100u, loaded.tick, "A torn slot should fall back to the previous checkpoint");
+    file.close();
+    std::filesystem::remove(path);
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct CheckpointTestsRegistration {
+        CheckpointTestsRegistration() {
+            test::TestSuite::instance().registerTest("Checkpoint::RestoresMatch", testCheckpointRestoresMatch);
+            test::TestSuite::instance().registerTest("Checkpoint::FallsBackOnTornSlot", testCheckpointFallsBackOnTornSlot);
+        }
+    } checkpointTests;
+}
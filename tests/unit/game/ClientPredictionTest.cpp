@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+#include "game/prediction/ClientPrediction.h"
+#include "network/InputHistory.h"
+#include "utils/VectorMath.h"
+#include <cmath>
+#include <deque>
+
+namespace {
+constexpr float kDt = 1.f / 60.f;
+
+// What the server would send: its world at `tick` as a decoded State view
+struct ServerView {
+    std::vector<std::uint8_t> packet;
+    net::DecodedMessage msg;
+};
+
+void capture(const Simulation& sim, std::uint32_t tick, Vec2 shift, ServerView& out) {
+    net::StateSnapshot snap;
+    snap.tick = tick;
+    snap.arenaRadius = sim.getArenaRadius();
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        snap.players.push_back({p.id, p.position.x + shift.x, p.position.y + shift.y, p.velocity.x, p.velocity.y,
+                                static_cast<std::uint8_t>(p.alive ? 1 : 0)});
+    });
+    out.packet = net::serializeState(snap);
+    net::decodeMessage(out.packet.data(), out.packet.size(), out.msg);
+}
+
+Vec2 localDisplay(const prediction::ClientPrediction& client) {
+    const Simulation& world = client.world();
+    const SimPlayer* me = world.playerAt(world.slotOf(client.localPlayerId()));
+    return me ? client.displayPosition(me->id, me->position) : Vec2{0.f, 0.f};
+}
+
+net::InputCommand steer(net::InputHistory& history, int step) {
+    net::InputCommand cmd;
+    cmd.dirX = std::cos(step * 0.05f);
+    cmd.dirY = std::sin(step * 0.05f);
+    history.record(cmd);
+    return cmd;
+}
+}
+
+bool testPredictionMatchesServerWithLatency(std::string& errorMsg) {
+    Simulation server;
+    server.addPlayer(1, {500.f, 450.f});
+    server.addPlayer(2, {700.f, 450.f});
+
+    prediction::ClientPrediction client;
+    client.reset(1);
+    ServerView view;
+    capture(server, 0, {0.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{0, 0});
+    TEST_TRUE(client.hasState());
+
+    // Inputs reach the server six ticks after the client predicted them
+    constexpr int latencyTicks = 6;
+    net::InputHistory history;
+    std::deque<net::InputCommand> inFlight;
+    std::uint32_t applied = 0;
+    for (int i = 0; i < 240; ++i) {
+        const net::InputCommand cmd = steer(history, i);
+        client.step(cmd);
+        inFlight.push_back(cmd);
+        if (inFlight.size() > latencyTicks) {
+            server.applyInput(1, {inFlight.front().dirX, inFlight.front().dirY});
+            applied = inFlight.front().sequence;
+            inFlight.pop_front();
+            server.tick(kDt);
+        }
+        if (i % 3 == 2 && applied > 0) {
+            capture(server, static_cast<std::uint32_t>(i), {0.f, 0.f}, view);
+            client.onState(view.msg.state);
+            client.onInputAck(net::InputAck{static_cast<std::uint32_t>(i), applied});
+            TEST_EQUAL(static_cast<std::size_t>(latencyTicks), client.pendingInputs(), "Unacked inputs stay pending");
+        }
+    }
+    // Same inputs, same physics: replaying on top of each snapshot lands where the prediction was
+    TEST_TRUE(client.lastCorrection() < 0.01f);
+    TEST_EQUAL(0u, client.corrections(), "A faithful prediction needs no corrections");
+    return true;
+}
+
+bool testPredictionMatchesServerWithClumpedInputs(std::string& errorMsg) {
+    Simulation server;
+    server.addPlayer(1, {500.f, 450.f});
+    server.addPlayer(2, {700.f, 450.f});
+
+    prediction::ClientPrediction client;
+    client.reset(1);
+    ServerView view;
+    capture(server, 0, {0.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{0, 0});
+
+    // One bundle per client tick, but the network hands them over three at a
+    // time, six ticks late; the server drains them the way server_main does
+    constexpr int latencyTicks = 6;
+    net::InputHistory history;
+    net::InputQueue queue;
+    std::uint32_t receivedSequence = 0;
+    std::deque<std::vector<std::uint8_t>> inFlight;
+    for (int i = 0; i < 240; ++i) {
+        net::InputCommand cmd = steer(history, i);
+        client.step(cmd);
+        std::vector<std::uint8_t> packet(history.bundleSize());
+        history.writeBundle(packet.data());
+        inFlight.push_back(std::move(packet));
+
+        if (inFlight.size() == latencyTicks + 3) {
+            while (inFlight.size() > latencyTicks) {
+                const auto& due = inFlight.front();
+                net::readInputBundle(due.data(), due.size(), [&](const net::InputCommand& in) {
+                    if (in.sequence <= receivedSequence) return;
+                    receivedSequence = in.sequence;
+                    queue.push(in);
+                });
+                inFlight.pop_front();
+            }
+        }
+        net::InputCommand next{};
+        if (queue.popForTick(next)) server.applyInput(1, {next.dirX, next.dirY});
+        if (queue.lastApplied() > 0) server.tick(kDt);
+
+        if (i % 3 == 2 && queue.lastApplied() > 0) {
+            capture(server, static_cast<std::uint32_t>(i), {0.f, 0.f}, view);
+            client.onState(view.msg.state);
+            client.onInputAck(net::InputAck{static_cast<std::uint32_t>(i), queue.lastApplied()});
+            TEST_TRUE(queue.size() < 3);
+        }
+    }
+    // A clump is spread over the ticks that follow instead of collapsing onto its last input
+    TEST_EQUAL(std::uint64_t{0}, queue.dropped(), "Steady clumps fit within the hold cap");
+    TEST_TRUE(client.lastCorrection() < 0.01f);
+    TEST_EQUAL(0u, client.corrections(), "Every input simulated on its own tick needs no corrections");
+    return true;
+}
+
+bool testPredictionSmoothsCorrections(std::string& errorMsg) {
+    Simulation server;
+    server.addPlayer(1, {500.f, 450.f});
+    prediction::ClientPrediction client;
+    client.reset(1);
+    ServerView view;
+    capture(server, 0, {0.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{0, 0});
+
+    net::InputHistory history;
+    for (int i = 0; i < 10; ++i) client.step(steer(history, i));
+    const Vec2 before = localDisplay(client);
+
+    // The server disagrees by 30 units: the ball is still drawn where it was...
+    for (int i = 0; i < 10; ++i) server.tick(kDt);
+    capture(server, 10, {30.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{11, 5});  // not this snapshot's ack: ignored
+    TEST_EQUAL(0u, client.corrections(), "Acks only apply to their own snapshot");
+    client.onInputAck(net::InputAck{10, 5});
+    TEST_EQUAL(1u, client.corrections(), "Mismatch should be corrected");
+    TEST_EQUAL(5u, client.pendingInputs(), "Acked inputs are dropped");
+    TEST_TRUE(VectorMath::magnitude(localDisplay(client) - before) < 0.01f);
+
+    // ...then blended onto the corrected prediction over a few frames
+    const SimPlayer* me = client.world().playerAt(client.world().slotOf(1));
+    for (int frame = 0; frame < 60; ++frame) client.decayCorrection(kDt);
+    TEST_TRUE(VectorMath::magnitude(localDisplay(client) - me->position) < 0.1f);
+
+    // A respawn-sized jump is not smoothed
+    capture(server, 20, {400.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{20, 10});
+    TEST_TRUE(VectorMath::magnitude(localDisplay(client) - me->position) < 0.01f);
+    return true;
+}
+
+bool testPredictionPairsStateWithAck(std::string& errorMsg) {
+    Simulation server;
+    server.addPlayer(1, {500.f, 450.f});
+    prediction::ClientPrediction client;
+    client.reset(1);
+    net::InputHistory history;
+    for (int i = 0; i < 10; ++i) client.step(steer(history, i));
+
+    // The ack may arrive ahead of its snapshot
+    ServerView view;
+    capture(server, 10, {0.f, 0.f}, view);
+    client.onInputAck(net::InputAck{10, 4});
+    TEST_EQUAL(10u, client.pendingInputs(), "No snapshot to apply yet");
+    client.onState(view.msg.state);
+    TEST_EQUAL(6u, client.pendingInputs(), "Snapshot should pair with the ack that came first");
+
+    // A later ack waits for its own snapshot; an older one pairs with the snapshot
+    capture(server, 20, {0.f, 0.f}, view);
+    client.onState(view.msg.state);
+    client.onInputAck(net::InputAck{22, 7});
+    TEST_EQUAL(6u, client.pendingInputs(), "Ack is for a later snapshot");
+    client.onInputAck(net::InputAck{18, 6});
+    TEST_EQUAL(4u, client.pendingInputs(), "Newest ack at or before the snapshot pairs with it");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct ClientPredictionTestsRegistration {
+        ClientPredictionTestsRegistration() {
+            test::TestSuite::instance().registerTest("ClientPrediction::MatchesServerWithLatency", testPredictionMatchesServerWithLatency);
+            test::TestSuite::instance().registerTest("ClientPrediction::MatchesServerWithClumpedInputs", testPredictionMatchesServerWithClumpedInputs);
+            test::TestSuite::instance().registerTest("ClientPrediction::SmoothsCorrections", testPredictionSmoothsCorrections);
+            test::TestSuite::instance().registerTest("ClientPrediction::PairsStateWithAck", testPredictionPairsStateWithAck);
+        }
+    } clientPredictionTests;
+}
@@ -0,0 +1,104 @@
+#include "TestFramework.h"
+#include "game/replay/FrameCoder.h"
+#include "game/simulation/Simulation.h"
+#include <random>
+
+namespace {
+bool sameFrame(const replay::ReplayFrame& a, const replay::ReplayFrame& b) {
+    if (a.tick != b.tick || a.count != b.count) return false;
+    for (std::uint32_t i = 0; i < a.count; ++i) {
+        const replay::ReplayPlayer& p = a.players[i];
+        const replay::ReplayPlayer& q = b.players[i];
+        if (p.id != q.id || p.x != q.x || p.y != q.y || p.vx != q.vx || p.vy != q.vy || p.alive != q.alive) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+bool testRangeCoderRoundTrip(std::string& errorMsg) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> small(-4, 4);
+    std::vector<std::int32_t> values;
+    for (int i = 0; i < 2000; ++i) values.push_back(i % 50 == 0 ? static_cast<std::int32_t>(rng()) : small(rng));
+
+    std::vector<std::uint8_t> buffer(16384);
+    rc::ResidualModel<2> encModel;
+    rc::RangeEncoder enc(buffer.data(), buffer.size());
+    for (std::size_t i = 0; i < values.size(); ++i) encModel.encode(enc, values[i], i & 1);
+    const std::size_t size = enc.finish();
+    TEST_FALSE(enc.overflow());
+    TEST_ASSERT(size < values.size(), "Mostly-small residuals should average under a byte");
+
+    rc::ResidualModel<2> decModel;
+    rc::RangeDecoder dec(buffer.data(), size);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        TEST_EQUAL(values[i], decModel.decode(dec, i & 1), "Residual should round-trip");
+    }
+
+    rc::RangeEncoder tiny(buffer.data(), 4);
+    for (std::int32_t v : values) encModel.encode(tiny, v, 0);
+    tiny.finish();
+    TEST_TRUE(tiny.overflow());
+    return true;
+}
+
+bool testFrameCoderTracksSimulation(std::string& errorMsg) {
+    Simulation sim(300.f, {600.f, 450.f});
+    for (std::uint32_t id = 1; id <= 8; ++id) {
+        sim.addPlayer(id, {450.f + static_cast<float>(id) * 35.f, 450.f});
+        sim.applyInput(id, {id % 2 ? 1.f : -1.f, 0.3f});
+    }
+
+    replay::FrameCoder encoder(60);
+    replay::FrameCoder decoder(60);
+    replay::ReplayFrame ref, cur, decoded, mirror;
+    replay::captureFrame(sim, 0, ref);
+    mirror = ref;
+    std::uint8_t buffer[replay::FrameCoder::MAX_ENCODED_SIZE];
+    std::size_t totalBytes = 0;
+    for (std::uint32_t tick = 1; tick <= 240; ++tick) {
+        if (tick == 100) sim.removePlayer(3);
+        if (tick == 150) sim.addPlayer(42, {600.f, 450.f});
+        sim.tick(1.f / 60.f);
+        replay::captureFrame(sim, tick, cur);
+
+        std::size_t size = 0;
+        TEST_TRUE(encoder.encode(ref, cur, buffer, sizeof(buffer), size));
+        TEST_TRUE(decoder.decode(mirror, buffer, size, decoded));
+        TEST_ASSERT(sameFrame(cur, decoded), "Decoded frame must match exactly");
+        totalBytes += size;
+        ref = cur;
+        mirror = decoded;
+    }
+    TEST_ASSERT(totalBytes < 240 * 8 * 4, "Coasting players should cost well under 4 bytes per tick");
+
+    // Out-of-range tick gaps are refused instead of mis-predicted
+    std::size_t size = 0;
+    TEST_FALSE(encoder.encode(cur, cur, buffer, sizeof(buffer), size));
+    return true;
+}
+
+bool testCaptureFrameCountsLeftOut(std::string& errorMsg) {
+    Simulation sim(300.f, {600.f, 450.f});
+    const auto total = static_cast<std::uint32_t>(replay::MAX_PLAYERS + 3);
+    for (std::uint32_t id = 1; id <= total; ++id) {
+        sim.addPlayer(id, {600.f + static_cast<float>(id), 450.f});
+    }
+    replay::ReplayFrame frame;
+    TEST_EQUAL(3u, replay::captureFrame(sim, 1, frame), "Players past MAX_PLAYERS should be reported");
+    TEST_EQUAL(replay::MAX_PLAYERS, static_cast<std::size_t>(frame.count), "The frame should be full");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct FrameCoderTestsRegistration {
+        FrameCoderTestsRegistration() {
+            test::TestSuite::instance().registerTest("FrameCoder::RangeCoderRoundTrip", testRangeCoderRoundTrip);
+            test::TestSuite::instance().registerTest("FrameCoder::TracksSimulation", testFrameCoderTracksSimulation);
+            test::TestSuite::instance().registerTest("FrameCoder::CaptureCountsLeftOut", testCaptureFrameCountsLeftOut);
+        }
+    } frameCoderTests;
+}
@@ -0,0 +1,158 @@
+#include "TestFramework.h"
+#include "game/prediction/InterpolationBuffer.h"
+#include "network/NetworkConditioner.h"
+#include "utils/VectorMath.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+// One remote player circling at constant speed, as the server would send it
+struct Orbit {
+    Vec2 center{600.f, 450.f};
+    float radius{150.f};
+    float omega{4.f};  // rad/s
+
+    Vec2 position(double ms) const {
+        const float a = static_cast<float>(ms * 0.001) * omega;
+        return center + Vec2{std::cos(a), std::sin(a)} * radius;
+    }
+    Vec2 velocity(double ms) const {
+        const float a = static_cast<float>(ms * 0.001) * omega;
+        return Vec2{-std::sin(a), std::cos(a)} * (radius * omega);
+    }
+};
+
+struct Sender {
+    std::vector<std::uint8_t> packet;
+    net::DecodedMessage msg;
+
+    const net::StateView& state(const Orbit& orbit, std::uint32_t serverMs, bool alive = true) {
+        net::StateSnapshot snap;
+        snap.tick = serverMs;
+        snap.serverTimeMs = serverMs;
+        snap.arenaRadius = 300.f;
+        const Vec2 p = orbit.position(serverMs);
+        const Vec2 v = orbit.velocity(serverMs);
+        snap.players.push_back({7, p.x, p.y, v.x, v.y, static_cast<std::uint8_t>(alive ? 1 : 0)});
+        packet = net::serializeState(snap);
+        net::decodeMessage(packet.data(), packet.size(), msg);
+        return msg.state;
+    }
+};
+}
+
+bool testInterpolationFollowsCurvedPath(std::string& errorMsg) {
+    Orbit orbit;
+    Sender sender;
+    prediction::InterpolationBuffer buffer;
+
+    // 20 Hz snapshots over a steady 40 ms path, rendered at 100 Hz
+    float worstError = 0.f;
+    std::uint32_t nextSnapshot = 0;
+    for (std::uint32_t now = 40; now < 12000; now += 10) {
+        while (nextSnapshot + 40 <= now) {
+            buffer.push(sender.state(orbit, nextSnapshot), nextSnapshot + 40);
+            nextSnapshot += 50;
+        }
+        buffer.update(now, 0.01f);
+        TEST_EQUAL(std::size_t{1}, buffer.players().size(), "One tracked player");
+        if (now < 1000) continue;  // let the delay settle
+        const prediction::InterpolatedPlayer& p = buffer.players()[0];
+        TEST_FALSE(p.extrapolated);
+        worstError = std::max(worstError, VectorMath::magnitude(p.position - orbit.position(buffer.renderTimeMs())));
+    }
+    // Straight lines between 50 ms samples would cut the circle by ~0.75 units
+    TEST_TRUE(worstError < 0.05f);
+    // Without jitter the delay shrinks to one snapshot interval
+    TEST_TRUE(std::abs(buffer.delayMs() - 50.f) < 5.f);
+    TEST_EQUAL(std::uint64_t{0}, buffer.extrapolatedFrames(), "Steady arrivals never run dry");
+    return true;
+}
+
+bool testInterpolationAdaptsToJitter(std::string& errorMsg) {
+    Orbit orbit;
+    Sender sender;
+    prediction::InterpolationBuffer buffer;
+
+    // Transit alternates 30 / 70 ms: 40 ms of jitter between consecutive snapshots
+    std::uint32_t nextSnapshot = 0;
+    std::uint32_t now = 0;
+    for (; now < 4000; now += 10) {
+        while (true) {
+            const std::uint32_t transit = (nextSnapshot / 50) % 2 ? 70u : 30u;
+            if (nextSnapshot + transit > now) break;
+            buffer.push(sender.state(orbit, nextSnapshot), nextSnapshot + transit);
+            nextSnapshot += 50;
+        }
+        buffer.update(now, 0.01f);
+    }
+    const float calmDelay = 50.f;
+    TEST_TRUE(buffer.jitterMs() > 30.f);
+    TEST_TRUE(buffer.delayMs() > calmDelay + 60.f);
+    TEST_TRUE(buffer.delayMs() <= 400.f);
+    TEST_EQUAL(std::uint64_t{0}, buffer.extrapolatedFrames(), "The delay covers the late snapshots");
+
+    // Then the stream stops: coast along the last velocity for at most 150 ms, then hold
+    const double last = nextSnapshot - 50;
+    const Vec2 coasted = orbit.position(last) + orbit.velocity(last) * 0.15f;
+    for (int i = 0; i < 50; ++i) buffer.update(now += 10, 0.01f);
+    const prediction::InterpolatedPlayer stopped = buffer.players()[0];
+    TEST_TRUE(stopped.extrapolated);
+    TEST_TRUE(VectorMath::magnitude(stopped.position - coasted) < 0.01f);
+    for (int i = 0; i < 10; ++i) buffer.update(now += 10, 0.01f);
+    TEST_TRUE(VectorMath::magnitude(buffer.players()[0].position - coasted) < 0.01f);
+
+    // An elimination is shown as it happened, not blended
+    buffer.push(sender.state(orbit, nextSnapshot, false), now);
+    for (int i = 0; i < 100; ++i) buffer.update(now += 10, 0.01f);
+    TEST_FALSE(buffer.players()[0].alive);
+    return true;
+}
+
+bool testInterpolationRidesOutCongestedWifi(std::string& errorMsg) {
+    Orbit orbit;
+    Sender sender;
+    prediction::InterpolationBuffer buffer;
+    net::NetworkConditioner path(*net::findConditionProfile("congested-wifi"), 5);
+
+    // The server's 30 ms snapshots cross two calm and two contended spells
+    std::uint32_t frames = 0;
+    float worstError = 0.f;
+    float longestDelay = 0.f;
+    for (std::uint32_t now = 0; now < 16000; ++now) {
+        path.update(now);
+        if (now % GameConstants::SNAPSHOT_RATE_MS == 0) {
+            std::uint32_t serverMs = now;
+            path.downstream().submit(now, reinterpret_cast<const std::uint8_t*>(&serverMs), sizeof(serverMs));
+        }
+        path.downstream().release(now, [&](const std::uint8_t* data, std::size_t) {
+            std::uint32_t serverMs;
+            std::memcpy(&serverMs, data, sizeof(serverMs));
+            buffer.push(sender.state(orbit, serverMs), now);
+        });
+        if (now % 10 != 0 || now < 1000) continue;
+        buffer.update(now, 0.01f);
+        ++frames;
+        longestDelay = std::max(longestDelay, buffer.delayMs());
+        if (buffer.players()[0].extrapolated) continue;
+        worstError = std::max(worstError, VectorMath::magnitude(buffer.players()[0].position -
+                                                                orbit.position(buffer.renderTimeMs())));
+    }
+    // Contention pushes the delay up instead of leaving the buffer to run dry...
+    TEST_TRUE(longestDelay > 100.f && longestDelay < 400.f);
+    // ...so only loss bursts and the worst stragglers need extrapolation
+    TEST_TRUE(buffer.extrapolatedFrames() * 100 < frames * 15);
+    TEST_TRUE(worstError < 0.5f);
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct InterpolationBufferTestsRegistration {
+        InterpolationBufferTestsRegistration() {
+            test::TestSuite::instance().registerTest("InterpolationBuffer::FollowsCurvedPath", testInterpolationFollowsCurvedPath);
+            test::TestSuite::instance().registerTest("InterpolationBuffer::AdaptsToJitter", testInterpolationAdaptsToJitter);
+            test::TestSuite::instance().registerTest("InterpolationBuffer::RidesOutCongestedWifi", testInterpolationRidesOutCongestedWifi);
+        }
+    } interpolationBufferTests;
+}
@@ -0,0 +1,200 @@
+#include "TestFramework.h"
+#include "game/lockstep/LockstepSimulation.h"
+#include "network/LockstepRelay.h"
+#include <cmath>
+
+namespace {
+net::LockstepStartHeader startHeader(std::uint32_t playerCount) {
+    net::LockstepStartHeader header;
+    header.startTick = 100;
+    header.tickRateHz = 60;
+    header.hashInterval = 30;
+    header.arenaRadius = 300.f;
+    header.arenaCenterX = 600.f;
+    header.arenaCenterY = 450.f;
+    header.playerCount = playerCount;
+    return header;
+}
+
+// Steer both players toward each other with a little wobble so they collide
+void steer(net::LockstepRelay& relay, int frame) {
+    relay.setInput(1, 1.f, std::sin(frame * 0.1f));
+    if (frame % 20 < 10) relay.setInput(2, -1.f, 0.f);
+    else relay.setInput(2, -1.f, 0.5f);
+}
+}
+
+bool testLockstepPeersStayIdentical(std::string& errorMsg) {
+    const std::vector<net::LockstepPlayer> roster = {{1, 500.f, 450.f}, {2, 700.f, 450.f}};
+    const auto header = startHeader(2);
+    lockstep::LockstepSimulation a(header, roster);
+    lockstep::LockstepSimulation b(header, roster);
+
+    net::LockstepRelay relay;
+    relay.begin(header.startTick, header.hashInterval, {1, 2});
+
+    std::size_t inputsSent = 0;
+    for (int frame = 0; frame < 240; ++frame) {
+        steer(relay, frame);
+        net::LockstepFrameHeader fh;
+        const auto& inputs = relay.nextFrame(fh);
+        inputsSent += inputs.size();
+        TEST_TRUE(a.pushFrame(fh, inputs));
+        TEST_TRUE(b.pushFrame(fh, inputs));
+        // Peers may run at different paces; b catches up in bursts
+        a.advance();
+        if (frame % 7 == 0) b.advance();
+    }
+    b.advance();
+    TEST_EQUAL(a.nextTick(), b.nextTick(), "Both peers should have run every frame");
+    TEST_ASSERT(inputsSent < 240 * 2, "Frames should only carry inputs that changed");
+
+    const SimPlayer* p1 = a.simulation().playerAt(a.simulation().slotOf(1));
+    TEST_TRUE(p1 != nullptr);
+    TEST_ASSERT(p1->collisions > 0, "Players should have collided during the run");
+
+    net::StateHash ha{}, hb{};
+    int reports = 0;
+    while (a.takeHash(ha)) {
+        TEST_TRUE(b.takeHash(hb));
+        TEST_EQUAL(ha.tick, hb.tick, "Hashes should be reported for the same ticks");
+        TEST_TRUE(ha.hash == hb.hash);
+        const net::HashCheck first = relay.submitHash(1, ha);
+        TEST_FALSE(first.complete);
+        const net::HashCheck second = relay.submitHash(2, hb);
+        TEST_TRUE(second.complete);
+        TEST_TRUE(second.agreed);
+        ++reports;
+    }
+    TEST_EQUAL(8, reports, "240 ticks at a 30 tick interval give 8 hashes");
+    TEST_EQUAL(0u, relay.desyncs(), "Identical peers must never desync");
+    return true;
+}
+
+bool testLockstepRelayBlamesMinority(std::string& errorMsg) {
+    net::LockstepRelay relay;
+    relay.begin(0, 30, {1, 2, 3});
+    net::LockstepFrameHeader fh;
+    for (int i = 0; i < 40; ++i) relay.nextFrame(fh);
+
+    net::StateHash good{};
+    good.tick = 29;
+    good.hash = 0xABCD;
+    net::StateHash bad = good;
+    bad.hash = 0x1234;
+
+    relay.submitHash(1, good);
+    relay.submitHash(2, bad);
+    const net::HashCheck check = relay.submitHash(3, good);
+    TEST_TRUE(check.complete);
+    TEST_FALSE(check.agreed);
+    TEST_TRUE(check.hasMajority);
+    TEST_EQUAL(1u, check.outliers.size(), "Only the diverging peer should be blamed");
+    TEST_EQUAL(2u, check.outliers[0], "Peer 2 reported the odd hash");
+
+    // Once it is dropped, the remaining two peers settle the next check alone
+    relay.dropPlayer(2);
+    good.tick = 59;
+    relay.submitHash(1, good);
+    TEST_TRUE(relay.submitHash(3, good).agreed);
+    TEST_EQUAL(1u, relay.desyncs(), "One desync should be counted");
+    return true;
+}
+
+bool testLockstepRelayDropCompletesChecks(std::string& errorMsg) {
+    net::LockstepRelay relay;
+    relay.begin(0, 30, {1, 2, 3});
+    net::LockstepFrameHeader fh;
+    for (int i = 0; i < 70; ++i) relay.nextFrame(fh);
+
+    net::StateHash good{};
+    good.tick = 29;
+    good.hash = 0xABCD;
+    TEST_FALSE(relay.submitHash(1, good).complete);
+    TEST_FALSE(relay.submitHash(3, good).complete);
+    // Peer 2 skipped tick 29, reported a diverging hash for tick 59, then left
+    good.tick = 59;
+    net::StateHash bad = good;
+    bad.hash = 0x1234;
+    TEST_FALSE(relay.submitHash(1, good).complete);
+    TEST_FALSE(relay.submitHash(2, bad).complete);
+
+    const std::vector<net::HashCheck> settled = relay.dropPlayer(2);
+    TEST_EQUAL(1u, settled.size(), "Tick 29 was only waiting on the dropped peer");
+    TEST_EQUAL(29u, settled[0].tick, "Settled check should name its tick");
+    TEST_TRUE(settled[0].agreed);
+
+    // The dropped peer's report no longer votes
+    const net::HashCheck check = relay.submitHash(3, good);
+    TEST_TRUE(check.complete);
+    TEST_TRUE(check.agreed);
+    TEST_EQUAL(0u, relay.desyncs(), "No desync among the remaining peers");
+    TEST_TRUE(relay.dropPlayer(2).empty());
+    return true;
+}
+
+bool testLockstepClientFollowsTheWire(std::string& errorMsg) {
+    // What the server sends, encoded as it would be on the reliable channel
+    const std::vector<net::LockstepPlayer> roster = {{1, 500.f, 450.f}, {2, 700.f, 450.f}};
+    const auto header = startHeader(2);
+    std::vector<std::uint8_t> packet(net::lockstepStartSize(roster.size()));
+    net::writeLockstepStart(packet.data(), header, roster.data());
+
+    // Client side, as MatchScene handles it: decode into reused buffers
+    net::DecodedMessage decoded;
+    TEST_TRUE(net::decodeMessage(packet.data(), packet.size(), decoded).isSuccess());
+    TEST_TRUE(decoded.type == net::MessageType::LockstepStart);
+    std::vector<net::LockstepPlayer> decodedRoster;
+    decoded.roster.copyTo(decodedRoster);
+    lockstep::LockstepSimulation client(decoded.lockstepStart, decodedRoster);
+    lockstep::LockstepSimulation reference(header, roster);
+
+    net::LockstepRelay relay;
+    relay.begin(header.startTick, header.hashInterval, {1, 2});
+    std::vector<net::LockstepInput> inputs;
+    int reports = 0;
+    for (int frame = 0; frame < 120; ++frame) {
+        steer(relay, frame);
+        net::LockstepFrameHeader fh;
+        const auto& sent = relay.nextFrame(fh);
+        packet.resize(net::lockstepFrameSize(sent.size()));
+        net::writeLockstepFrame(packet.data(), fh, sent.data());
+        TEST_TRUE(net::decodeMessage(packet.data(), packet.size(), decoded).isSuccess());
+        decoded.lockstepInputs.copyTo(inputs);
+        TEST_TRUE(client.pushFrame(decoded.lockstepFrame, inputs));
+        TEST_TRUE(reference.pushFrame(fh, sent));
+        client.advance();
+        reference.advance();
+
+        // The client's hash goes back as a StateHash message; the reference peer agrees
+        net::StateHash mine{}, theirs{};
+        while (client.takeHash(mine)) {
+            TEST_TRUE(reference.takeHash(theirs));
+            packet.resize(net::messageSize<net::StateHash>());
+            net::writeMessage(packet.data(), net::MessageType::StateHash, mine);
+            TEST_TRUE(net::decodeMessage(packet.data(), packet.size(), decoded).isSuccess());
+            relay.submitHash(1, decoded.stateHash);
+            const net::HashCheck check = relay.submitHash(2, theirs);
+            TEST_TRUE(check.complete && check.agreed);
+            ++reports;
+        }
+    }
+    // A frame that skips a tick cannot be simulated
+    net::LockstepFrameHeader gap;
+    gap.tick = client.nextTick() + 1;
+    TEST_FALSE(client.pushFrame(gap, {}));
+    TEST_EQUAL(4, reports, "120 ticks at a 30 tick interval give 4 hashes");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct LockstepTestsRegistration {
+        LockstepTestsRegistration() {
+            test::TestSuite::instance().registerTest("Lockstep::PeersStayIdentical", testLockstepPeersStayIdentical);
+            test::TestSuite::instance().registerTest("Lockstep::RelayBlamesMinority", testLockstepRelayBlamesMinority);
+            test::TestSuite::instance().registerTest("Lockstep::RelayDropCompletesChecks", testLockstepRelayDropCompletesChecks);
+            test::TestSuite::instance().registerTest("Lockstep::ClientFollowsTheWire", testLockstepClientFollowsTheWire);
+        }
+    } lockstepTests;
+}
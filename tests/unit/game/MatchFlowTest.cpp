@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+#include "game/match/MatchFlow.h"
+#include "game/simulation/Simulation.h"
+#include <vector>
+
+namespace {
+constexpr float DT = 1.f / 60.f;
+
+// Step like the server: the simulation holds still through the countdown
+bool step(match::MatchFlow& flow, Simulation& sim, std::vector<net::MatchEvent>& events) {
+    if (!flow.countdown()) sim.tick(DT);
+    return flow.update(sim, DT, events);
+}
+
+// Put a ball outside the arena; it is eliminated on the next simulated tick
+void pushOut(Simulation& sim, std::uint32_t id) {
+    sim.addPlayer(id, {sim.arenaCenter.x + sim.arenaRadius * 2.f, sim.arenaCenter.y});
+}
+
+std::size_t countOf(const std::vector<net::MatchEvent>& events, net::MatchEventType type) {
+    std::size_t n = 0;
+    for (const net::MatchEvent& e : events) n += e.type == type ? 1 : 0;
+    return n;
+}
+}
+
+bool testMatchFlowRunsRounds(std::string& errorMsg) {
+    Simulation sim(300.f, {600.f, 450.f});
+    match::MatchFlow flow(match::MatchFlowConfig{2, 3.f, 1.f});
+    std::vector<net::MatchEvent> events;
+
+    sim.addPlayer(1, {500.f, 450.f});
+    TEST_FALSE(step(flow, sim, events));
+    TEST_TRUE(flow.phase() == match::Phase::Waiting);
+
+    sim.addPlayer(2, {700.f, 450.f});
+    sim.addPlayer(3, {600.f, 350.f});
+    TEST_TRUE(step(flow, sim, events));  // the caller respawns everyone here
+    TEST_TRUE(flow.countdown());
+    TEST_TRUE(events.back().type == net::MatchEventType::Countdown && events.back().value == 3);
+
+    // 3, 2, 1 are each announced once, then the round starts
+    events.clear();
+    for (int i = 0; i < 200 && flow.countdown(); ++i) step(flow, sim, events);
+    TEST_EQUAL(2u, countOf(events, net::MatchEventType::Countdown), "Seconds 2 and 1 should be announced");
+    TEST_EQUAL(1u, countOf(events, net::MatchEventType::RoundStarted), "Round should start once");
+    TEST_TRUE(flow.phase() == match::Phase::Playing);
+    TEST_EQUAL(1u, flow.round(), "First round");
+
+    // Each elimination is reported exactly once
+    events.clear();
+    pushOut(sim, 2);
+    for (int i = 0; i < 10; ++i) step(flow, sim, events);
+    TEST_EQUAL(1u, events.size(), "One elimination");
+    TEST_TRUE(events[0].type == net::MatchEventType::Eliminated && events[0].playerId == 2);
+
+    // The last elimination ends the round in the same tick
+    events.clear();
+    pushOut(sim, 3);
+    step(flow, sim, events);
+    TEST_EQUAL(2u, events.size(), "Elimination then result");
+    TEST_TRUE(events[1].type == net::MatchEventType::RoundEnded && events[1].playerId == 1);
+    TEST_TRUE(flow.currentPhase().type == net::MatchEventType::RoundEnded);
+
+    // After the results the next round counts down
+    bool newRound = false;
+    for (int i = 0; i < 61 && !newRound; ++i) newRound = step(flow, sim, events);
+    TEST_TRUE(newRound);
+    TEST_TRUE(flow.countdown());
+    return true;
+}
+
+bool testMatchEventsRoundTrip(std::string& errorMsg) {
+    const net::MatchEvent sent[] = {
+        {net::MatchEventType::Eliminated, 7, 0},
+        {net::MatchEventType::RoundEnded, 3, 12},
+    };
+    std::vector<std::uint8_t> packet(net::matchEventsSize(2));
+    TEST_TRUE(net::writeMatchEvents(packet.data(), 4242, sent, 2) == packet.data() + packet.size());
+
+    std::vector<net::MatchEvent> received;
+    TEST_TRUE(net::readMatchEvents(packet.data(), packet.size(), [&](std::uint32_t tick, const net::MatchEvent& e) {
+        if (tick == 4242) received.push_back(e);
+    }));
+    TEST_EQUAL(2u, received.size(), "Both events should arrive with their tick");
+    TEST_TRUE(received[1].type == net::MatchEventType::RoundEnded);
+    TEST_EQUAL(3u, received[1].playerId, "Winner should round-trip");
+    TEST_EQUAL(12u, received[1].value, "Round should round-trip");
+
+    // Truncated messages and unknown event types deliver nothing
+    received.clear();
+    auto keep = [&](std::uint32_t, const net::MatchEvent& e) { received.push_back(e); };
+    TEST_FALSE(net::readMatchEvents(packet.data(), packet.size() - 1, keep));
+    packet[net::matchEventsSize(1)] = 0x7F;
+    TEST_FALSE(net::readMatchEvents(packet.data(), packet.size(), keep));
+    TEST_TRUE(received.empty());
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct MatchFlowTestsRegistration {
+        MatchFlowTestsRegistration() {
+            test::TestSuite::instance().registerTest("MatchFlow::RunsRounds", testMatchFlowRunsRounds);
+            test::TestSuite::instance().registerTest("MatchFlow::EventsRoundTrip", testMatchEventsRoundTrip);
+        }
+    } matchFlowTests;
+}
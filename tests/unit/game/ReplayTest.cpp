@@ -0,0 +1,161 @@
+#include "TestFramework.h"
+#include "game/replay/ReplayRecorder.h"
+#include "game/replay/ReplayReader.h"
+#include "game/simulation/Simulation.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace {
+std::string tempReplayPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Records a short 3-player match; fills expected[tick] with the true player states
+bool recordSampleMatch(const std::string& path, std::map<std::uint32_t, std::vector<SimSnapshotPlayer>>& expected) {
+    Simulation sim(300.f, {600.f, 450.f});
+    replay::ReplayRecorder recorder(1024);
+    replay::ReplayHeader header;
+    header.keyframeInterval = 50;
+    header.arenaRadius = sim.getArenaRadius();
+    if (!recorder.begin(path, header)) return false;
+
+    for (std::uint32_t id = 1; id <= 3; ++id) {
+        sim.addPlayer(id, {500.f + 50.f * static_cast<float>(id), 450.f});
+        recorder.recordEvent(0, replay::EventType::PlayerJoined, id);
+    }
+    for (std::uint32_t tick = 1; tick <= 300; ++tick) {
+        sim.applyInput(1, {1.f, 0.f});
+        sim.applyInput(2, {0.f, tick < 150 ? 1.f : -1.f});
+        if (tick == 200) {
+            sim.removePlayer(3);
+            recorder.recordEvent(tick, replay::EventType::PlayerLeft, 3);
+        }
+        sim.tick(1.f / 60.f);
+        recorder.recordFrame(tick, sim);
+        expected[tick] = sim.snapshotPlayers();
+    }
+    recorder.finish();
+    recorder.waitFinished();
+    return recorder.stats().framesDropped == 0;
+}
+
+bool framesMatch(const replay::ReplayFrame& frame, const std::vector<SimSnapshotPlayer>& players) {
+    if (frame.count != players.size()) return false;
+    const float tolerance = 1.f / replay::POSITION_SCALE;
+    for (const auto& p : players) {
+        const replay::ReplayPlayer* rp = frame.find(p.id);
+        if (!rp) return false;
+        if (std::abs(rp->posX() - p.position.x) > tolerance) return false;
+        if (std::abs(rp->posY() - p.position.y) > tolerance) return false;
+        if (std::abs(rp->velX() - p.velocity.x) > tolerance) return false;
+        if ((rp->alive != 0) != p.alive) return false;
+    }
+    return true;
+}
+}
+
+bool testReplayRoundTripSeek(std::string& errorMsg) {
+    const std::string path = tempReplayPath("sumo_replay_roundtrip.sbr");
+    std::map<std::uint32_t, std::vector<SimSnapshotPlayer>> expected;
+    TEST_ASSERT(recordSampleMatch(path, expected), "Recording should succeed without drops");
+
+    replay::ReplayReader reader;
+    TEST_ASSERT(reader.open(path), "Reader should open the recorded file");
+    TEST_EQUAL(6u, reader.keyframeCount(), "300 ticks at interval 50 should produce 6 keyframes");
+
+    for (std::uint32_t tick : {1u, 49u, 50u, 51u, 137u, 199u, 200u, 201u, 300u}) {
+        replay::ReplayReader::Cursor cursor;
+        TEST_ASSERT(reader.seek(tick, cursor), "Seek should land on a recorded frame");
+        TEST_EQUAL(tick, cursor.frame.tick, "Seek should land exactly on the requested tick");
+        TEST_ASSERT(framesMatch(cursor.frame, expected[tick]), "Decoded frame should match recorded state");
+    }
+    return true;
+}
+
+bool testReplaySequentialEvents(std::string& errorMsg) {
+    const std::string path = tempReplayPath("sumo_replay_events.sbr");
+    std::map<std::uint32_t, std::vector<SimSnapshotPlayer>> expected;
+    TEST_ASSERT(recordSampleMatch(path, expected), "Recording should succeed without drops");
+
+    replay::ReplayReader reader;
+    TEST_ASSERT(reader.open(path), "Reader should open the recorded file");
+
+    replay::ReplayReader::Cursor cursor;
+    TEST_ASSERT(reader.seek(195, cursor), "Seek before the leave event");
+    bool sawLeave = false;
+    while (reader.next(cursor) && cursor.frame.tick <= 200) {
+        for (const auto& e : cursor.events) {
+            if (e.type == replay::EventType::PlayerLeft && e.playerId == 3) sawLeave = true;
+        }
+    }
+    TEST_TRUE(sawLeave);
+    return true;
+}
+
+bool testReplaySeekBeforeStartFails(std::string& errorMsg) {
+    const std::string path = tempReplayPath("sumo_replay_bounds.sbr");
+    std::map<std::uint32_t, std::vector<SimSnapshotPlayer>> expected;
+    TEST_ASSERT(recordSampleMatch(path, expected), "Recording should succeed without drops");
+
+    replay::ReplayReader reader;
+    TEST_ASSERT(reader.open(path), "Reader should open the recorded file");
+    replay::ReplayReader::Cursor cursor;
+    TEST_FALSE(reader.seek(0, cursor));
+    return true;
+}
+
+bool testReplayFileIsLittleEndian(std::string& errorMsg) {
+    const std::string path = tempReplayPath("sumo_replay_bytes.sbr");
+    std::map<std::uint32_t, std::vector<SimSnapshotPlayer>> expected;
+    TEST_ASSERT(recordSampleMatch(path, expected), "Recording should succeed without drops");
+
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    TEST_TRUE(bytes.size() > replay::HEADER_SIZE + replay::TRAILER_SIZE);
+    // "SBRP" then the u16 version, lowest byte first, whatever the host
+    TEST_TRUE(bytes[0] == 'S' && bytes[1] == 'B' && bytes[2] == 'R' && bytes[3] == 'P');
+    TEST_EQUAL(static_cast<unsigned>(replay::FORMAT_VERSION), static_cast<unsigned>(bytes[4]), "Version low byte");
+    TEST_EQUAL(0u, static_cast<unsigned>(bytes[5]), "Version high byte");
+    // The trailer ends with "SBRI"
+    const std::size_t end = bytes.size();
+    TEST_TRUE(bytes[end - 4] == 'S' && bytes[end - 3] == 'B' && bytes[end - 2] == 'R' && bytes[end - 1] == 'I');
+    return true;
+}
+
+bool testReplayRejectsWrappingIndex(std::string& errorMsg) {
+    // 96 bytes whose trailer claims 2^32 - 1 keyframes, with an index offset chosen
+    // so offset + index bytes + trailer wraps around to the file size
+    constexpr std::size_t fileSize = 96;
+    std::vector<std::uint8_t> bytes(fileSize, 0);
+    net::wire::encode(bytes.data(), replay::ReplayHeader{});
+    replay::ReplayTrailer trailer;
+    trailer.keyframeCount = 0xFFFFFFFFu;
+    const std::uint64_t indexBytes = static_cast<std::uint64_t>(trailer.keyframeCount) * replay::INDEX_ENTRY_SIZE;
+    trailer.indexOffset = fileSize - replay::TRAILER_SIZE - indexBytes;  // wraps
+    net::wire::encode(bytes.data() + fileSize - replay::TRAILER_SIZE, trailer);
+
+    const std::string path = tempReplayPath("sumo_replay_wrapping.sbr");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    replay::ReplayReader reader;
+    TEST_FALSE(reader.open(path));
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct ReplayTestsRegistration {
+        ReplayTestsRegistration() {
+            test::TestSuite::instance().registerTest("Replay::RoundTripSeek", testReplayRoundTripSeek);
+            test::TestSuite::instance().registerTest("Replay::SequentialEvents", testReplaySequentialEvents);
+            test::TestSuite::instance().registerTest("Replay::SeekBeforeStartFails", testReplaySeekBeforeStartFails);
+            test::TestSuite::instance().registerTest("Replay::FileIsLittleEndian", testReplayFileIsLittleEndian);
+            test::TestSuite::instance().registerTest("Replay::RejectsWrappingIndex", testReplayRejectsWrappingIndex);
+        }
+    } replayTests;
+}
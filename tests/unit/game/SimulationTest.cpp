@@ -0,0 +1,46 @@
+#include "TestFramework.h"
+#include "game/simulation/Simulation.h"
+
+bool testSimulationSlotsAreStable(std::string& errorMsg) {
+    Simulation sim;
+    std::size_t a = sim.addPlayer(1, {500.f, 450.f});
+    std::size_t b = sim.addPlayer(2, {700.f, 450.f});
+    TEST_ASSERT(a != b, "Players should get distinct slots");
+    TEST_EQUAL(a, sim.slotOf(1), "slotOf should return the slot from addPlayer");
+    TEST_EQUAL(b, sim.slotOf(2), "slotOf should return the slot from addPlayer");
+
+    sim.removePlayer(1);
+    TEST_EQUAL(Simulation::INVALID_SLOT, sim.slotOf(1), "Removed player should have no slot");
+    TEST_TRUE(sim.playerAt(a) == nullptr);
+    TEST_EQUAL(b, sim.slotOf(2), "Removing a player must not move the others");
+
+    std::size_t c = sim.addPlayer(3, {600.f, 300.f});
+    TEST_EQUAL(a, c, "Freed slots should be reused");
+    TEST_EQUAL(2u, sim.playerCount(), "Two players should remain");
+    return true;
+}
+
+bool testSimulationApplyInputAt(std::string& errorMsg) {
+    Simulation sim;
+    std::size_t slot = sim.addPlayer(7, {600.f, 450.f});
+    sim.applyInputAt(slot, {3.f, 0.f});
+    sim.tick(1.f / 60.f);
+
+    const SimPlayer* p = sim.playerAt(slot);
+    TEST_TRUE(p != nullptr);
+    TEST_EQUAL(7u, p->id, "Slot should hold the player it was assigned to");
+    TEST_ASSERT(p->velocity.x > 0.f, "Input applied by slot should accelerate the player");
+
+    sim.applyInputAt(Simulation::INVALID_SLOT, {1.f, 0.f});  // must be a harmless no-op
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct SimulationTestsRegistration {
+        SimulationTestsRegistration() {
+            test::TestSuite::instance().registerTest("Simulation::SlotsAreStable", testSimulationSlotsAreStable);
+            test::TestSuite::instance().registerTest("Simulation::ApplyInputAt", testSimulationApplyInputAt);
+        }
+    } simulationTests;
+}
@@ -0,0 +1,69 @@
+#include "TestFramework.h"
+#include "network/ClockSync.h"
+#include <cmath>
+#include <random>
+
+namespace {
+// Server clock running 200 ppm fast and 90 s ahead of the client
+double serverAt(double localMs) {
+    return 90000.0 + localMs * (1.0 + 200e-6);
+}
+}
+
+bool testClockSyncTracksOffsetAndDrift(std::string& errorMsg) {
+    net::ClockSync clock;
+    TEST_FALSE(clock.serverNow(0).valid);
+
+    // 20 ms each way plus queueing noise that only ever adds delay, unevenly
+    std::mt19937 rng(3);
+    std::exponential_distribution<double> queueing(1.0 / 15.0);
+    int pings = 0;
+    for (std::uint32_t local = 1000; local < 120000; local += 10) {
+        if (!clock.pingDue(local)) continue;
+        ++pings;
+        const double up = 20.0 + queueing(rng);
+        const double down = 20.0 + queueing(rng) * 2.0;
+        const auto serverStamp = static_cast<std::uint32_t>(serverAt(local + up));
+        clock.addSample(local, serverStamp, static_cast<std::uint32_t>(std::lround(local + up + down)));
+    }
+    TEST_ASSERT(pings > 100 && pings < 140, "Fast pings first, then one per second");
+    TEST_TRUE(clock.hasDrift());
+    TEST_ASSERT(std::abs(clock.driftPpm() - 200.0) < 100.0, "Drift should be found from the trusted samples");
+
+    const std::uint32_t now = 121000;
+    const net::ClockEstimate est = clock.serverNow(now);
+    TEST_TRUE(est.valid);
+    const double error = std::abs(est.serverMs - serverAt(now));
+    TEST_ASSERT(error < 5.0, "Minimum-RTT samples should pin the offset within a few ms");
+    TEST_ASSERT(error <= est.errorMs, "The true server time should be inside the bound");
+    TEST_ASSERT(est.errorMs < 40.0, "The bound should be about half the best RTT");
+
+    // The bound widens while no new samples arrive
+    TEST_TRUE(clock.serverNow(now + 600000).errorMs > est.errorMs);
+    return true;
+}
+
+bool testClockSyncIgnoresStalePongs(std::string& errorMsg) {
+    net::ClockSync clock;
+    clock.addSample(1000, 5000, 1040);
+    TEST_EQUAL(1u, clock.samples(), "One sample");
+    TEST_ASSERT(std::abs(clock.offsetMs() - 3980.0) < 1e-9, "Offset is measured at the round trip midpoint");
+    // A pong from before a reconnect (or a wrapped clock) is not a sample
+    clock.addSample(50000, 9000, 10);
+    TEST_EQUAL(1u, clock.samples(), "Stale pong should be ignored");
+    clock.reset();
+    TEST_EQUAL(0u, clock.samples(), "Reset should forget samples");
+    TEST_TRUE(clock.pingDue(0));
+    TEST_FALSE(clock.pingDue(10));
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct ClockSyncTestsRegistration {
+        ClockSyncTestsRegistration() {
+            test::TestSuite::instance().registerTest("ClockSync::TracksOffsetAndDrift", testClockSyncTracksOffsetAndDrift);
+            test::TestSuite::instance().registerTest("ClockSync::IgnoresStalePongs", testClockSyncIgnoresStalePongs);
+        }
+    } clockSyncTests;
+}
@@ -0,0 +1,123 @@
+#include "TestFramework.h"
+#include "network/InputHistory.h"
+#include <vector>
+
+namespace {
+// Server side of the exchange: queue only sequences not seen yet
+struct Receiver {
+    std::uint32_t newest{0};
+    std::vector<net::InputCommand> applied;
+
+    bool receive(const std::vector<std::uint8_t>& packet) {
+        return net::readInputBundle(packet.data(), packet.size(), [&](const net::InputCommand& cmd) {
+            if (cmd.sequence <= newest) return;
+            newest = cmd.sequence;
+            applied.push_back(cmd);
+        });
+    }
+};
+
+std::vector<std::uint8_t> bundle(const net::InputHistory& history) {
+    std::vector<std::uint8_t> out(history.bundleSize());
+    const std::uint8_t* end = history.writeBundle(out.data());
+    return end == out.data() + out.size() ? out : std::vector<std::uint8_t>{};
+}
+}
+
+bool testInputHistoryRecoversLostPackets(std::string& errorMsg) {
+    net::InputHistory history(4);
+    Receiver server;
+    for (int i = 0; i < 20; ++i) {
+        net::InputCommand cmd;
+        cmd.dirX = static_cast<float>(i);
+        cmd.timestampMs = static_cast<std::uint32_t>(i * 16);
+        TEST_EQUAL(static_cast<std::uint32_t>(i + 1), history.record(cmd), "Sequences start at 1");
+        const auto packet = bundle(history);
+        TEST_FALSE(packet.empty());
+        // Lose three packets in a row: still within the redundancy window
+        if (i >= 5 && i <= 7) continue;
+        TEST_TRUE(server.receive(packet));
+    }
+    TEST_EQUAL(20u, server.applied.size(), "Every input should arrive exactly once");
+    for (std::size_t i = 0; i < server.applied.size(); ++i) {
+        TEST_EQUAL(static_cast<std::uint32_t>(i + 1), server.applied[i].sequence, "Inputs apply in order");
+        TEST_TRUE(server.applied[i].dirX == static_cast<float>(i));
+    }
+    TEST_EQUAL(net::inputBundleSize(4), bundle(history).size(), "Bundles carry at most the redundancy window");
+    return true;
+}
+
+bool testInputHistoryDedupesAndRejects(std::string& errorMsg) {
+    net::InputHistory history;
+    TEST_EQUAL(0u, history.bundleSize(), "Nothing to send before the first input");
+    net::InputCommand cmd;
+    cmd.dirY = -1.f;
+    history.record(cmd);
+    history.record(cmd);
+    auto packet = bundle(history);
+
+    Receiver server;
+    TEST_TRUE(server.receive(packet));
+    TEST_TRUE(server.receive(packet));  // duplicated by the network
+    TEST_EQUAL(2u, server.applied.size(), "Repeats must not be applied twice");
+
+    TEST_FALSE(server.receive(std::vector<std::uint8_t>(packet.begin(), packet.end() - 1)));
+    packet[2 + 8] = static_cast<std::uint8_t>(net::MAX_BUNDLED_INPUTS + 1);  // count field
+    TEST_FALSE(server.receive(packet));
+    return true;
+}
+
+bool testInputQueueOnePerTick(std::string& errorMsg) {
+    net::InputQueue queue;
+    net::InputCommand cmd;
+    net::InputCommand out;
+    TEST_FALSE(queue.popForTick(out));
+
+    // A clump of three is applied over three ticks, in order
+    for (std::uint32_t seq = 1; seq <= 3; ++seq) {
+        cmd.sequence = seq;
+        cmd.dirX = static_cast<float>(seq);
+        queue.push(cmd);
+    }
+    for (std::uint32_t seq = 1; seq <= 3; ++seq) {
+        TEST_TRUE(queue.popForTick(out));
+        TEST_EQUAL(seq, out.sequence, "One input per tick, oldest first");
+        TEST_EQUAL(seq, queue.lastApplied(), "Acks follow what was simulated");
+    }
+    TEST_FALSE(queue.popForTick(out));
+    TEST_EQUAL(3u, queue.lastApplied(), "An empty tick keeps the last ack");
+
+    // Stale repeats are discarded without being applied
+    cmd.sequence = 2;
+    queue.push(cmd);
+    TEST_FALSE(queue.popForTick(out));
+
+    // A burst after a stall: only MAX_HELD inputs wait behind the one simulated
+    for (std::uint32_t seq = 4; seq <= 13; ++seq) {
+        cmd.sequence = seq;
+        queue.push(cmd);
+    }
+    TEST_TRUE(queue.popForTick(out));
+    TEST_EQUAL(9u, out.sequence, "The oldest of the burst are skipped");
+    TEST_EQUAL(net::InputQueue::MAX_HELD, queue.size(), "The rest are held for later ticks");
+    TEST_EQUAL(std::uint64_t{5}, queue.dropped(), "Skipped inputs are counted");
+
+    // Unsequenced inputs are applied as they come
+    queue.clear();
+    cmd.sequence = 0;
+    queue.push(cmd);
+    TEST_TRUE(queue.popForTick(out));
+    TEST_EQUAL(9u, queue.lastApplied(), "Unsequenced inputs leave the ack alone");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct InputHistoryTestsRegistration {
+        InputHistoryTestsRegistration() {
+            test::TestSuite::instance().registerTest("InputHistory::RecoversLostPackets", testInputHistoryRecoversLostPackets);
+            test::TestSuite::instance().registerTest("InputHistory::DedupesAndRejects", testInputHistoryDedupesAndRejects);
+            test::TestSuite::instance().registerTest("InputHistory::QueueAppliesOnePerTick", testInputQueueOnePerTick);
+        }
+    } inputHistoryTests;
+}
@@ -1,69 +1,162 @@
-#include "../TestFramework.h"
-#include "../../src/network/NetProtocol.h"
+#include "TestFramework.h"
+#include "network/NetProtocol.h"
+#include <cmath>
+#include <limits>
 
-TEST(NetProtocol, ParseError_Success) {
+bool testParseErrorSuccess(std::string& errorMsg) {
     auto result = net::ParseResult::success("Test");
     TEST_TRUE(result.isSuccess());
     TEST_EQUAL(net::ParseError::Success, result.error, "Success result should have Success error");
     return true;
 }
 
-TEST(NetProtocol, ParseError_Failure) {
+bool testParseErrorFailure(std::string& errorMsg) {
     auto result = net::ParseResult::makeError(
         net::ParseError::PacketTooShort,
         "Expected more bytes"
     );
-    
+
     TEST_FALSE(result.isSuccess());
     TEST_EQUAL(net::ParseError::PacketTooShort, result.error, "Should have correct error type");
     return true;
 }
 
-TEST(NetProtocol, ErrorMessageFormatting) {
+bool testErrorMessageFormatting(std::string& errorMsg) {
     auto result = net::ParseResult::makeError(
         net::ParseError::InvalidFieldValue,
         "Radius out of bounds"
     );
-    
+
     std::string msg = result.getErrorMessage();
     TEST_ASSERT(!msg.empty(), "Error message should not be empty");
     return true;
 }
 
-TEST(NetProtocol, AllErrorTypesHaveMessages) {
+bool testAllErrorTypesHaveMessages(std::string& errorMsg) {
     // Test that all error types can generate messages
     TEST_ASSERT(!net::ParseResult::makeError(net::ParseError::PacketTooShort, "").getErrorMessage().empty(),
                 "PacketTooShort should have message");
-    
+
     TEST_ASSERT(!net::ParseResult::makeError(net::ParseError::InvalidFieldValue, "").getErrorMessage().empty(),
                 "InvalidFieldValue should have message");
-    
+
     TEST_ASSERT(!net::ParseResult::makeError(net::ParseError::InvalidPlayerCount, "").getErrorMessage().empty(),
                 "InvalidPlayerCount should have message");
-    
+
     TEST_ASSERT(!net::ParseResult::makeError(net::ParseError::CorruptedData, "").getErrorMessage().empty(),
                 "CorruptedData should have message");
-    
+
     return true;
 }
 
-TEST(NetProtocol, ParseResultContext) {
+bool testParseResultContext(std::string& errorMsg) {
     auto result = net::ParseResult::makeError(
         net::ParseError::InvalidPlayerCount,
         "Player count mismatch"
     );
-    
+
     // Verify context is preserved
     TEST_EQUAL(net::ParseError::InvalidPlayerCount, result.error, "Error type preserved");
     return true;
 }
 
-TEST(NetProtocol, UnknownMessageType) {
+bool testUnknownMessageType(std::string& errorMsg) {
     auto result = net::ParseResult::makeError(
         net::ParseError::UnknownMessageType,
         "Unknown type 255"
     );
-    
+
     TEST_FALSE(result.isSuccess());
     return true;
 }
+
+bool testDecodeStateIsAView(std::string& errorMsg) {
+    net::StateSnapshot snap;
+    snap.tick = 77;
+    snap.arenaRadius = 500.f;
+    for (std::uint32_t id = 1; id <= 3; ++id) snap.players.push_back({id, 10.f * id, 1.f, 0.f, 0.f, 1});
+    const auto packet = net::serializeState(snap);
+
+    net::DecodedMessage msg;
+    TEST_TRUE(net::decodeMessage(packet.data(), packet.size(), msg).isSuccess());
+    TEST_TRUE(msg.type == net::MessageType::State);
+    TEST_EQUAL(77u, msg.state.tick, "Tick should decode");
+    TEST_EQUAL(3u, msg.state.players.size(), "All players should be visible");
+    TEST_EQUAL(3u, msg.state.players[2].playerId, "Entries decode on access");
+    TEST_TRUE(msg.state.players[2].x == 30.f);
+
+    // A count that disagrees with the bytes is rejected before anything is read
+    auto lying = packet;
+    lying[14] = 200;
+    const net::ParseResult r = net::decodeMessage(lying.data(), lying.size(), msg);
+    TEST_TRUE(r.error == net::ParseError::InvalidPlayerCount);
+    return true;
+}
+
+bool testDecodeRejectsMalformed(std::string& errorMsg) {
+    net::DecodedMessage msg;
+    const auto ping = net::serializePing(net::Ping{5});
+    TEST_TRUE(net::decodeMessage(ping.data(), ping.size(), msg).isSuccess());
+    TEST_EQUAL(5u, msg.ping.timestampMs, "Ping should decode");
+
+    TEST_TRUE(net::decodeMessage(ping.data(), 1, msg).error == net::ParseError::PacketTooShort);
+    TEST_TRUE(net::decodeMessage(ping.data(), ping.size() - 1, msg).error == net::ParseError::PacketTooShort);
+
+    auto longer = ping;
+    longer.push_back(0);
+    const net::ParseResult trailing = net::decodeMessage(longer.data(), longer.size(), msg);
+    TEST_TRUE(trailing.error == net::ParseError::InvalidMessageStructure);
+    TEST_EQUAL(ping.size(), trailing.expectedBytes, "Expected size should be reported");
+
+    auto version = ping;
+    version[0] = net::PROTOCOL_VERSION + 1;
+    TEST_TRUE(net::decodeMessage(version.data(), version.size(), msg).error == net::ParseError::InvalidProtocolVersion);
+
+    auto unknown = ping;
+    unknown[1] = 0xEE;
+    TEST_TRUE(net::decodeMessage(unknown.data(), unknown.size(), msg).error == net::ParseError::UnknownMessageType);
+
+    // Field ranges: input directions must be finite
+    net::InputCommand cmd;
+    cmd.dirX = std::numeric_limits<float>::quiet_NaN();
+    const auto input = net::serializeInput(cmd);
+    const net::ParseResult bad = net::decodeMessage(input.data(), input.size(), msg);
+    TEST_TRUE(bad.error == net::ParseError::InvalidFieldValue);
+    TEST_FALSE(bad.getErrorMessage().empty());
+
+    // ... and so must snapshot positions and velocities
+    net::StateSnapshot snap;
+    snap.players.push_back({1, 0.f, 0.f, 0.f, 0.f, 1});
+    snap.players.push_back({2, 0.f, 0.f, std::numeric_limits<float>::infinity(), 0.f, 1});
+    const auto state = net::serializeState(snap);
+    TEST_TRUE(net::decodeMessage(state.data(), state.size(), msg).error == net::ParseError::InvalidFieldValue);
+    snap.players[1].vx = 0.f;
+    snap.players[1].y = std::numeric_limits<float>::quiet_NaN();
+    const auto nanState = net::serializeState(snap);
+    TEST_TRUE(net::decodeMessage(nanState.data(), nanState.size(), msg).error == net::ParseError::InvalidFieldValue);
+
+    // ... and lockstep inputs, which every peer simulates
+    const net::LockstepInput inputs[2] = {{1, 1.f, 0.f}, {2, 0.f, std::numeric_limits<float>::quiet_NaN()}};
+    std::vector<std::uint8_t> frame(net::lockstepFrameSize(2));
+    net::writeLockstepFrame(frame.data(), net::LockstepFrameHeader{10, 2}, inputs);
+    TEST_TRUE(net::decodeMessage(frame.data(), frame.size(), msg).error == net::ParseError::InvalidFieldValue);
+    net::writeLockstepFrame(frame.data(), net::LockstepFrameHeader{10, 1}, inputs);
+    TEST_TRUE(net::decodeMessage(frame.data(), net::lockstepFrameSize(1), msg).isSuccess());
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct NetProtocolTestsRegistration {
+        NetProtocolTestsRegistration() {
+            test::TestSuite::instance().registerTest("NetProtocol::ParseError_Success", testParseErrorSuccess);
+            test::TestSuite::instance().registerTest("NetProtocol::ParseError_Failure", testParseErrorFailure);
+            test::TestSuite::instance().registerTest("NetProtocol::ErrorMessageFormatting", testErrorMessageFormatting);
+            test::TestSuite::instance().registerTest("NetProtocol::AllErrorTypesHaveMessages", testAllErrorTypesHaveMessages);
+            test::TestSuite::instance().registerTest("NetProtocol::ParseResultContext", testParseResultContext);
+            test::TestSuite::instance().registerTest("NetProtocol::UnknownMessageType", testUnknownMessageType);
+            test::TestSuite::instance().registerTest("NetProtocol::DecodeStateIsAView", testDecodeStateIsAView);
+            test::TestSuite::instance().registerTest("NetProtocol::DecodeRejectsMalformed", testDecodeRejectsMalformed);
+        }
+    } netProtocolTests;
+}
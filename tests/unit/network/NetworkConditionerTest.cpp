@@ -0,0 +1,152 @@
+#include "TestFramework.h"
+#include "network/NetworkConditioner.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+// Datagrams carry their submit index so deliveries can be matched up
+struct Delivery {
+    std::uint32_t index;
+    double atMs;
+};
+
+void submitIndex(net::LinkConditioner& link, double nowMs, std::uint32_t index, std::size_t len = 64) {
+    std::uint8_t payload[net::LinkConditioner::MAX_DATAGRAM] = {};
+    std::memcpy(payload, &index, sizeof(index));
+    link.submit(nowMs, payload, len);
+}
+
+void collect(net::LinkConditioner& link, double nowMs, std::vector<Delivery>& out) {
+    link.release(nowMs, [&](const std::uint8_t* data, std::size_t) {
+        std::uint32_t index;
+        std::memcpy(&index, data, sizeof(index));
+        out.push_back({index, nowMs});
+    });
+}
+}
+
+bool testConditionerShapesDelayAndLoss(std::string& errorMsg) {
+    net::LinkConditions conditions;
+    conditions.latencyMs = 40.f;
+    conditions.jitterMs = 10.f;
+    conditions.lossPercent = 5.f;
+    conditions.lossBurst = 3.f;
+    net::LinkConditioner link(7);
+    link.setConditions(conditions);
+
+    // One datagram every 10 ms for 100 s, drained every millisecond
+    constexpr std::uint32_t count = 10000;
+    std::vector<Delivery> delivered;
+    for (std::uint32_t ms = 0; ms < count * 10 + 1000; ++ms) {
+        if (ms % 10 == 0 && ms / 10 < count) submitIndex(link, ms, ms / 10);
+        collect(link, ms, delivered);
+    }
+    TEST_EQUAL(std::size_t{0}, link.inFlight(), "Everything is released eventually");
+    TEST_EQUAL(link.stats().delivered + link.stats().lost, std::uint64_t{count}, "Every datagram is delivered or lost");
+    const double lossRate = 100.0 * static_cast<double>(link.stats().lost) / count;
+    TEST_TRUE(lossRate > 4.0 && lossRate < 6.0);
+
+    // Losses come in bursts of about lossBurst
+    std::size_t bursts = 0;
+    std::uint32_t expected = 0;
+    double totalDelay = 0.0;
+    for (const Delivery& d : delivered) {
+        TEST_TRUE(d.index >= expected);  // jitter alone never reorders
+        if (d.index > expected) ++bursts;
+        expected = d.index + 1;
+        const double delay = d.atMs - d.index * 10.0;
+        TEST_TRUE(delay >= 40.0);
+        totalDelay += delay;
+    }
+    const double meanBurst = static_cast<double>(link.stats().lost) / static_cast<double>(bursts);
+    TEST_TRUE(meanBurst > 2.4 && meanBurst < 3.6);
+    const double meanDelay = totalDelay / static_cast<double>(delivered.size());
+    TEST_TRUE(meanDelay > 49.0 && meanDelay < 56.0);
+    return true;
+}
+
+bool testConditionerCapsBandwidthAndShuffles(std::string& errorMsg) {
+    // 100 kbit/s: a 100-byte datagram (plus 28 bytes of headers) takes 10.24 ms
+    net::LinkConditions capped;
+    capped.bandwidthKbps = 100.f;
+    capped.queueLimitMs = 100.f;
+    net::LinkConditioner link(3);
+    link.setConditions(capped);
+    for (std::uint32_t i = 0; i < 50; ++i) submitIndex(link, 0.0, i, 100);
+    TEST_EQUAL(std::uint64_t{40}, link.stats().queueDrops, "Only ~100 ms worth of a burst is queued");
+    std::vector<Delivery> delivered;
+    collect(link, 50.0, delivered);
+    TEST_EQUAL(std::size_t{4}, delivered.size(), "The queue drains at the capped rate");
+    collect(link, 1000.0, delivered);
+    TEST_EQUAL(std::size_t{10}, delivered.size(), "Queued datagrams all arrive");
+
+    // Duplicates and held-back datagrams both show up at the receiver
+    net::LinkConditions shuffled;
+    shuffled.latencyMs = 20.f;
+    shuffled.duplicatePercent = 10.f;
+    shuffled.reorderPercent = 10.f;
+    shuffled.reorderDelayMs = 25.f;
+    net::LinkConditioner noisy(11);
+    noisy.setConditions(shuffled);
+    delivered.clear();
+    for (std::uint32_t ms = 0; ms < 10000; ++ms) {
+        if (ms % 5 == 0) submitIndex(noisy, ms, ms / 5);
+        collect(noisy, ms, delivered);
+    }
+    collect(noisy, 20000.0, delivered);
+    TEST_EQUAL(std::uint64_t{2000} + noisy.stats().duplicated, static_cast<std::uint64_t>(delivered.size()),
+               "No loss configured: every datagram and every duplicate arrives");
+    TEST_TRUE(noisy.stats().duplicated > 150 && noisy.stats().duplicated < 250);
+    std::size_t overtaken = 0;
+    for (std::size_t i = 1; i < delivered.size(); ++i) {
+        if (delivered[i].index < delivered[i - 1].index) ++overtaken;
+    }
+    TEST_TRUE(overtaken > 150);
+    return true;
+}
+
+bool testConditionerFollowsProfileScript(std::string& errorMsg) {
+    TEST_TRUE(net::findConditionProfile("no-such-profile") == nullptr);
+    const net::ConditionProfile* mobile = net::findConditionProfile("mobile-4g");
+    TEST_ASSERT(mobile != nullptr, "mobile-4g profile should exist");
+    TEST_TRUE(net::findConditionProfile("congested-wifi") != nullptr);
+
+    net::NetworkConditioner path(*mobile, 1, 1000.0);
+    path.update(1000.0);
+    TEST_TRUE(path.phase().label == "steady");
+    TEST_TRUE(path.upstream().conditions().latencyMs < 50.f);
+    // The handover phase follows the steady one, then the script loops
+    path.update(1000.0 + mobile->phases[0].durationMs + 10.0);
+    TEST_TRUE(path.phase().label == "handover");
+    TEST_TRUE(path.downstream().conditions().latencyMs > 100.f);
+    path.update(1000.0 + mobile->phases[0].durationMs + mobile->phases[1].durationMs + 10.0);
+    TEST_TRUE(path.phase().label == "steady");
+
+    // Same seed, same traffic: same outcome
+    net::NetworkConditioner a(*net::findConditionProfile("lossy"), 42);
+    net::NetworkConditioner b(*net::findConditionProfile("lossy"), 42);
+    std::vector<Delivery> fromA;
+    std::vector<Delivery> fromB;
+    for (std::uint32_t ms = 0; ms < 2000; ++ms) {
+        submitIndex(a.downstream(), ms, ms);
+        submitIndex(b.downstream(), ms, ms);
+        collect(a.downstream(), ms, fromA);
+        collect(b.downstream(), ms, fromB);
+    }
+    TEST_EQUAL(fromA.size(), fromB.size(), "Seeded runs should match");
+    for (std::size_t i = 0; i < fromA.size(); ++i) {
+        TEST_EQUAL(fromA[i].index, fromB[i].index, "Seeded runs should deliver in the same order");
+    }
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct NetworkConditionerTestsRegistration {
+        NetworkConditionerTestsRegistration() {
+            test::TestSuite::instance().registerTest("NetworkConditioner::ShapesDelayAndLoss", testConditionerShapesDelayAndLoss);
+            test::TestSuite::instance().registerTest("NetworkConditioner::CapsBandwidthAndShuffles", testConditionerCapsBandwidthAndShuffles);
+            test::TestSuite::instance().registerTest("NetworkConditioner::FollowsProfileScript", testConditionerFollowsProfileScript);
+        }
+    } networkConditionerTests;
+}
@@ -0,0 +1,165 @@
+#include "TestFramework.h"
+#include "network/Outbox.h"
+#include "network/PacketBudget.h"
+#include <vector>
+
+namespace {
+struct SentPacket {
+    std::vector<std::uint8_t> data;
+    bool reliable;
+};
+
+net::OutboxFlush flushInto(net::Outbox& outbox, std::vector<SentPacket>& sent) {
+    return outbox.flush([&](std::size_t size, bool reliable, auto&& fill) {
+        SentPacket packet{std::vector<std::uint8_t>(size), reliable};
+        fill(packet.data.data());
+        sent.push_back(std::move(packet));
+        return true;
+    });
+}
+
+void queuePong(net::Outbox& outbox, bool reliable, std::uint32_t timestampMs) {
+    outbox.write(reliable, net::messageSize<net::Pong>(), [&](std::uint8_t* out) {
+        net::writeMessage(out, net::MessageType::Pong, net::Pong{timestampMs, 0});
+    });
+}
+
+std::vector<std::uint32_t> pongTimestamps(const SentPacket& packet) {
+    std::vector<std::uint32_t> stamps;
+    net::forEachMessage(packet.data.data(), packet.data.size(), [&](const std::uint8_t* data, std::size_t len) {
+        net::Pong pong{};
+        if (net::readMessage(data, len, pong)) stamps.push_back(pong.timestampMs);
+    });
+    return stamps;
+}
+}
+
+bool testOutboxCoalescesPerChannel(std::string& errorMsg) {
+    net::Outbox outbox;
+    for (std::uint32_t i = 1; i <= 3; ++i) queuePong(outbox, false, i);
+    queuePong(outbox, true, 99);
+    TEST_TRUE(outbox.queued(false));
+    TEST_TRUE(outbox.queued(true));
+
+    std::vector<SentPacket> sent;
+    const net::OutboxFlush result = flushInto(outbox, sent);
+    TEST_EQUAL(2u, result.packets, "One packet per channel");
+    TEST_EQUAL(4u, result.messages, "Every message should be sent");
+    TEST_TRUE(outbox.empty());
+
+    // Several messages travel as a Batch, in queue order
+    TEST_FALSE(sent[0].reliable);
+    TEST_EQUAL(static_cast<std::uint8_t>(net::MessageType::Batch), sent[0].data[1], "Unreliable packet should be a batch");
+    const std::vector<std::uint32_t> stamps = pongTimestamps(sent[0]);
+    TEST_EQUAL(3u, stamps.size(), "Batch should hold three pongs");
+    TEST_EQUAL(1u, stamps[0], "Order should be kept");
+    TEST_EQUAL(3u, stamps[2], "Order should be kept");
+
+    // A lone message pays no framing
+    TEST_TRUE(sent[1].reliable);
+    TEST_EQUAL(net::messageSize<net::Pong>(), sent[1].data.size(), "Lone message should be sent raw");
+    TEST_EQUAL(static_cast<std::uint8_t>(net::MessageType::Pong), sent[1].data[1], "Lone message keeps its type");
+    return true;
+}
+
+bool testOutboxSplitsAtPacketSize(std::string& errorMsg) {
+    constexpr std::size_t frame = net::FRAME_PREFIX_SIZE + net::messageSize<net::Pong>();
+    net::Outbox outbox(2 + frame * 4);
+    for (std::uint32_t i = 0; i < 10; ++i) queuePong(outbox, false, i);
+
+    std::vector<SentPacket> sent;
+    const net::OutboxFlush result = flushInto(outbox, sent);
+    TEST_EQUAL(3u, result.packets, "4 + 4 + 2 messages");
+    TEST_EQUAL(10u, result.messages, "Every message should be sent");
+    std::uint32_t next = 0;
+    for (const SentPacket& packet : sent) {
+        TEST_TRUE(packet.data.size() <= 2 + frame * 4);
+        for (std::uint32_t stamp : pongTimestamps(packet)) TEST_EQUAL(next++, stamp, "Order should be kept across packets");
+    }
+    TEST_EQUAL(10u, next, "Every message should decode");
+
+    // Buffers are reused after a flush
+    queuePong(outbox, false, 7);
+    sent.clear();
+    TEST_EQUAL(1u, flushInto(outbox, sent).packets, "Outbox should be reusable");
+    return true;
+}
+
+bool testForEachMessageRejectsBadFraming(std::string& errorMsg) {
+    std::uint8_t pong[net::messageSize<net::Pong>()];
+    net::writeMessage(pong, net::MessageType::Pong, net::Pong{5, 0});
+    auto batchOf = [&](std::uint16_t declared, std::uint8_t innerType) {
+        std::vector<std::uint8_t> packet(2 + net::FRAME_PREFIX_SIZE + sizeof(pong));
+        net::writeMessageHeader(packet.data(), net::MessageType::Batch);
+        net::wire::store(packet.data() + 2, declared);
+        std::memcpy(packet.data() + 4, pong, sizeof(pong));
+        packet[5] = innerType;
+        return packet;
+    };
+    std::size_t delivered = 0;
+    auto count = [&](const std::uint8_t*, std::size_t) { ++delivered; };
+
+    const auto good = batchOf(sizeof(pong), static_cast<std::uint8_t>(net::MessageType::Pong));
+    TEST_TRUE(net::forEachMessage(good.data(), good.size(), count));
+    TEST_EQUAL(1u, delivered, "Valid batch should deliver its message");
+
+    delivered = 0;
+    const auto truncated = batchOf(sizeof(pong) + 1, static_cast<std::uint8_t>(net::MessageType::Pong));
+    TEST_FALSE(net::forEachMessage(truncated.data(), truncated.size(), count));
+    const auto nested = batchOf(sizeof(pong), static_cast<std::uint8_t>(net::MessageType::Batch));
+    TEST_FALSE(net::forEachMessage(nested.data(), nested.size(), count));
+    const auto empty = batchOf(sizeof(pong), 0);
+    TEST_FALSE(net::forEachMessage(empty.data(), 2, count));
+    TEST_EQUAL(0u, delivered, "A malformed batch delivers nothing");
+
+    // Budgets only check a batch as a frame; its messages are admitted one by one
+    net::PacketBudget budget;
+    TEST_TRUE(budget.admit(good.data(), good.size(), 0.0) == net::DropReason::None);
+    TEST_EQUAL(0u, budget.drops().total(), "Valid batch should not be dropped");
+    return true;
+}
+
+bool testOutboxBatchesStateWithAck(std::string& errorMsg) {
+    net::StateSnapshot snap;
+    snap.tick = 42;
+    snap.players.push_back({7, 1.f, 2.f, 0.f, 0.f, 1});
+
+    // How the server queues a prioritized snapshot and the ack behind it
+    net::Outbox outbox;
+    outbox.write(false, net::stateMessageSize(snap.players.size()),
+                 [&](std::uint8_t* out) { net::writeState(out, snap); });
+    outbox.write(false, net::messageSize<net::InputAck>(), [&](std::uint8_t* out) {
+        net::writeMessage(out, net::MessageType::InputAck, net::InputAck{42, 9});
+    });
+    std::vector<SentPacket> sent;
+    TEST_EQUAL(1u, flushInto(outbox, sent).packets, "State and ack should share a packet");
+    TEST_EQUAL(net::stateWithAckSize(net::stateMessageSize(1)), sent[0].data.size(),
+               "Snapshot budgets count the ack's framing");
+
+    std::vector<net::MessageType> types;
+    net::InputAck ack;
+    net::DecodedMessage msg;
+    TEST_TRUE(net::forEachMessage(sent[0].data.data(), sent[0].data.size(), [&](const std::uint8_t* data, std::size_t len) {
+        if (!net::decodeMessage(data, len, msg).isSuccess()) return;
+        types.push_back(msg.type);
+        if (msg.type == net::MessageType::InputAck) ack = msg.inputAck;
+    }));
+    TEST_EQUAL(2u, types.size(), "Both messages should decode");
+    TEST_TRUE(types[0] == net::MessageType::State);
+    TEST_TRUE(types[1] == net::MessageType::InputAck);
+    TEST_EQUAL(42u, ack.tick, "Ack should name the snapshot's tick");
+    TEST_EQUAL(9u, ack.sequence, "Ack sequence should decode");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct OutboxTestsRegistration {
+        OutboxTestsRegistration() {
+            test::TestSuite::instance().registerTest("Outbox::CoalescesPerChannel", testOutboxCoalescesPerChannel);
+            test::TestSuite::instance().registerTest("Outbox::SplitsAtPacketSize", testOutboxSplitsAtPacketSize);
+            test::TestSuite::instance().registerTest("Outbox::ForEachMessageRejectsBadFraming", testForEachMessageRejectsBadFraming);
+            test::TestSuite::instance().registerTest("Outbox::BatchesStateWithAck", testOutboxBatchesStateWithAck);
+        }
+    } outboxTests;
+}
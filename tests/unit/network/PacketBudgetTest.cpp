@@ -0,0 +1,66 @@
+#include "TestFramework.h"
+#include "network/PacketBudget.h"
+#include "network/NetProtocol.h"
+
+namespace {
+std::array<std::uint8_t, 16> header(net::MessageType type) {
+    std::array<std::uint8_t, 16> packet{};
+    packet[0] = net::PROTOCOL_VERSION;
+    packet[1] = static_cast<std::uint8_t>(type);
+    return packet;
+}
+}
+
+bool testPacketBudgetRejectsMalformed(std::string& errorMsg) {
+    net::PacketBudget budget;
+    auto packet = header(net::MessageType::Input);
+    TEST_TRUE(budget.admit(packet.data(), 1, 0.0) == net::DropReason::Malformed);
+    packet[0] = net::PROTOCOL_VERSION + 1;
+    TEST_TRUE(budget.admit(packet.data(), packet.size(), 0.0) == net::DropReason::Malformed);
+    TEST_EQUAL(2u, budget.drops().count(net::DropReason::Malformed), "Both packets should be counted");
+    return true;
+}
+
+bool testPacketBudgetLimitsPerType(std::string& errorMsg) {
+    net::PacketBudgetConfig config;
+    config.pingRate = 1.f;
+    config.pingBurst = 2.f;
+    net::PacketBudget budget(config);
+    const auto ping = header(net::MessageType::Ping);
+    const auto input = header(net::MessageType::Input);
+
+    TEST_TRUE(budget.admit(ping.data(), ping.size(), 0.0) == net::DropReason::None);
+    TEST_TRUE(budget.admit(ping.data(), ping.size(), 0.0) == net::DropReason::None);
+    TEST_TRUE(budget.admit(ping.data(), ping.size(), 0.0) == net::DropReason::TypeBudget);
+    // A ping flood must not starve inputs
+    TEST_TRUE(budget.admit(input.data(), input.size(), 0.0) == net::DropReason::None);
+    // Tokens come back with time
+    TEST_TRUE(budget.admit(ping.data(), ping.size(), 1.0) == net::DropReason::None);
+    return true;
+}
+
+bool testPacketBudgetFlagsAbuse(std::string& errorMsg) {
+    net::PacketBudgetConfig config;
+    config.inputBurst = 1.f;
+    config.strikeBurst = 10.f;
+    net::PacketBudget budget(config);
+    const auto input = header(net::MessageType::Input);
+
+    for (int i = 0; i < 11; ++i) budget.admit(input.data(), input.size(), 0.0);
+    TEST_FALSE(budget.isAbusive());
+    budget.admit(input.data(), input.size(), 0.0);
+    TEST_TRUE(budget.isAbusive());
+    TEST_EQUAL(11u, budget.drops().total(), "Every rejected packet should be counted");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct PacketBudgetTestsRegistration {
+        PacketBudgetTestsRegistration() {
+            test::TestSuite::instance().registerTest("PacketBudget::RejectsMalformed", testPacketBudgetRejectsMalformed);
+            test::TestSuite::instance().registerTest("PacketBudget::LimitsPerType", testPacketBudgetLimitsPerType);
+            test::TestSuite::instance().registerTest("PacketBudget::FlagsAbuse", testPacketBudgetFlagsAbuse);
+        }
+    } packetBudgetTests;
+}
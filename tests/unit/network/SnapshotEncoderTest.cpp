@@ -0,0 +1,56 @@
+#include "TestFramework.h"
+#include "network/SnapshotEncoder.h"
+#include "game/simulation/Simulation.h"
+
+bool testSnapshotEncoderRoundTrips(std::string& errorMsg) {
+    Simulation sim(400.f);
+    for (std::uint32_t id = 1; id <= 5; ++id) {
+        sim.addPlayer(id, {500.f + static_cast<float>(id) * 40.f, 450.f});
+        sim.applyInput(id, {1.f, 0.5f});
+    }
+    sim.removePlayer(3);  // leaves a free slot the encoder must skip
+    for (int i = 0; i < 10; ++i) sim.tick(1.f / 60.f);
+
+    // Exact size: the buffer is filled to the last byte and not past it
+    const std::size_t size = net::snapshotSize(sim);
+    TEST_EQUAL(net::stateMessageSize(4), size, "Size should cover the four live players");
+    std::vector<std::uint8_t> direct(size + 1, 0xEE);
+    const std::uint8_t* end = net::encodeSnapshot(direct.data(), sim, 77, 1234);
+    TEST_TRUE(end == direct.data() + size);
+    TEST_EQUAL(0xEE, static_cast<int>(direct[size]), "Encoder must not write past the exact size");
+
+    // Decodes to the same snapshot the StateSnapshot path produced
+    std::vector<net::PlayerState> expected;
+    sim.forEachPlayer([&](const SimPlayer& p) {
+        net::PlayerState ps{};
+        ps.playerId = p.id;
+        ps.x = p.position.x;
+        ps.y = p.position.y;
+        ps.vx = p.velocity.x;
+        ps.vy = p.velocity.y;
+        ps.alive = p.alive ? 1 : 0;
+        expected.push_back(ps);
+    });
+    net::StateSnapshot decoded;
+    TEST_TRUE(net::deserializeState(direct.data(), size, decoded));
+    TEST_EQUAL(77u, decoded.tick, "Tick should round-trip");
+    TEST_EQUAL(1234u, decoded.serverTimeMs, "Server time should round-trip");
+    TEST_TRUE(decoded.arenaRadius == sim.getArenaRadius());
+    TEST_EQUAL(expected.size(), decoded.players.size(), "Removed player should not be encoded");
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        const net::PlayerState& a = expected[i];
+        const net::PlayerState& b = decoded.players[i];
+        TEST_EQUAL(a.playerId, b.playerId, "Players should keep slot order");
+        TEST_TRUE(a.x == b.x && a.y == b.y && a.vx == b.vx && a.vy == b.vy && a.alive == b.alive);
+    }
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct SnapshotEncoderTestsRegistration {
+        SnapshotEncoderTestsRegistration() {
+            test::TestSuite::instance().registerTest("SnapshotEncoder::RoundTrips", testSnapshotEncoderRoundTrips);
+        }
+    } snapshotEncoderTests;
+}
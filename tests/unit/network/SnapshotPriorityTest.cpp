@@ -0,0 +1,104 @@
+#include "TestFramework.h"
+#include "network/SnapshotPriority.h"
+
+namespace {
+// A row of idle players 100px apart; player 1 is the viewer at the origin
+void makeLobby(std::size_t count, std::vector<net::PlayerState>& players,
+               std::vector<net::PriorityCandidate>& candidates) {
+    players.clear();
+    candidates.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        net::PlayerState p{};
+        p.playerId = static_cast<std::uint32_t>(i + 1);
+        p.x = static_cast<float>(i) * 100.f;
+        players.push_back(p);
+        candidates.push_back({i, 0});
+    }
+}
+
+bool contains(const std::vector<net::PlayerState>& sent, std::uint32_t id) {
+    for (const auto& p : sent) {
+        if (p.playerId == id) return true;
+    }
+    return false;
+}
+}
+
+bool testSnapshotPriorityRespectsBudget(std::string& errorMsg) {
+    std::vector<net::PlayerState> players;
+    std::vector<net::PriorityCandidate> candidates;
+    makeLobby(100, players, candidates);
+
+    net::SnapshotPrioritizer prioritizer;
+    std::vector<net::PlayerState> sent;
+    const std::size_t maxPlayers = net::statePlayersForBudget(600);
+    for (int frame = 0; frame < 30; ++frame) {
+        prioritizer.select(players, candidates, 1, frame / 30.0, maxPlayers, sent);
+        TEST_EQUAL(maxPlayers, sent.size(), "Packet should be filled up to the budget");
+        TEST_TRUE(contains(sent, 1));
+        TEST_ASSERT(net::stateMessageSize(sent.size()) <= 600, "Packet must not exceed the byte budget");
+    }
+    return true;
+}
+
+bool testSnapshotPriorityRefreshesEveryone(std::string& errorMsg) {
+    std::vector<net::PlayerState> players;
+    std::vector<net::PriorityCandidate> candidates;
+    makeLobby(60, players, candidates);
+
+    net::SnapshotPriorityConfig config;
+    config.maxStaleSec = 0.5f;
+    net::SnapshotPrioritizer prioritizer(config);
+    std::vector<net::PlayerState> sent;
+    std::vector<double> lastSent(61, 0.0);
+    int nearSends = 0;
+    int farSends = 0;
+
+    // 30 Hz, 10 players per packet: the lobby fits within 0.5 s of snapshots
+    for (int frame = 0; frame < 300; ++frame) {
+        const double now = frame / 30.0;
+        prioritizer.select(players, candidates, 1, now, 10, sent);
+        for (const auto& p : sent) {
+            lastSent[p.playerId] = now;
+            if (p.playerId == 2) ++nearSends;
+            if (p.playerId == 60) ++farSends;
+        }
+        for (std::uint32_t id = 1; id <= 60; ++id) {
+            TEST_ASSERT(now - lastSent[id] <= config.maxStaleSec + 1.0 / 30.0 + 1e-6,
+                        "Every player should be refreshed within maxStaleSec");
+        }
+    }
+    TEST_ASSERT(nearSends > farSends, "Nearby players should be refreshed more often than distant ones");
+    return true;
+}
+
+bool testSnapshotPriorityBoostsCollisions(std::string& errorMsg) {
+    std::vector<net::PlayerState> players;
+    std::vector<net::PriorityCandidate> candidates;
+    makeLobby(40, players, candidates);
+
+    net::SnapshotPrioritizer prioritizer;
+    std::vector<net::PlayerState> sent;
+    // Let the initial burst of new entities drain
+    for (int frame = 0; frame < 60; ++frame) prioritizer.select(players, candidates, 1, frame / 30.0, 5, sent);
+
+    candidates[39].collisions = 1;  // the farthest player gets hit
+    bool sentSoon = false;
+    for (int frame = 60; frame < 64 && !sentSoon; ++frame) {
+        prioritizer.select(players, candidates, 1, frame / 30.0, 5, sent);
+        sentSoon = contains(sent, 40);
+    }
+    TEST_ASSERT(sentSoon, "A collision should bring a distant player forward");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct SnapshotPriorityTestsRegistration {
+        SnapshotPriorityTestsRegistration() {
+            test::TestSuite::instance().registerTest("SnapshotPriority::RespectsBudget", testSnapshotPriorityRespectsBudget);
+            test::TestSuite::instance().registerTest("SnapshotPriority::RefreshesEveryone", testSnapshotPriorityRefreshesEveryone);
+            test::TestSuite::instance().registerTest("SnapshotPriority::BoostsCollisions", testSnapshotPriorityBoostsCollisions);
+        }
+    } snapshotPriorityTests;
+}
@@ -0,0 +1,88 @@
+#include "TestFramework.h"
+#include "network/SnapshotRate.h"
+
+namespace {
+net::LinkStats cleanLink() {
+    net::LinkStats s;
+    s.rttMs = 40.f;
+    s.packetLoss = 0.f;
+    s.throttle = 1.f;
+    return s;
+}
+}
+
+bool testSnapshotRateStartsAtInitial(std::string& errorMsg) {
+    net::SnapshotRateController rate;
+    TEST_EQUAL(33.f, rate.rateHz(), "Rate should start at the configured initial rate");
+    TEST_FALSE(rate.isCongested());
+    return true;
+}
+
+bool testSnapshotRateClimbsToCeiling(std::string& errorMsg) {
+    net::SnapshotRateController rate;
+    for (int i = 0; i < 600; ++i) {
+        rate.updateLink(cleanLink(), 0.1f);
+    }
+    TEST_EQUAL(60.f, rate.rateHz(), "Clean link should reach the ceiling rate");
+    return true;
+}
+
+bool testSnapshotRateBacksOffOnLoss(std::string& errorMsg) {
+    net::SnapshotRateController rate;
+    net::LinkStats lossy = cleanLink();
+    lossy.packetLoss = 0.1f;
+
+    rate.updateLink(lossy, 0.3f);
+    TEST_TRUE(rate.isCongested());
+    TEST_ASSERT(rate.rateHz() < 20.f, "First congestion sample should halve the rate");
+
+    for (int i = 0; i < 50; ++i) {
+        rate.updateLink(lossy, 0.3f);
+    }
+    TEST_EQUAL(10.f, rate.rateHz(), "Sustained loss should pin the rate at the floor");
+    return true;
+}
+
+bool testSnapshotRateBacksOffOnQueueing(std::string& errorMsg) {
+    net::SnapshotRateController rate;
+    rate.updateLink(cleanLink(), 0.1f);
+
+    net::LinkStats bloated = cleanLink();
+    bloated.rttMs = 200.f;
+    rate.updateLink(bloated, 0.3f);
+    TEST_TRUE(rate.isCongested());
+    TEST_ASSERT(rate.rateHz() < 33.f, "RTT inflation over baseline should reduce the rate");
+    return true;
+}
+
+bool testSnapshotRateAdvanceCadence(std::string& errorMsg) {
+    net::SnapshotRateConfig cfg;
+    cfg.initialRateHz = 30.f;
+    net::SnapshotRateController rate(cfg);
+
+    int sent = 0;
+    for (int i = 0; i < 60; ++i) {
+        if (rate.advance(1.f / 60.f)) ++sent;
+    }
+    TEST_ASSERT(sent >= 29 && sent <= 31, "30 Hz over one second of ticks should send ~30 snapshots");
+
+    // A long stall sends one snapshot, not a burst of catch-up ones
+    TEST_TRUE(rate.advance(1.f));
+    TEST_FALSE(rate.advance(0.f));
+    TEST_FALSE(rate.advance(1.f / 60.f));
+    TEST_TRUE(rate.advance(1.f / 60.f));
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct SnapshotRateTestsRegistration {
+        SnapshotRateTestsRegistration() {
+            test::TestSuite::instance().registerTest("SnapshotRate::StartsAtInitial", testSnapshotRateStartsAtInitial);
+            test::TestSuite::instance().registerTest("SnapshotRate::ClimbsToCeiling", testSnapshotRateClimbsToCeiling);
+            test::TestSuite::instance().registerTest("SnapshotRate::BacksOffOnLoss", testSnapshotRateBacksOffOnLoss);
+            test::TestSuite::instance().registerTest("SnapshotRate::BacksOffOnQueueing", testSnapshotRateBacksOffOnQueueing);
+            test::TestSuite::instance().registerTest("SnapshotRate::AdvanceCadence", testSnapshotRateAdvanceCadence);
+        }
+    } snapshotRateTests;
+}
@@ -0,0 +1,267 @@
+#include "TestFramework.h"
+#include "network/UdpBatchTransport.h"
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// Datagram kinds from UdpBatchTransport.cpp, for steering the relay's losses
+constexpr std::uint8_t KIND_RELIABLE = 4;
+constexpr std::uint8_t KIND_ACK = 5;
+constexpr std::uint8_t KIND_DISCONNECT = 6;
+constexpr std::uint8_t KIND_FRAGMENT = 10;
+constexpr std::uint8_t KIND_RELIABLE_PART = 11;
+
+// One side of a loopback connection and everything it saw
+struct Endpoint {
+    net::UdpBatchTransport transport;
+    ENetPeer* peer{nullptr};
+    bool connected{false};
+    bool disconnected{false};
+    std::uint32_t connectData{0};
+    std::uint32_t disconnectData{0};
+    std::vector<std::uint32_t> reliableIds;
+    std::vector<std::vector<std::uint8_t>> reliableLarge;    // messages over MAX_PAYLOAD
+    std::vector<std::vector<std::uint8_t>> unreliableLarge;
+
+    void service() {
+        transport.service(0,
+            [&](ENetPeer* p) { peer = p; connected = true; connectData = p->eventData; },
+            [&](ENetPeer* p) { disconnected = true; disconnectData = p->eventData; },
+            [&](ENetPeer*, const ENetPacket* packet) {
+                if (packet->dataLength > net::UdpBatchTransport::MAX_PAYLOAD) {
+                    auto& into = (packet->flags & ENET_PACKET_FLAG_RELIABLE) ? reliableLarge : unreliableLarge;
+                    into.emplace_back(packet->data, packet->data + packet->dataLength);
+                    return;
+                }
+                std::uint32_t id = 0;
+                if ((packet->flags & ENET_PACKET_FLAG_RELIABLE) && packet->dataLength == sizeof(id)) {
+                    std::memcpy(&id, packet->data, sizeof(id));
+                    reliableIds.push_back(id);
+                }
+            });
+    }
+};
+
+// UDP relay between a client and the server on 127.0.0.1 that loses whatever
+// drop() picks; toClient tells the direction
+struct LossyRelay {
+    int fd{-1};
+    sockaddr_in server{};
+    sockaddr_in client{};
+    bool haveClient{false};
+    std::function<bool(const std::uint8_t* data, std::size_t len, bool toClient)> drop;
+
+    LossyRelay(std::uint16_t serverPort) {
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        sockaddr_in bindAddr{};
+        bindAddr.sin_family = AF_INET;
+        bindAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr));
+        server = bindAddr;
+        server.sin_port = htons(serverPort);
+    }
+    ~LossyRelay() { ::close(fd); }
+
+    std::uint16_t port() const {
+        sockaddr_in bound{};
+        socklen_t length = sizeof(bound);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &length);
+        return ntohs(bound.sin_port);
+    }
+
+    void relay() {
+        std::uint8_t buffer[2048];
+        while (true) {
+            sockaddr_in from{};
+            socklen_t length = sizeof(from);
+            const ssize_t n = ::recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &length);
+            if (n <= 0) return;
+            const bool toClient = from.sin_port == server.sin_port;
+            if (!toClient) {
+                client = from;
+                haveClient = true;
+            }
+            if (toClient && !haveClient) continue;
+            if (drop && drop(buffer, static_cast<std::size_t>(n), toClient)) continue;
+            const sockaddr_in& to = toClient ? client : server;
+            ::sendto(fd, buffer, static_cast<std::size_t>(n), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+        }
+    }
+};
+
+// Service everything until done() or timeoutMs passes; returns done()
+bool pumpUntil(Endpoint& server, LossyRelay& relay, Endpoint& client, int timeoutMs,
+               const std::function<bool()>& done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        server.service();
+        relay.relay();
+        client.service();
+        relay.relay();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+bool connectThroughRelay(Endpoint& server, LossyRelay& relay, Endpoint& client) {
+    client.transport.connect("127.0.0.1", relay.port(), 42);
+    return pumpUntil(server, relay, client, 2000, [&] { return server.connected && client.connected; });
+}
+}
+
+bool testUdpBatchConnectsAndDisconnects(std::string& errorMsg) {
+    Endpoint server;
+    Endpoint client;
+    TEST_TRUE(server.transport.listen(0, 4));
+    LossyRelay relay(server.transport.localPort());
+
+    TEST_ASSERT(connectThroughRelay(server, relay, client), "Handshake should complete");
+    TEST_EQUAL(42u, server.connectData, "Connect data should reach the server");
+
+    // Oversize sends are refused and counted, not truncated
+    const std::vector<std::uint8_t> oversize(net::UdpBatchTransport::MAX_MESSAGE + 1);
+    TEST_FALSE(server.transport.send(server.peer, oversize.data(), oversize.size(), false));
+    TEST_FALSE(server.transport.send(server.peer, oversize.data(), oversize.size(), true));
+    TEST_EQUAL(2u, server.transport.stats().oversizeDropped, "Both oversize sends should be counted");
+
+    server.transport.disconnect(server.peer, 7);
+    TEST_ASSERT(pumpUntil(server, relay, client, 2000, [&] { return server.disconnected && client.disconnected; }),
+                "Both sides should report the disconnect");
+    TEST_EQUAL(7u, client.disconnectData, "Disconnect data should reach the client");
+    return true;
+}
+
+bool testUdpBatchReliableInOrderUnderLoss(std::string& errorMsg) {
+    constexpr std::uint32_t COUNT = 50;
+    Endpoint server;
+    Endpoint client;
+    TEST_TRUE(server.transport.listen(0, 4));
+    LossyRelay relay(server.transport.localPort());
+    TEST_ASSERT(connectThroughRelay(server, relay, client), "Handshake should complete");
+
+    // First round: lose message 3 and every ack, so the resend carries messages
+    // the client already delivered as well as the ones it had to discard
+    std::size_t reliableSeen = 0;
+    relay.drop = [&](const std::uint8_t* data, std::size_t, bool toClient) {
+        if (toClient && data[0] == KIND_RELIABLE) return ++reliableSeen == 4;
+        return !toClient && data[0] == KIND_ACK && reliableSeen <= COUNT;
+    };
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        TEST_TRUE(server.transport.send(server.peer, reinterpret_cast<const std::uint8_t*>(&id), sizeof(id), true));
+    }
+    TEST_ASSERT(pumpUntil(server, relay, client, 5000, [&] { return client.reliableIds.size() >= COUNT; }),
+                "Every reliable message should arrive");
+
+    TEST_EQUAL(COUNT, client.reliableIds.size(), "Duplicates should not be delivered");
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        TEST_EQUAL(id, client.reliableIds[id], "Reliable messages should arrive in order");
+    }
+    TEST_TRUE(server.transport.stats().retransmits >= COUNT);
+    TEST_FALSE(client.disconnected);
+    return true;
+}
+
+bool testUdpBatchFragmentsLargeMessages(std::string& errorMsg) {
+    Endpoint server;
+    Endpoint client;
+    TEST_TRUE(server.transport.listen(0, 4));
+    LossyRelay relay(server.transport.localPort());
+    TEST_ASSERT(connectThroughRelay(server, relay, client), "Handshake should complete");
+
+    std::vector<std::uint8_t> large(3 * net::UdpBatchTransport::MAX_PAYLOAD + 17);
+    for (std::size_t i = 0; i < large.size(); ++i) large[i] = static_cast<std::uint8_t>(i * 7);
+
+    // Losing one piece of an unreliable message drops the whole message
+    std::size_t fragmentsSeen = 0;
+    relay.drop = [&](const std::uint8_t* data, std::size_t, bool toClient) {
+        return toClient && data[0] == KIND_FRAGMENT && ++fragmentsSeen == 2;
+    };
+    TEST_TRUE(server.transport.send(server.peer, large.data(), large.size(), false));
+    TEST_TRUE(server.transport.send(server.peer, large.data(), large.size(), false));
+    TEST_ASSERT(pumpUntil(server, relay, client, 2000, [&] { return !client.unreliableLarge.empty(); }),
+                "The intact unreliable message should arrive");
+    TEST_EQUAL(1u, client.unreliableLarge.size(), "The message that lost a piece should be dropped");
+    TEST_TRUE(client.unreliableLarge[0] == large);
+
+    // A lost reliable piece is resent and the message arrives whole and in order
+    std::size_t reliableSeen = 0;
+    relay.drop = [&](const std::uint8_t* data, std::size_t, bool toClient) {
+        return toClient && (data[0] == KIND_RELIABLE || data[0] == KIND_RELIABLE_PART) && ++reliableSeen == 3;
+    };
+    const std::uint32_t before = 1;
+    const std::uint32_t after = 2;
+    TEST_TRUE(server.transport.send(server.peer, reinterpret_cast<const std::uint8_t*>(&before), sizeof(before), true));
+    TEST_TRUE(server.transport.send(server.peer, large.data(), large.size(), true));
+    TEST_TRUE(server.transport.send(server.peer, reinterpret_cast<const std::uint8_t*>(&after), sizeof(after), true));
+    TEST_ASSERT(pumpUntil(server, relay, client, 5000, [&] { return client.reliableIds.size() >= 2; }),
+                "Every reliable message should arrive");
+    TEST_EQUAL(1u, client.reliableLarge.size(), "The large reliable message should arrive once");
+    TEST_TRUE(client.reliableLarge[0] == large);
+    TEST_EQUAL(1u, client.reliableIds[0], "Messages around the large one keep their order");
+    TEST_EQUAL(2u, client.reliableIds[1], "Messages around the large one keep their order");
+    TEST_EQUAL(3u, server.transport.stats().fragmentedMessages, "Each large send should be counted");
+    return true;
+}
+
+bool testUdpBatchResendsLostDisconnect(std::string& errorMsg) {
+    Endpoint server;
+    Endpoint client;
+    TEST_TRUE(server.transport.listen(0, 4));
+    LossyRelay relay(server.transport.localPort());
+    TEST_ASSERT(connectThroughRelay(server, relay, client), "Handshake should complete");
+
+    std::size_t disconnectsSeen = 0;
+    relay.drop = [&](const std::uint8_t* data, std::size_t, bool toClient) {
+        return toClient && data[0] == KIND_DISCONNECT && ++disconnectsSeen == 1;
+    };
+    server.transport.disconnect(server.peer, 7);
+    TEST_ASSERT(pumpUntil(server, relay, client, 2000, [&] { return server.disconnected && client.disconnected; }),
+                "Both sides should report the disconnect");
+    TEST_TRUE(disconnectsSeen >= 2);
+    TEST_EQUAL(7u, client.disconnectData, "The resent disconnect should carry its data");
+    return true;
+}
+
+bool testUdpBatchTimesOutSilentPeer(std::string& errorMsg) {
+    Endpoint server;
+    Endpoint client;
+    TEST_TRUE(server.transport.listen(0, 4));
+    server.transport.setTimeout(300);
+    client.transport.setTimeout(300);
+    LossyRelay relay(server.transport.localPort());
+    TEST_ASSERT(connectThroughRelay(server, relay, client), "Handshake should complete");
+
+    relay.drop = [](const std::uint8_t*, std::size_t, bool) { return true; };
+    TEST_ASSERT(pumpUntil(server, relay, client, 3000, [&] { return server.disconnected && client.disconnected; }),
+                "Both sides should time out");
+    TEST_EQUAL(0u, server.disconnectData, "A timeout carries no disconnect data");
+    TEST_EQUAL(0u, client.disconnectData, "A timeout carries no disconnect data");
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct UdpBatchTransportTestsRegistration {
+        UdpBatchTransportTestsRegistration() {
+            test::TestSuite::instance().registerTest("UdpBatchTransport::ConnectsAndDisconnects", testUdpBatchConnectsAndDisconnects);
+            test::TestSuite::instance().registerTest("UdpBatchTransport::ReliableInOrderUnderLoss", testUdpBatchReliableInOrderUnderLoss);
+            test::TestSuite::instance().registerTest("UdpBatchTransport::FragmentsLargeMessages", testUdpBatchFragmentsLargeMessages);
+            test::TestSuite::instance().registerTest("UdpBatchTransport::ResendsLostDisconnect", testUdpBatchResendsLostDisconnect);
+            test::TestSuite::instance().registerTest("UdpBatchTransport::TimesOutSilentPeer", testUdpBatchTimesOutSilentPeer);
+        }
+    } udpBatchTransportTests;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include "TestFramework.h"
+#include "network/NetProtocol.h"
+#include <algorithm>
+
+bool testWireFormatPlayerStateBytes(std::string& errorMsg) {
+    net::PlayerState ps{};
+    ps.playerId = 0x04030201;
+    ps.x = 1.5f;
+    ps.vy = -2.f;
+    ps.alive = 1;
+
+    std::uint8_t bytes[net::wire::size<net::PlayerState> + 1] = {};
+    bytes[net::wire::size<net::PlayerState>] = 0xEE;
+    const std::uint8_t* end = net::wire::encode(bytes, ps);
+    TEST_TRUE(end == bytes + 21);
+    TEST_EQUAL(0xEE, static_cast<int>(bytes[21]), "Encoder must write exactly the wire size");
+
+    // Little-endian id first, no padding, alive in the last byte
+    TEST_EQUAL(0x01, static_cast<int>(bytes[0]), "playerId low byte first");
+    TEST_EQUAL(0x04, static_cast<int>(bytes[3]), "playerId high byte last");
+    TEST_EQUAL(0x3F, static_cast<int>(bytes[7]), "1.5f is 0x3FC00000 little-endian");
+    TEST_EQUAL(0xC0, static_cast<int>(bytes[19]), "-2.0f is 0xC0000000 little-endian");
+    TEST_EQUAL(1, static_cast<int>(bytes[20]), "alive should be the final byte");
+
+    net::PlayerState back{};
+    back.alive = 0;
+    net::wire::decode(bytes, back);
+    TEST_EQUAL(ps.playerId, back.playerId, "playerId should round-trip");
+    TEST_TRUE(back.x == 1.5f && back.y == 0.f && back.vx == 0.f && back.vy == -2.f && back.alive == 1);
+    return true;
+}
+
+bool testWireFormatMessagesRoundTrip(std::string& errorMsg) {
+    net::InputCommand cmd;
+    cmd.playerId = 7;
+    cmd.dirX = 0.25f;
+    cmd.dirY = -1.f;
+    cmd.sequence = 99;
+    cmd.timestampMs = 123456;
+    const auto packet = net::serializeInput(cmd);
+    TEST_EQUAL(net::messageSize<net::InputCommand>(), packet.size(), "Input should be header plus 20 bytes");
+    net::MessageType type;
+    TEST_TRUE(net::parseHeader(packet.data(), packet.size(), type));
+    TEST_TRUE(type == net::MessageType::Input);
+    net::InputCommand decoded{};
+    TEST_TRUE(net::readMessage(packet.data(), packet.size(), decoded));
+    TEST_EQUAL(99u, decoded.sequence, "sequence should round-trip");
+    TEST_TRUE(decoded.dirX == 0.25f && decoded.dirY == -1.f && decoded.timestampMs == 123456u);
+    TEST_FALSE(net::readMessage(packet.data(), packet.size() - 1, decoded));
+
+    net::StateHash hash;
+    hash.tick = 30;
+    hash.hash = 0x0123456789ABCDEFull;
+    std::uint8_t buf[net::messageSize<net::StateHash>()];
+    net::writeMessage(buf, net::MessageType::StateHash, hash);
+    net::StateHash hashBack{};
+    TEST_TRUE(net::readMessage(buf, sizeof(buf), hashBack));
+    TEST_TRUE(hashBack.tick == 30 && hashBack.hash == hash.hash);
+    return true;
+}
+
+bool testWireFormatRejectsOversizedCounts(std::string& errorMsg) {
+    net::StateSnapshot snap;
+    snap.tick = 5;
+    snap.players.resize(3);
+    snap.players[2].playerId = 42;
+    auto packet = net::serializeState(snap);
+    TEST_EQUAL(net::STATE_HEADER_SIZE + 3 * 21, packet.size(), "Players are 21 bytes each on the wire");
+
+    net::StateSnapshot decoded;
+    TEST_TRUE(net::deserializeState(packet.data(), packet.size(), decoded));
+    TEST_EQUAL(42u, decoded.players[2].playerId, "Last player should round-trip");
+    TEST_FALSE(net::deserializeState(packet.data(), packet.size() - 1, decoded));
+
+    // A count the packet cannot hold is rejected before anything is allocated
+    const std::uint8_t huge[4] = {0xFF, 0xFF, 0xFF, 0x7F};
+    std::copy(huge, huge + 4, packet.begin() + net::STATE_HEADER_SIZE - 4);
+    decoded.players.clear();
+    TEST_FALSE(net::deserializeState(packet.data(), packet.size(), decoded));
+    TEST_TRUE(decoded.players.empty());
+    return true;
+}
+
+// Auto-register tests
+namespace {
+    struct WireFormatTestsRegistration {
+        WireFormatTestsRegistration() {
+            test::TestSuite::instance().registerTest("WireFormat::PlayerStateBytes", testWireFormatPlayerStateBytes);
+            test::TestSuite::instance().registerTest("WireFormat::MessagesRoundTrip", testWireFormatMessagesRoundTrip);
+            test::TestSuite::instance().registerTest("WireFormat::RejectsOversizedCounts", testWireFormatRejectsOversizedCounts);
+        }
+    } wireFormatTests;
+}